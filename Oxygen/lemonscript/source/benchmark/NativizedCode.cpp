@@ -0,0 +1,26 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "lemon/program/Program.h"
+#include "lemon/runtime/provider/NativizedOpcodeProvider.h"
+#include "lemon/runtime/OpcodeExecUtils.h"
+#include "lemon/runtime/RuntimeOpcodeContext.h"
+
+
+namespace lemon
+{
+	// The nativized code gets generated during the build, see "CMakeLists.txt"
+	//  -> It's missing in the first build of the benchmark, which is only used to generate it
+#if __has_include("NativizedCode.inc")
+	#include "NativizedCode.inc"
+#endif
+
+#ifndef NATIVIZED_CODE_AVAILABLE
+	void createNativizedCodeLookup(Nativizer::LookupDictionary& dict) {}
+#endif
+}
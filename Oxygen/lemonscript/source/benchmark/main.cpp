@@ -0,0 +1,411 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+// Micro-benchmark for the lemonscript VM
+//  -> Runs every "bench_*" kernel of the script corpus under the default opcode provider, the optimized opcode provider and nativized code
+//  -> The latter two also run in the runtime's fast calls mode, which handles script calls and returns without going through the execute connector
+//  -> Checks that all providers produce the same kernel results, and outputs the timings as JSON on stdout, along with the nativized code coverage
+//  -> Usage (from the "Oxygen/lemonscript" directory): lemonscript_bench [--script <path>] [--time <seconds>] [--filter <text>] [--nativize <output path>]
+//  -> With "--nativize", the nativized code for the corpus gets generated into the given file instead; the CMake build does this using a first build
+//     of the benchmark without nativized code, so that the nativized code always matches the current compiler output
+
+#define RMX_LIB
+
+#include "lemon/compiler/Compiler.h"
+#include "lemon/program/GlobalsLookup.h"
+#include "lemon/program/Module.h"
+#include "lemon/program/Program.h"
+#include "lemon/runtime/Runtime.h"
+#include "lemon/runtime/StandardLibrary.h"
+#include "lemon/runtime/provider/NativizedOpcodeProvider.h"
+
+#include <chrono>
+#include <set>
+
+namespace lemon
+{
+	// Forward declaration of the nativized code lookup builder function
+	extern void createNativizedCodeLookup(Nativizer::LookupDictionary& dict);
+}
+
+using namespace lemon;
+
+
+namespace
+{
+	// Address where each kernel writes its result, see "script/benchmark/benchmark.lemon"
+	static const uint64 RAM_START_ADDRESS = 0xffff0000;
+	static const uint64 RESULT_ADDRESS = 0xffff0000;
+
+	struct ProviderInfo
+	{
+		const char* mName;
+		int mOptimizationLevel;
+		bool mUseNativizedCode;
+		bool mUseFastCalls;
+	};
+
+	static const ProviderInfo PROVIDERS[] =
+	{
+		{ "default",              0, false, false },
+		{ "optimized",            1, false, false },
+		{ "optimized_fast_calls", 1, false, true },
+		{ "nativized",            3, true,  false },
+		{ "nativized_fast_calls", 3, true,  true }
+	};
+
+	struct ProviderResult
+	{
+		const ProviderInfo* mProvider = nullptr;
+		uint32 mKernelResult = 0;
+		size_t mCalls = 0;
+		uint64 mSteps = 0;
+		double mSeconds = 0.0;
+		double mNativizedCoverage = 0.0;	// Share of the nativizable opcodes of all executed functions that got replaced by nativized code
+	};
+
+
+	// Nativized opcode provider that keeps track of how many of the original opcodes it covers
+	//  -> Only opcodes that the nativizer supports at all are counted, control flow like jumps and calls always stays with the default provider
+	class CoverageTrackingOpcodeProvider : public NativizedOpcodeProvider
+	{
+	public:
+		inline CoverageTrackingOpcodeProvider(BuildFunction buildFunction) : NativizedOpcodeProvider(buildFunction) {}
+
+		void resetCoverage()
+		{
+			mFunctions.clear();
+			mNumNativizedOpcodes = 0;
+		}
+
+		double getCoverage() const
+		{
+			size_t numOpcodes = 0;
+			for (const ScriptFunction* function : mFunctions)
+			{
+				for (const Opcode& opcode : function->mOpcodes)
+				{
+					if (opcode.mType == Opcode::Type::MOVE_STACK || (opcode.mType >= Opcode::Type::PUSH_CONSTANT && opcode.mType <= Opcode::Type::COMPARE_GE))
+						++numOpcodes;
+				}
+			}
+			return (numOpcodes == 0) ? 0.0 : (double)mNumNativizedOpcodes / (double)numOpcodes;
+		}
+
+		bool buildRuntimeOpcode(RuntimeOpcodeBuffer& buffer, const Opcode* opcodes, int numOpcodesAvailable, int firstOpcodeIndex, int& outNumOpcodesConsumed, const Runtime& runtime, const ScriptFunction& function) override
+		{
+			mFunctions.insert(&function);
+			if (!NativizedOpcodeProvider::buildRuntimeOpcode(buffer, opcodes, numOpcodesAvailable, firstOpcodeIndex, outNumOpcodesConsumed, runtime, function))
+				return false;
+
+			mNumNativizedOpcodes += outNumOpcodesConsumed;
+			return true;
+		}
+
+	private:
+		std::set<const ScriptFunction*> mFunctions;
+		size_t mNumNativizedOpcodes = 0;
+	};
+
+
+	// Flat 64 KB of RAM at the same address range as in the emulator, without byte swapping
+	//  -> Other addresses read as zero and ignore writes
+	class BenchmarkMemoryAccess : public MemoryAccessHandler
+	{
+	public:
+		void reset()
+		{
+			memset(mRam, 0, sizeof(mRam));
+		}
+
+		virtual uint8  read8 (uint64 address) override  { return read<uint8>(address); }
+		virtual uint16 read16(uint64 address) override  { return read<uint16>(address); }
+		virtual uint32 read32(uint64 address) override  { return read<uint32>(address); }
+		virtual uint64 read64(uint64 address) override  { return read<uint64>(address); }
+
+		virtual void write8 (uint64 address, uint8 value) override   { write<uint8>(address, value); }
+		virtual void write16(uint64 address, uint16 value) override  { write<uint16>(address, value); }
+		virtual void write32(uint64 address, uint32 value) override  { write<uint32>(address, value); }
+		virtual void write64(uint64 address, uint64 value) override  { write<uint64>(address, value); }
+
+		virtual void getDirectAccessSpecialization(SpecializationResult& outResult, uint64 address, size_t size, bool writeAccess) override
+		{
+			uint8* pointer = getPointer(address, size);
+			if (nullptr != pointer)
+			{
+				outResult.mResult = SpecializationResult::Result::HAS_SPECIALIZATION;
+				outResult.mDirectAccessPointer = pointer;
+				outResult.mSwapBytes = false;
+			}
+		}
+
+	private:
+		inline uint8* getPointer(uint64 address, size_t size)
+		{
+			address &= 0xffffffff;
+			if (address < RAM_START_ADDRESS || address + size > RAM_START_ADDRESS + sizeof(mRam))
+				return nullptr;
+			return &mRam[address - RAM_START_ADDRESS];
+		}
+
+		template<typename T> T read(uint64 address)
+		{
+			T value = 0;
+			const uint8* pointer = getPointer(address, sizeof(T));
+			if (nullptr != pointer)
+				memcpy(&value, pointer, sizeof(T));
+			return value;
+		}
+
+		template<typename T> void write(uint64 address, T value)
+		{
+			uint8* pointer = getPointer(address, sizeof(T));
+			if (nullptr != pointer)
+				memcpy(pointer, &value, sizeof(T));
+		}
+
+	private:
+		uint8 mRam[0x10000] = { 0 };
+	};
+
+
+	struct BenchmarkExecuteConnector : public Runtime::ExecuteConnector
+	{
+		Runtime& mRuntime;
+		bool mStopped = false;
+
+		inline BenchmarkExecuteConnector(Runtime& runtime) : mRuntime(runtime) {}
+
+		bool handleCall(const Function* func, uint64 callTarget) override
+		{
+			if (nullptr == func)
+			{
+				throw std::runtime_error("Call failed, probably due to an invalid function");
+			}
+			return true;
+		}
+
+		bool handleReturn() override
+		{
+			if (mRuntime.getMainControlFlow().getCallStack().count == 0)
+			{
+				mStopped = true;
+				return false;
+			}
+			return true;
+		}
+
+		bool handleExternalCall(uint64 address) override
+		{
+			return true;
+		}
+
+		bool handleExternalJump(uint64 address) override
+		{
+			return true;
+		}
+	};
+
+
+	uint64 runKernelOnce(Runtime& runtime, const Function& kernel, bool useFastCalls)
+	{
+		uint64 steps = 0;
+		runtime.callFunction(kernel);
+
+		BenchmarkExecuteConnector connector(runtime);
+		connector.mUseFastCalls = useFastCalls;
+		while (!connector.mStopped)
+		{
+			runtime.executeSteps(connector, 0x100000, 0);
+			steps += connector.mStepsExecuted;
+
+			if (connector.mResult == Runtime::ExecuteResult::Result::HALT)
+			{
+				connector.mStopped = true;
+			}
+		}
+		return steps;
+	}
+
+	ProviderResult runKernel(Program& program, BenchmarkMemoryAccess& memoryAccess, CoverageTrackingOpcodeProvider* nativizedProvider, const ProviderInfo& provider, const Function& kernel, double minimumSeconds)
+	{
+		ProviderResult result;
+		result.mProvider = &provider;
+
+		program.setOptimizationLevel(provider.mOptimizationLevel);
+		program.mNativizedOpcodeProvider = provider.mUseNativizedCode ? nativizedProvider : nullptr;
+		nativizedProvider->resetCoverage();
+
+		// Use a new runtime each time, so that all runtime functions get built for this provider
+		Runtime runtime;
+		runtime.setProgram(program);
+		runtime.setMemoryAccessHandler(&memoryAccess);
+
+		// First run from a clean memory state is used for result comparison, and doubles as warm-up
+		memoryAccess.reset();
+		runKernelOnce(runtime, kernel, provider.mUseFastCalls);
+		result.mKernelResult = memoryAccess.read32(RESULT_ADDRESS);
+
+		const auto startTime = std::chrono::steady_clock::now();
+		do
+		{
+			result.mSteps += runKernelOnce(runtime, kernel, provider.mUseFastCalls);
+			++result.mCalls;
+			result.mSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		}
+		while (result.mSeconds < minimumSeconds || result.mCalls < 10);
+
+		RMX_CHECK(runtime.getMainControlFlow().getValueStackSize() == 0, "Runtime value stack must be empty after kernel '" << kernel.getName() << "'", );
+		if (provider.mUseNativizedCode)
+			result.mNativizedCoverage = nativizedProvider->getCoverage();
+		return result;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	INIT_RMX;
+
+	std::wstring scriptFilename = L"script/benchmark/benchmark.lemon";
+	std::string filter;
+	double minimumSeconds = 0.25;
+	std::wstring nativizeFilename;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--nativize" && i + 1 < argc)
+		{
+			nativizeFilename = String(argv[++i]).toStdWString();
+		}
+		else if (arg == "--script" && i + 1 < argc)
+		{
+			scriptFilename = String(argv[++i]).toStdWString();
+		}
+		else if (arg == "--time" && i + 1 < argc)
+		{
+			minimumSeconds = std::max(atof(argv[++i]), 0.0);
+		}
+		else if (arg == "--filter" && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "Usage: lemonscript_bench [--script <path>] [--time <seconds>] [--filter <text>] [--nativize <output path>]\n");
+			return 1;
+		}
+	}
+
+	Module module("benchmark_module");
+	GlobalsLookup globalsLookup;
+	module.startCompiling(globalsLookup);
+
+	StandardLibrary::registerBindings(module);
+	globalsLookup.addDefinitionsFromModule(module);
+
+	{
+		Compiler compiler(module, globalsLookup, lemon::CompileOptions());
+		if (!compiler.loadScript(scriptFilename))
+		{
+			for (const Compiler::ErrorMessage& error : compiler.getErrors())
+			{
+				fprintf(stderr, "Compile error in line %d: %s\n", (int)error.mError.mLineNumber, error.mMessage.c_str());
+			}
+			return 1;
+		}
+	}
+
+	BenchmarkMemoryAccess memoryAccess;
+	Program program;
+	program.addModule(module);
+
+	if (!nativizeFilename.empty())
+	{
+		program.runNativization(module, nativizeFilename, memoryAccess);
+		return 0;
+	}
+
+	static CoverageTrackingOpcodeProvider nativizedProvider(&createNativizedCodeLookup);
+	if (!nativizedProvider.isValid())
+	{
+		fprintf(stderr, "No nativized code available, this build of the benchmark can only be used for generating it\n");
+	}
+
+	// Collect kernels
+	std::vector<const ScriptFunction*> kernels;
+	for (const ScriptFunction* function : module.getScriptFunctions())
+	{
+		const std::string_view name = function->getName().getString();
+		if (name.rfind("bench_", 0) != 0 || function->getSignatureHash() != Function::getVoidSignatureHash())
+			continue;
+		if (!filter.empty() && name.find(filter) == std::string_view::npos)
+			continue;
+		kernels.push_back(function);
+	}
+	std::sort(kernels.begin(), kernels.end(), [](const ScriptFunction* a, const ScriptFunction* b) { return a->getName().getString() < b->getName().getString(); });
+
+	bool anyMismatch = false;
+	printf("{\n\t\"kernels\": [");
+	for (size_t kernelIndex = 0; kernelIndex < kernels.size(); ++kernelIndex)
+	{
+		const ScriptFunction& kernel = *kernels[kernelIndex];
+		std::vector<ProviderResult> results;
+		try
+		{
+			for (const ProviderInfo& provider : PROVIDERS)
+			{
+				if (provider.mUseNativizedCode && !nativizedProvider.isValid())
+					continue;
+				results.push_back(runKernel(program, memoryAccess, &nativizedProvider, provider, kernel, minimumSeconds));
+			}
+		}
+		catch (const std::exception& e)
+		{
+			fprintf(stderr, "Error during execution of kernel '%s': %s\n", std::string(kernel.getName().getString()).c_str(), e.what());
+			return 1;
+		}
+
+		// The default provider executes exactly one step per original opcode, so its step count is the common base for "ns_per_opcode"
+		const double opcodesPerCall = (double)results[0].mSteps / (double)results[0].mCalls;
+
+		printf("%s\n\t\t{\n\t\t\t\"name\": \"%s\",\n\t\t\t\"opcodes_per_call\": %.0f,\n\t\t\t\"providers\": [", (kernelIndex == 0) ? "" : ",", std::string(kernel.getName().getString()).c_str(), opcodesPerCall);
+		for (size_t resultIndex = 0; resultIndex < results.size(); ++resultIndex)
+		{
+			const ProviderResult& result = results[resultIndex];
+			const bool matches = (result.mKernelResult == results[0].mKernelResult);
+			if (!matches)
+			{
+				fprintf(stderr, "Error: Result of kernel '%s' with provider '%s' differs from the default provider (0x%08x instead of 0x%08x)\n", std::string(kernel.getName().getString()).c_str(), result.mProvider->mName, result.mKernelResult, results[0].mKernelResult);
+				anyMismatch = true;
+			}
+
+			char coverageString[64] = "";
+			if (result.mProvider->mUseNativizedCode)
+			{
+				snprintf(coverageString, sizeof(coverageString), ", \"nativized_coverage\": %.3f", result.mNativizedCoverage);
+				if (result.mNativizedCoverage <= 0.0)
+				{
+					// Not even a partial coverage is a sign that the nativized code does not match the scripts
+					fprintf(stderr, "Warning: Nativized code does not cover any opcodes of kernel '%s', it's probably outdated\n", std::string(kernel.getName().getString()).c_str());
+				}
+			}
+
+			const double stepsPerSecond = (result.mSeconds > 0.0) ? (double)result.mSteps / result.mSeconds : 0.0;
+			const double nsPerOpcode = result.mSeconds * 1.0e9 / ((double)result.mCalls * opcodesPerCall);
+			printf("%s\n\t\t\t\t{ \"provider\": \"%s\", \"calls\": %d, \"steps\": %llu, \"seconds\": %.6f, \"steps_per_sec\": %.0f, \"ns_per_opcode\": %.3f, \"speedup\": %.2f, \"result_matches\": %s%s }",
+				   (resultIndex == 0) ? "" : ",", result.mProvider->mName, (int)result.mCalls, (unsigned long long)result.mSteps, result.mSeconds, stepsPerSecond, nsPerOpcode,
+				   (result.mSeconds > 0.0) ? (results[0].mSeconds / (double)results[0].mCalls) / (result.mSeconds / (double)result.mCalls) : 0.0, matches ? "true" : "false", coverageString);
+		}
+		printf("\n\t\t\t]\n\t\t}");
+		fflush(stdout);
+	}
+	printf("\n\t]\n}\n");
+
+	return anyMismatch ? 2 : 0;
+}
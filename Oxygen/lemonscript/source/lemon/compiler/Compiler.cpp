@@ -14,11 +14,26 @@
 #include "lemon/program/Module.h"
 #include "lemon/translator/Translator.h"
 
+#if !defined(PLATFORM_WEB)
+	#include <atomic>
+	#include <thread>
+#endif
+
 
 namespace lemon
 {
 	namespace
 	{
+		struct PendingWarning
+		{
+			CompilerWarning::Code mCode;
+			std::string mMessage;
+			uint32 mLineNumber = 0;
+		};
+
+		// Warnings get redirected here while compiling in the backend, see "Compiler::runCompilerBackend"
+		thread_local std::vector<PendingWarning>* gPendingWarnings = nullptr;
+
 		int checkIncludeLine(std::string_view str)
 		{
 			// Check for "include", but ignore leading whitespace
@@ -102,6 +117,15 @@ namespace lemon
 
 	void Compiler::addWarning(CompilerWarning::Code warningCode, std::string_view warningMessage, uint32 lineNumber)
 	{
+		if (nullptr != gPendingWarnings)
+		{
+			PendingWarning& pendingWarning = vectorAdd(*gPendingWarnings);
+			pendingWarning.mCode = warningCode;
+			pendingWarning.mMessage = warningMessage;
+			pendingWarning.mLineNumber = lineNumber;
+			return;
+		}
+
 		const uint64 messageHash = rmx::getMurmur2_64(warningMessage);
 
 		// Search for that same warning message
@@ -317,11 +341,94 @@ namespace lemon
 	void Compiler::runCompilerBackend(std::vector<FunctionNode*>& functionNodes)
 	{
 		// Backend part: Compile function contents into opcodes
-		for (FunctionNode* node : functionNodes)
+		//  -> Functions are independent of each other at this point, so this can be spread over multiple threads
+		//  -> Warnings and exceptions are collected per function and evaluated afterwards in function order, so the outcome is the same as for a sequential build
+		struct FunctionResult
+		{
+			std::vector<PendingWarning> mWarnings;
+			std::exception_ptr mException;
+		};
+		const size_t numFunctions = functionNodes.size();
+		std::vector<FunctionResult> results(numFunctions);
+
+		const auto compileFunction = [&](size_t index)
+		{
+			FunctionResult& result = results[index];
+			gPendingWarnings = &result.mWarnings;
+			try
+			{
+				FunctionNode& node = *functionNodes[index];
+				FunctionCompiler functionCompiler(*node.mFunction, mCompileOptions, mGlobalsLookup);
+				functionCompiler.processParameters();
+				functionCompiler.buildOpcodesForFunction(*node.mContent);
+			}
+			catch (...)
+			{
+				result.mException = std::current_exception();
+			}
+			gPendingWarnings = nullptr;
+		};
+
+		size_t numThreads = 1;
+	#if !defined(PLATFORM_WEB)
+		const size_t MIN_FUNCTIONS_PER_THREAD = 32;
+		numThreads = (mCompileOptions.mBackendThreads > 0) ? (size_t)mCompileOptions.mBackendThreads : (size_t)std::thread::hardware_concurrency();
+		numThreads = std::clamp<size_t>(std::min(numThreads, numFunctions / MIN_FUNCTIONS_PER_THREAD), 1, 64);
+	#endif
+
+		if (numThreads <= 1)
 		{
-			FunctionCompiler functionCompiler(*node->mFunction, mCompileOptions, mGlobalsLookup);
-			functionCompiler.processParameters();
-			functionCompiler.buildOpcodesForFunction(*node->mContent);
+			for (size_t index = 0; index < numFunctions; ++index)
+			{
+				compileFunction(index);
+				if (results[index].mException)
+					break;
+			}
+		}
+	#if !defined(PLATFORM_WEB)
+		else
+		{
+			// Workers pick functions in order, so that an early error does not have to wait for all later functions
+			std::atomic<size_t> nextIndex = 0;
+			std::atomic<size_t> firstFailedIndex = numFunctions;
+			const auto workerFunction = [&]()
+			{
+				while (true)
+				{
+					const size_t index = nextIndex.fetch_add(1);
+					if (index >= firstFailedIndex.load())
+						break;
+
+					compileFunction(index);
+					if (results[index].mException)
+					{
+						size_t expected = firstFailedIndex.load();
+						while (index < expected && !firstFailedIndex.compare_exchange_weak(expected, index));
+					}
+				}
+			};
+
+			std::vector<std::thread> threads;
+			threads.reserve(numThreads - 1);
+			for (size_t k = 1; k < numThreads; ++k)
+				threads.emplace_back(workerFunction);
+			workerFunction();
+			for (std::thread& thread : threads)
+				thread.join();
+		}
+	#endif
+
+		// Merge results in function order
+		for (FunctionResult& result : results)
+		{
+			for (const PendingWarning& pendingWarning : result.mWarnings)
+			{
+				addWarning(pendingWarning.mCode, pendingWarning.mMessage, pendingWarning.mLineNumber);
+			}
+			if (result.mException)
+			{
+				std::rethrow_exception(result.mException);
+			}
 		}
 
 	#if 0
@@ -24,6 +24,7 @@ namespace lemon
 		std::wstring mOutputNativizedSource;
 		std::wstring mOutputTranslatedSource;
 		bool mConsumeProcessedPragmas = true;
+		uint32 mBackendThreads = 0;		// Number of threads for the compiler backend, 0 to use all available hardware threads
 
 		// Set during compilation
 		static const uint32 MAX_SCRIPT_FEATURE_LEVEL = 2;
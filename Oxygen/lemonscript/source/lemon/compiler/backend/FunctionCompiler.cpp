@@ -1189,68 +1189,13 @@ namespace lemon
 
 	void FunctionCompiler::assignOpcodeFlags()
 	{
-		const size_t numOpcodes = mOpcodes.size();
-
-		// Add flags by opcodes
-		uint32 lastLineNumber = 0xffffffff;
-		for (size_t i = 0; i < numOpcodes; ++i)
-		{
-			Opcode& opcode = mOpcodes[i];
-			switch (opcode.mType)
-			{
-				case Opcode::Type::JUMP:
-				case Opcode::Type::JUMP_CONDITIONAL:
-					opcode.mFlags.set(Opcode::Flag::CTRLFLOW);
-					opcode.mFlags.set(Opcode::Flag::JUMP);
-					break;
-
-				case Opcode::Type::CALL:
-				case Opcode::Type::RETURN:
-				case Opcode::Type::EXTERNAL_CALL:
-				case Opcode::Type::EXTERNAL_JUMP:
-					opcode.mFlags.set(Opcode::Flag::CTRLFLOW);
-					break;
-
-				default:
-					break;
-			}
-
-			if (lastLineNumber != opcode.mLineNumber)
-			{
-				opcode.mFlags.set(Opcode::Flag::NEW_LINE);
-				lastLineNumber = opcode.mLineNumber;
-			}
-		}
-
-		// Add label targets
+		static thread_local std::vector<size_t> labelOffsets;
+		labelOffsets.clear();
 		for (const ScriptFunction::Label& label : mFunction.mLabels)
 		{
-			mOpcodes[label.mOffset].mFlags.set(Opcode::Flag::LABEL);
-		}
-
-		// Add jump targets
-		for (size_t i = 0; i < numOpcodes; ++i)
-		{
-			const Opcode& opcode = mOpcodes[i];
-			if (opcode.mFlags.isSet(Opcode::Flag::JUMP))
-			{
-				const size_t jumpTarget = std::min((size_t)mOpcodes[i].mParameter, mOpcodes.size() - 1);
-				mOpcodes[jumpTarget].mFlags.set(Opcode::Flag::JUMP_TARGET);
-			}
-		}
-
-		// Add sequence break flags
-		for (size_t i = 0; i < numOpcodes; ++i)
-		{
-			if (mOpcodes[i].mFlags.isSet(Opcode::Flag::CTRLFLOW))
-			{
-				mOpcodes[i].mFlags.set(Opcode::Flag::SEQ_BREAK);
-			}
-			else if (i+1 < numOpcodes && mOpcodes[i+1].mFlags.anySet(makeBitFlagSet(Opcode::Flag::LABEL, Opcode::Flag::JUMP_TARGET, Opcode::Flag::NEW_LINE, Opcode::Flag::CTRLFLOW)))
-			{
-				mOpcodes[i].mFlags.set(Opcode::Flag::SEQ_BREAK);
-			}
+			labelOffsets.push_back((size_t)label.mOffset);
 		}
+		OpcodeOptimization::assignOpcodeFlags(mOpcodes, labelOffsets);
 	}
 
 }
@@ -8,12 +8,561 @@
 
 #include "lemon/pch.h"
 #include "lemon/compiler/backend/OpcodeOptimization.h"
+#include "lemon/program/function/NativeFunction.h"
 #include "lemon/program/function/ScriptFunction.h"
 #include "lemon/program/Opcode.h"
+#include "lemon/program/Program.h"
+#include "lemon/runtime/OpcodeExecUtils.h"
 
 
 namespace lemon
 {
+	namespace
+	{
+		static const size_t MAX_INLINED_FUNCTION_OPCODES = 32;	// Only script functions up to this number of opcodes get inlined
+		static const size_t MAX_INLINED_OPCODES_TOTAL = 256;	// Limit for the growth of a single function by inlining
+
+		bool foldIntegerCast(int64& value, BaseCastType castType, bool asAtRuntime)
+		{
+			// TODO: Support conversions between integer, float, double constants
+			//  -> Unless this is done in the compiler frontend already, which actually makes more sense...
+			if (!BaseTypeHelper::isPureIntegerBaseCast(castType))
+				return false;
+
+			// Constants from the source code just get converted to the target type, as their value does not necessarily fit the cast's original type
+			//  -> Values that are known only due to constant propagation must be cast exactly like the runtime does it instead:
+			//     Only the bits of the smaller of the two types count, extended with zeroes or (for signed casts up) the highest bit
+			const uint8 originalSize = ((uint8)castType >> 2) & 0x03;
+			const uint8 targetSize = (uint8)castType & 0x03;
+			switch ((asAtRuntime ? std::min(originalSize, targetSize) : targetSize) + ((uint8)castType & 0x10))
+			{
+				case 0x00:  value =  (uint8)value;  break;
+				case 0x01:  value = (uint16)value;  break;
+				case 0x02:  value = (uint32)value;  break;
+				case 0x10:  value =   (int8)value;  break;
+				case 0x11:  value =  (int16)value;  break;
+				case 0x12:  value =  (int32)value;  break;
+			}
+			return true;
+		}
+
+		template<typename T>
+		bool foldOperation(Opcode::Type type, int64 a, int64 b, int64& outResult)
+		{
+			// This needs to produce exactly the same results as the respective runtime opcode execution
+			//  -> Note that wrap-around of signed values is done via uint64 here, to avoid undefined behavior
+			const T x = (T)a;
+			const T y = (T)b;
+			switch (type)
+			{
+				case Opcode::Type::ARITHM_ADD:	  outResult = (int64)(T)((uint64)x + (uint64)y);  return true;
+				case Opcode::Type::ARITHM_SUB:	  outResult = (int64)(T)((uint64)x - (uint64)y);  return true;
+				case Opcode::Type::ARITHM_MUL:	  outResult = (int64)(T)((uint64)x * (uint64)y);  return true;
+				case Opcode::Type::ARITHM_AND:	  outResult = (int64)(T)(x & y);  return true;
+				case Opcode::Type::ARITHM_OR:	  outResult = (int64)(T)(x | y);  return true;
+				case Opcode::Type::ARITHM_XOR:	  outResult = (int64)(T)(x ^ y);  return true;
+				case Opcode::Type::ARITHM_SHL:	  outResult = (int64)(T)((uint64)x << (y & (sizeof(T) * 8 - 1)));  return true;
+				case Opcode::Type::ARITHM_SHR:	  outResult = (int64)(T)(x >> (y & (sizeof(T) * 8 - 1)));  return true;
+				case Opcode::Type::COMPARE_EQ:	  outResult = (x == y) ? 1 : 0;  return true;
+				case Opcode::Type::COMPARE_NEQ:	  outResult = (x != y) ? 1 : 0;  return true;
+				case Opcode::Type::COMPARE_LT:	  outResult = (x <  y) ? 1 : 0;  return true;
+				case Opcode::Type::COMPARE_LE:	  outResult = (x <= y) ? 1 : 0;  return true;
+				case Opcode::Type::COMPARE_GT:	  outResult = (x >  y) ? 1 : 0;  return true;
+				case Opcode::Type::COMPARE_GE:	  outResult = (x >= y) ? 1 : 0;  return true;
+				case Opcode::Type::ARITHM_NEG:	  outResult = (int64)(T)(0 - (uint64)x);  return true;
+				case Opcode::Type::ARITHM_NOT:	  outResult = (x == 0) ? 1 : 0;  return true;
+				case Opcode::Type::ARITHM_BITNOT: outResult = (int64)(T)~x;  return true;
+
+				case Opcode::Type::ARITHM_DIV:
+				case Opcode::Type::ARITHM_MOD:
+				{
+					// Leave the one overflowing case to the runtime
+					if (std::is_signed_v<T> && x == std::numeric_limits<T>::min() && y == (T)-1)
+						return false;
+					outResult = (int64)((type == Opcode::Type::ARITHM_DIV) ? OpcodeExecUtils::safeDivide(x, y) : OpcodeExecUtils::safeModulo(x, y));
+					return true;
+				}
+
+				default:
+					return false;
+			}
+		}
+
+		bool foldOperation(Opcode::Type type, BaseType dataType, int64 a, int64 b, int64& outResult)
+		{
+			// Negation is always executed as signed
+			if (type == Opcode::Type::ARITHM_NEG)
+			{
+				dataType = (dataType == BaseType::INT_CONST) ? BaseType::INT_64 : BaseTypeHelper::makeIntegerSigned(dataType);
+			}
+
+			switch (dataType)
+			{
+				case BaseType::INT_8:		return foldOperation<int8>(type, a, b, outResult);
+				case BaseType::INT_16:		return foldOperation<int16>(type, a, b, outResult);
+				case BaseType::INT_32:		return foldOperation<int32>(type, a, b, outResult);
+				case BaseType::INT_64:		return foldOperation<int64>(type, a, b, outResult);
+				case BaseType::UINT_8:		return foldOperation<uint8>(type, a, b, outResult);
+				case BaseType::UINT_16:		return foldOperation<uint16>(type, a, b, outResult);
+				case BaseType::UINT_32:		return foldOperation<uint32>(type, a, b, outResult);
+				case BaseType::UINT_64:		return foldOperation<uint64>(type, a, b, outResult);
+				case BaseType::INT_CONST:	return foldOperation<uint64>(type, a, b, outResult);
+				default:					return false;	// No folding of floating point operations
+			}
+		}
+
+		inline bool isLocalVariableAccess(const Opcode& opcode)
+		{
+			return (opcode.mType == Opcode::Type::GET_VARIABLE_VALUE || opcode.mType == Opcode::Type::SET_VARIABLE_VALUE) && ((Variable::Type)((uint32)opcode.mParameter >> 28) == Variable::Type::LOCAL);
+		}
+
+		inline bool isJumpOpcode(const Opcode& opcode)
+		{
+			return (opcode.mType == Opcode::Type::JUMP || opcode.mType == Opcode::Type::JUMP_CONDITIONAL || opcode.mType == Opcode::Type::JUMP_SWITCH);
+		}
+
+		const ScriptFunction* getInlineableFunction(const ScriptFunction& caller, const Program& program, const Opcode& callOpcode)
+		{
+			// Base calls can't be resolved here, as they depend on the caller's base call index at runtime
+			if ((uint32)callOpcode.mDataType != 0)
+				return nullptr;
+
+			// Use the very same function that the runtime would call, considering overrides by mods
+			const Function* function = program.getFunctionBySignature((uint64)callOpcode.mParameter);
+			if (nullptr == function || !function->isA<ScriptFunction>() || function == &caller)
+				return nullptr;
+
+			// Functions that can be entered from outside (via labels or address hooks) stay real calls
+			const ScriptFunction& callee = function->as<ScriptFunction>();
+			const std::vector<Opcode>& opcodes = callee.mOpcodes;
+			if (opcodes.empty() || opcodes.size() > MAX_INLINED_FUNCTION_OPCODES || opcodes.back().mType != Opcode::Type::RETURN)
+				return nullptr;
+			if (!callee.mLabels.empty() || !callee.mAddressHooks.empty())
+				return nullptr;
+
+			// Local variables get mapped to 8-byte slots
+			for (const LocalVariable* variable : callee.mLocalVariablesByID)
+			{
+				if (variable->getLocalMemorySize() != 8)
+					return nullptr;
+			}
+			if (!callee.mLocalVariablesByID.empty())
+			{
+				if (opcodes[0].mType != Opcode::Type::MOVE_VAR_STACK || (size_t)opcodes[0].mParameter * 8 != callee.mLocalVariablesMemorySize)
+					return nullptr;
+			}
+
+			for (size_t i = 0; i < opcodes.size(); ++i)
+			{
+				const Opcode& opcode = opcodes[i];
+				switch (opcode.mType)
+				{
+					case Opcode::Type::MOVE_VAR_STACK:
+					{
+						// Only the scope setup at the start is supported
+						if (i != 0)
+							return nullptr;
+						break;
+					}
+
+					case Opcode::Type::CALL:
+					{
+						// Only calls to native functions that don't care about the call stack are fine, everything else (including recursion) is ruled out
+						if ((uint32)opcode.mDataType != 0)
+							return nullptr;
+						const Function* calledFunction = program.getFunctionBySignature((uint64)opcode.mParameter);
+						if (nullptr == calledFunction || !calledFunction->isA<NativeFunction>() || !calledFunction->hasFlag(Function::Flag::COMPILE_TIME_CONSTANT))
+							return nullptr;
+						break;
+					}
+
+					case Opcode::Type::RETURN:
+					{
+						// Early returns would become jumps
+						if (i + 1 < opcodes.size())
+							return nullptr;
+						break;
+					}
+
+					case Opcode::Type::JUMP:
+					case Opcode::Type::JUMP_CONDITIONAL:
+					case Opcode::Type::JUMP_SWITCH:
+						// The runtime may stop execution at any jump when reaching its steps limit, and the program counter
+						// inside inlined code could not be translated back for serialization, so inlined code must have no jumps
+						return nullptr;
+
+					case Opcode::Type::EXTERNAL_CALL:
+					case Opcode::Type::EXTERNAL_JUMP:
+						return nullptr;
+
+					default:
+						break;
+				}
+			}
+			return &callee;
+		}
+
+		void inlineFunctionCall(const ScriptFunction& caller, const ScriptFunction& callee, uint32 lineNumber, std::vector<Opcode>& outOpcodes)
+		{
+			// Opcodes get copied one by one, there are no jumps that would need to be adjusted
+			//  -> The scope setup at the start stays as it is, the final return gets replaced by the scope cleanup
+			const size_t numOpcodes = callee.mOpcodes.size();
+			for (size_t i = 0; i < numOpcodes; ++i)
+			{
+				Opcode& opcode = vectorAdd(outOpcodes);
+				opcode = callee.mOpcodes[i];
+				opcode.mFlags.clearAll();
+				opcode.mLineNumber = lineNumber;	// Line numbers refer to the caller's source
+
+				if (isLocalVariableAccess(opcode))
+				{
+					const LocalVariable& variable = callee.getLocalVariableByID((uint32)opcode.mParameter);
+					opcode.mParameter = caller.getInlinedLocalVariableID(variable.getLocalMemoryOffset() / 8);
+				}
+				else if (opcode.mType == Opcode::Type::RETURN)
+				{
+					// This is the final return, the return value (if any) is already on the value stack
+					opcode.mDataType = BaseType::VOID;
+					if (callee.mLocalVariablesMemorySize > 0)
+					{
+						opcode.mType = Opcode::Type::MOVE_VAR_STACK;
+						opcode.mParameter = -(int64)(callee.mLocalVariablesMemorySize / 8);
+					}
+					else
+					{
+						opcode.mType = Opcode::Type::NOP;
+					}
+				}
+			}
+		}
+
+		void removeNOPs(std::vector<Opcode>& opcodes, std::vector<size_t>& indexRemap)
+		{
+			// Same as "OpcodeOptimization::cleanupNOPs", but updating the index remap instead of labels
+			static thread_local std::vector<size_t> newIndices;
+			newIndices.resize(opcodes.size());
+			size_t newSize = 0;
+			for (size_t i = 0; i < opcodes.size(); ++i)
+			{
+				newIndices[i] = newSize;
+				if (opcodes[i].mType != Opcode::Type::NOP)
+				{
+					if (newSize != i)
+						opcodes[newSize] = opcodes[i];
+					++newSize;
+				}
+			}
+			if (newSize == opcodes.size())
+				return;
+
+			// The last opcode is a return in any case and does not get removed
+			const size_t lastOpcode = newSize - 1;
+			opcodes.resize(newSize);
+			for (Opcode& opcode : opcodes)
+			{
+				if (isJumpOpcode(opcode))
+				{
+					opcode.mParameter = ((size_t)opcode.mParameter < newIndices.size()) ? newIndices[(size_t)opcode.mParameter] : lastOpcode;
+				}
+			}
+			for (size_t& index : indexRemap)
+			{
+				index = newIndices[index];
+			}
+		}
+
+		bool propagateConstants(const ScriptFunction& function, std::vector<Opcode>& opcodes, const std::vector<size_t>& indexRemap)
+		{
+			const size_t numOpcodes = opcodes.size();
+			bool anyChange = false;
+
+			// Known values can't be carried over to jump targets and labels
+			static thread_local std::vector<bool> isBlockStart;
+			isBlockStart.clear();
+			isBlockStart.resize(numOpcodes, false);
+			isBlockStart[0] = true;
+			for (const ScriptFunction::Label& label : function.mLabels)
+			{
+				isBlockStart[indexRemap[label.mOffset]] = true;
+			}
+			for (const Opcode& opcode : opcodes)
+			{
+				if (isJumpOpcode(opcode))
+				{
+					isBlockStart[std::min((size_t)opcode.mParameter, numOpcodes - 1)] = true;
+				}
+			}
+
+			// Find out which of the inlined local variables ever get read
+			static thread_local std::vector<bool> isInlinedVariableRead;
+			isInlinedVariableRead.clear();
+			const uint32 firstInlinedVariableID = function.getInlinedLocalVariableID(0);
+			for (const Opcode& opcode : opcodes)
+			{
+				if (opcode.mType == Opcode::Type::GET_VARIABLE_VALUE && isLocalVariableAccess(opcode) && (uint32)opcode.mParameter >= firstInlinedVariableID)
+				{
+					const size_t slotIndex = (uint32)opcode.mParameter - firstInlinedVariableID;
+					if (slotIndex >= isInlinedVariableRead.size())
+						isInlinedVariableRead.resize(slotIndex + 1, false);
+					isInlinedVariableRead[slotIndex] = true;
+				}
+			}
+
+			// Go through each block, keeping track of the known values on the value stack and in local variables
+			//  -> The tracked value stack only covers what was pushed inside the block, anything below counts as unknown
+			struct KnownValue
+			{
+				bool mKnown = false;
+				int64 mValue = 0;
+			};
+			static thread_local std::vector<KnownValue> valueStack;
+			static thread_local std::vector<std::pair<uint32, int64>> localVariables;
+			valueStack.clear();
+			localVariables.clear();
+
+			const auto popValue = [&]()
+			{
+				if (!valueStack.empty())
+					valueStack.pop_back();
+			};
+			const auto findLocalVariable = [&](uint32 variableId) -> std::pair<uint32, int64>*
+			{
+				for (std::pair<uint32, int64>& pair : localVariables)
+				{
+					if (pair.first == variableId)
+						return &pair;
+				}
+				return nullptr;
+			};
+
+			for (size_t i = 0; i < numOpcodes; ++i)
+			{
+				Opcode& opcode = opcodes[i];
+				if (isBlockStart[i])
+				{
+					valueStack.clear();
+					localVariables.clear();
+				}
+
+				switch (opcode.mType)
+				{
+					case Opcode::Type::NOP:
+						break;
+
+					case Opcode::Type::PUSH_CONSTANT:
+						valueStack.push_back({ true, opcode.mParameter });
+						break;
+
+					case Opcode::Type::GET_VARIABLE_VALUE:
+					{
+						const std::pair<uint32, int64>* knownVariable = isLocalVariableAccess(opcode) ? findLocalVariable((uint32)opcode.mParameter) : nullptr;
+						if (nullptr != knownVariable)
+						{
+							opcode.mType = Opcode::Type::PUSH_CONSTANT;
+							opcode.mParameter = knownVariable->second;
+							anyChange = true;
+						}
+						valueStack.push_back({ nullptr != knownVariable, (nullptr != knownVariable) ? knownVariable->second : 0 });
+						break;
+					}
+
+					case Opcode::Type::SET_VARIABLE_VALUE:
+					{
+						// Note that the value stays on the stack
+						if (isLocalVariableAccess(opcode))
+						{
+							const uint32 variableId = (uint32)opcode.mParameter;
+							const size_t slotIndex = variableId - firstInlinedVariableID;
+							if (variableId >= firstInlinedVariableID && (slotIndex >= isInlinedVariableRead.size() || !isInlinedVariableRead[slotIndex]))
+							{
+								// Dead store
+								opcode.mType = Opcode::Type::NOP;
+								anyChange = true;
+								break;
+							}
+
+							std::pair<uint32, int64>* knownVariable = findLocalVariable(variableId);
+							if (!valueStack.empty() && valueStack.back().mKnown)
+							{
+								if (nullptr == knownVariable)
+									knownVariable = &localVariables.emplace_back(variableId, 0);
+								knownVariable->second = valueStack.back().mValue;
+							}
+							else if (nullptr != knownVariable)
+							{
+								*knownVariable = localVariables.back();
+								localVariables.pop_back();
+							}
+						}
+						break;
+					}
+
+					case Opcode::Type::MOVE_STACK:
+					{
+						if (opcode.mParameter < 0)
+						{
+							for (int64 k = 0; k < -opcode.mParameter; ++k)
+								popValue();
+						}
+						else
+						{
+							valueStack.clear();
+						}
+						break;
+					}
+
+					case Opcode::Type::MOVE_VAR_STACK:
+					{
+						// This is either the setup or the cleanup of a scope, either way local variables may have changed
+						localVariables.clear();
+						break;
+					}
+
+					case Opcode::Type::ARITHM_ADD:
+					case Opcode::Type::ARITHM_SUB:
+					case Opcode::Type::ARITHM_MUL:
+					case Opcode::Type::ARITHM_DIV:
+					case Opcode::Type::ARITHM_MOD:
+					case Opcode::Type::ARITHM_AND:
+					case Opcode::Type::ARITHM_OR:
+					case Opcode::Type::ARITHM_XOR:
+					case Opcode::Type::ARITHM_SHL:
+					case Opcode::Type::ARITHM_SHR:
+					case Opcode::Type::COMPARE_EQ:
+					case Opcode::Type::COMPARE_NEQ:
+					case Opcode::Type::COMPARE_LT:
+					case Opcode::Type::COMPARE_LE:
+					case Opcode::Type::COMPARE_GT:
+					case Opcode::Type::COMPARE_GE:
+					{
+						// Fold if both operands are constants pushed right before
+						int64 result = 0;
+						if (i >= 2 && !isBlockStart[i] && !isBlockStart[i-1] && opcodes[i-1].mType == Opcode::Type::PUSH_CONSTANT && opcodes[i-2].mType == Opcode::Type::PUSH_CONSTANT &&
+							foldOperation(opcode.mType, opcode.mDataType, opcodes[i-2].mParameter, opcodes[i-1].mParameter, result))
+						{
+							opcodes[i-2].mType = Opcode::Type::NOP;
+							opcodes[i-1].mType = Opcode::Type::NOP;
+							if (opcode.mType >= Opcode::Type::COMPARE_EQ)
+								opcode.mDataType = BaseType::BOOL;
+							opcode.mType = Opcode::Type::PUSH_CONSTANT;
+							opcode.mParameter = result;
+							anyChange = true;
+							popValue();
+							popValue();
+							valueStack.push_back({ true, result });
+							break;
+						}
+						popValue();
+						popValue();
+						valueStack.emplace_back();
+						break;
+					}
+
+					case Opcode::Type::ARITHM_NEG:
+					case Opcode::Type::ARITHM_NOT:
+					case Opcode::Type::ARITHM_BITNOT:
+					case Opcode::Type::CAST_VALUE:
+					case Opcode::Type::MAKE_BOOL:
+					{
+						// Fold if the operand is a constant pushed right before
+						if (i >= 1 && !isBlockStart[i] && opcodes[i-1].mType == Opcode::Type::PUSH_CONSTANT)
+						{
+							int64 result = opcodes[i-1].mParameter;
+							bool success = false;
+							if (opcode.mType == Opcode::Type::CAST_VALUE)
+							{
+								success = foldIntegerCast(result, (BaseCastType)opcode.mParameter, true);
+							}
+							else if (opcode.mType == Opcode::Type::MAKE_BOOL)
+							{
+								result = (result != 0) ? 1 : 0;
+								success = true;
+							}
+							else
+							{
+								success = foldOperation(opcode.mType, opcode.mDataType, result, 0, result);
+							}
+
+							if (success)
+							{
+								// Keep the push, as it might be a jump target
+								opcodes[i-1].mParameter = result;
+								if (opcode.mType == Opcode::Type::ARITHM_NOT || opcode.mType == Opcode::Type::MAKE_BOOL)
+									opcodes[i-1].mDataType = BaseType::BOOL;
+								opcode.mType = Opcode::Type::NOP;
+								anyChange = true;
+								popValue();
+								valueStack.push_back({ true, result });
+								break;
+							}
+						}
+						popValue();
+						valueStack.emplace_back();
+						break;
+					}
+
+					case Opcode::Type::JUMP_CONDITIONAL:
+					{
+						// Resolve conditional jumps with a constant condition
+						if (i >= 1 && !isBlockStart[i] && opcodes[i-1].mType == Opcode::Type::PUSH_CONSTANT)
+						{
+							if (opcodes[i-1].mParameter != 0)
+							{
+								// Condition is met, so the jump never gets taken
+								opcode.mType = Opcode::Type::NOP;
+							}
+							else
+							{
+								opcode.mType = Opcode::Type::JUMP;
+							}
+							opcodes[i-1].mType = Opcode::Type::NOP;
+							anyChange = true;
+						}
+						valueStack.clear();
+						localVariables.clear();
+						break;
+					}
+
+					case Opcode::Type::JUMP:
+					case Opcode::Type::JUMP_SWITCH:
+					case Opcode::Type::CALL:
+					case Opcode::Type::RETURN:
+					case Opcode::Type::EXTERNAL_CALL:
+					case Opcode::Type::EXTERNAL_JUMP:
+					{
+						valueStack.clear();
+						localVariables.clear();
+						break;
+					}
+
+					default:
+					{
+						// Value stack changes of other opcodes are not tracked
+						valueStack.clear();
+						break;
+					}
+				}
+			}
+
+			// Remove values that get pushed and then dropped right away
+			for (size_t i = 1; i < numOpcodes; ++i)
+			{
+				if (opcodes[i].mType == Opcode::Type::MOVE_STACK && opcodes[i].mParameter == -1 && !isBlockStart[i])
+				{
+					Opcode& previousOpcode = opcodes[i-1];
+					if (previousOpcode.mType == Opcode::Type::PUSH_CONSTANT || (previousOpcode.mType == Opcode::Type::GET_VARIABLE_VALUE && isLocalVariableAccess(previousOpcode)))
+					{
+						previousOpcode.mType = Opcode::Type::NOP;
+						opcodes[i].mType = Opcode::Type::NOP;
+						anyChange = true;
+					}
+				}
+			}
+			return anyChange;
+		}
+	}
+
+
 	void OpcodeOptimization::optimizeOpcodes()
 	{
 		if (mOpcodes.empty())
@@ -25,7 +574,7 @@ namespace lemon
 			anotherRun = false;
 
 			// Build up a list of jump targets
-			static std::vector<bool> isOpcodeJumpTarget;
+			static thread_local std::vector<bool> isOpcodeJumpTarget;
 			{
 				isOpcodeJumpTarget.clear();
 				isOpcodeJumpTarget.resize(mOpcodes.size(), false);
@@ -83,19 +632,8 @@ namespace lemon
 				{
 					if (opcode2.mType == Opcode::Type::CAST_VALUE)
 					{
-						// TODO: Support conversions between integer, float, double constants
-						//  -> Unless this is done in the compiler frontend already, which actually makes more sense...
-						if (BaseTypeHelper::isPureIntegerBaseCast((BaseCastType)opcode2.mParameter))
+						if (foldIntegerCast(opcode1.mParameter, (BaseCastType)opcode2.mParameter, false))
 						{
-							switch (opcode2.mParameter & 0x13)
-							{
-								case 0x00:  opcode1.mParameter =  (uint8)opcode1.mParameter;  break;
-								case 0x01:  opcode1.mParameter = (uint16)opcode1.mParameter;  break;
-								case 0x02:  opcode1.mParameter = (uint32)opcode1.mParameter;  break;
-								case 0x10:  opcode1.mParameter =   (int8)opcode1.mParameter;  break;
-								case 0x11:  opcode1.mParameter =  (int16)opcode1.mParameter;  break;
-								case 0x12:  opcode1.mParameter =  (int32)opcode1.mParameter;  break;
-							}
 							opcode2.mType = Opcode::Type::NOP;
 							anotherRun = true;
 							continue;
@@ -215,7 +753,7 @@ namespace lemon
 				mOpcodes[i].mFlags.set(Opcode::Flag::TEMP_FLAG);
 			}
 
-			static std::vector<size_t> openSeeds;
+			static thread_local std::vector<size_t> openSeeds;
 			openSeeds.clear();
 			openSeeds.push_back(0);
 			for (const ScriptFunction::Label& label : mFunction.mLabels)
@@ -308,7 +846,7 @@ namespace lemon
 	void OpcodeOptimization::cleanupNOPs()
 	{
 		// Remove all NOPs and update all jump targets etc. appropriately
-		static std::vector<int> indexRemap;
+		static thread_local std::vector<int> indexRemap;
 		indexRemap.clear();
 		indexRemap.resize(mOpcodes.size());
 		size_t newSize = 0;
@@ -354,4 +892,138 @@ namespace lemon
 			mOpcodes.resize(newSize);
 		}
 	}
+
+	bool OpcodeOptimization::optimizeForRuntime(const ScriptFunction& function, const Program& program, std::vector<Opcode>& outOpcodes, std::vector<size_t>& outIndexRemap)
+	{
+		const std::vector<Opcode>& opcodes = function.mOpcodes;
+		if (opcodes.empty())
+			return false;
+
+		outOpcodes.clear();
+		outOpcodes.reserve(opcodes.size() * 2);
+		outIndexRemap.resize(opcodes.size());
+		bool anyChange = false;
+
+		// Copy opcodes, with inlining of calls where possible
+		static thread_local std::vector<size_t> callerJumps;
+		callerJumps.clear();
+		size_t numInlinedOpcodes = 0;
+		for (size_t i = 0; i < opcodes.size(); ++i)
+		{
+			const Opcode& opcode = opcodes[i];
+			outIndexRemap[i] = outOpcodes.size();
+
+			if (opcode.mType == Opcode::Type::CALL)
+			{
+				const ScriptFunction* callee = getInlineableFunction(function, program, opcode);
+				if (nullptr != callee && numInlinedOpcodes + callee->mOpcodes.size() <= MAX_INLINED_OPCODES_TOTAL)
+				{
+					inlineFunctionCall(function, *callee, opcode.mLineNumber, outOpcodes);
+					numInlinedOpcodes += callee->mOpcodes.size();
+					anyChange = true;
+					continue;
+				}
+			}
+
+			if (isJumpOpcode(opcode))
+			{
+				callerJumps.push_back(outOpcodes.size());
+			}
+			outOpcodes.push_back(opcode);
+			outOpcodes.back().mFlags.clearAll();
+		}
+
+		// Update jump targets of the caller's own jumps
+		for (size_t position : callerJumps)
+		{
+			Opcode& opcode = outOpcodes[position];
+			opcode.mParameter = ((size_t)opcode.mParameter < outIndexRemap.size()) ? outIndexRemap[(size_t)opcode.mParameter] : (outOpcodes.size() - 1);
+		}
+
+		// Propagate and fold constants, until there's nothing left to do
+		while (propagateConstants(function, outOpcodes, outIndexRemap))
+		{
+			removeNOPs(outOpcodes, outIndexRemap);
+			anyChange = true;
+		}
+
+		if (!anyChange)
+			return false;
+
+		// Flags need to be determined anew
+		static thread_local std::vector<size_t> labelOffsets;
+		labelOffsets.clear();
+		for (const ScriptFunction::Label& label : function.mLabels)
+		{
+			labelOffsets.push_back(outIndexRemap[label.mOffset]);
+		}
+		assignOpcodeFlags(outOpcodes, labelOffsets);
+		return true;
+	}
+
+	void OpcodeOptimization::assignOpcodeFlags(std::vector<Opcode>& opcodes, const std::vector<size_t>& labelOffsets)
+	{
+		const size_t numOpcodes = opcodes.size();
+
+		// Add flags by opcodes
+		uint32 lastLineNumber = 0xffffffff;
+		for (size_t i = 0; i < numOpcodes; ++i)
+		{
+			Opcode& opcode = opcodes[i];
+			switch (opcode.mType)
+			{
+				case Opcode::Type::JUMP:
+				case Opcode::Type::JUMP_CONDITIONAL:
+					opcode.mFlags.set(Opcode::Flag::CTRLFLOW);
+					opcode.mFlags.set(Opcode::Flag::JUMP);
+					break;
+
+				case Opcode::Type::CALL:
+				case Opcode::Type::RETURN:
+				case Opcode::Type::EXTERNAL_CALL:
+				case Opcode::Type::EXTERNAL_JUMP:
+					opcode.mFlags.set(Opcode::Flag::CTRLFLOW);
+					break;
+
+				default:
+					break;
+			}
+
+			if (lastLineNumber != opcode.mLineNumber)
+			{
+				opcode.mFlags.set(Opcode::Flag::NEW_LINE);
+				lastLineNumber = opcode.mLineNumber;
+			}
+		}
+
+		// Add label targets
+		for (size_t labelOffset : labelOffsets)
+		{
+			opcodes[labelOffset].mFlags.set(Opcode::Flag::LABEL);
+		}
+
+		// Add jump targets
+		for (size_t i = 0; i < numOpcodes; ++i)
+		{
+			const Opcode& opcode = opcodes[i];
+			if (opcode.mFlags.isSet(Opcode::Flag::JUMP))
+			{
+				const size_t jumpTarget = std::min((size_t)opcodes[i].mParameter, opcodes.size() - 1);
+				opcodes[jumpTarget].mFlags.set(Opcode::Flag::JUMP_TARGET);
+			}
+		}
+
+		// Add sequence break flags
+		for (size_t i = 0; i < numOpcodes; ++i)
+		{
+			if (opcodes[i].mFlags.isSet(Opcode::Flag::CTRLFLOW))
+			{
+				opcodes[i].mFlags.set(Opcode::Flag::SEQ_BREAK);
+			}
+			else if (i+1 < numOpcodes && opcodes[i+1].mFlags.anySet(makeBitFlagSet(Opcode::Flag::LABEL, Opcode::Flag::JUMP_TARGET, Opcode::Flag::NEW_LINE, Opcode::Flag::CTRLFLOW)))
+			{
+				opcodes[i].mFlags.set(Opcode::Flag::SEQ_BREAK);
+			}
+		}
+	}
 }
@@ -14,6 +14,7 @@
 namespace lemon
 {
 	struct Opcode;
+	class Program;
 	class ScriptFunction;
 
 	class OpcodeOptimization
@@ -23,6 +24,13 @@ namespace lemon
 
 		void optimizeOpcodes();
 
+		// Optimization when building the runtime function, i.e. with the final program including all mods being known
+		//  -> Inlines calls to small script functions, then propagates and folds constants
+		//  -> Outputs a modified copy of the function's opcodes, plus the index in there for each original opcode index; returns false if there were no changes
+		static bool optimizeForRuntime(const ScriptFunction& function, const Program& program, std::vector<Opcode>& outOpcodes, std::vector<size_t>& outIndexRemap);
+
+		static void assignOpcodeFlags(std::vector<Opcode>& opcodes, const std::vector<size_t>& labelOffsets);
+
 	private:
 		void cleanupNOPs();
 
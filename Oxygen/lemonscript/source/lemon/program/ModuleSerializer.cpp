@@ -110,13 +110,14 @@ namespace lemon
 		//  - 0x14 = Label address hooks and disabled address hooks
 		//  - 0x15 = Script feature level of module
 		//  - 0x16 = Data type differentiation between arrays and custom types
+		//  - 0x17 = Added compiler warnings, so that they don't get lost when loading a cached module
 
 		static_assert((size_t)Opcode::Type::_NUM_TYPES == 37);	// Otherwise DEFAULT_OPCODE_BASETYPES needs to get updated
 
 		// Signature and version number
 		const uint32 SIGNATURE = *(uint32*)"LMD|";	// "Lemonscript Module"
 		const uint16 MINIMUM_VERSION = 0x16;
-		uint16 version = 0x16;
+		uint16 version = 0x17;
 
 		if (outerSerializer.isReading())
 		{
@@ -456,6 +457,47 @@ namespace lemon
 			}
 		}
 
+		// Serialize compiler warnings
+		if (version >= 0x17)
+		{
+			size_t numberOfWarnings = module.mWarnings.size();
+			serializer.serializeAs<uint16>(numberOfWarnings);
+
+			if (serializer.isReading())
+			{
+				module.mWarnings.resize(numberOfWarnings);
+				for (CompilerWarning& warning : module.mWarnings)
+				{
+					warning.mCode = (CompilerWarning::Code)serializer.read<uint16>();
+					serializer.serialize(warning.mMessage);
+					warning.mMessageHash = rmx::getMurmur2_64(warning.mMessage);
+
+					warning.mOccurrences.resize((size_t)serializer.read<uint16>());
+					for (CompilerWarning::Occurrence& occurrence : warning.mOccurrences)
+					{
+						const size_t index = (size_t)serializer.read<uint16>();
+						occurrence.mSourceFileInfo = (index < module.mAllSourceFiles.size()) ? module.mAllSourceFiles[index] : nullptr;
+						occurrence.mLineNumber = serializer.read<uint32>();
+					}
+				}
+			}
+			else
+			{
+				for (const CompilerWarning& warning : module.mWarnings)
+				{
+					serializer.writeAs<uint16>(warning.mCode);
+					serializer.write(warning.mMessage);
+
+					serializer.writeAs<uint16>(warning.mOccurrences.size());
+					for (const CompilerWarning::Occurrence& occurrence : warning.mOccurrences)
+					{
+						serializer.writeAs<uint16>((nullptr == occurrence.mSourceFileInfo) ? 0xffff : occurrence.mSourceFileInfo->mIndex);
+						serializer.write(occurrence.mLineNumber);
+					}
+				}
+			}
+		}
+
 		if (!outerSerializer.isReading())
 		{
 			std::vector<uint8> compressed;
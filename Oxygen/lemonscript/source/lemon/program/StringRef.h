@@ -23,6 +23,7 @@ namespace lemon
 		inline const FlyweightString* getStringByHash(uint64 hash) const  { return mapFind(mStrings, hash); }
 		inline void addString(FlyweightString str)				  { mStrings[str.getHash()] = str; }
 		inline void addString(std::string_view str, uint64 hash)  { mStrings[hash] = str; }
+		inline void removeString(uint64 hash)					  { mStrings.erase(hash); }
 
 		void addFromList(const std::vector<FlyweightString>& list);
 
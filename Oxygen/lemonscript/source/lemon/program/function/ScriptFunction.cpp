@@ -37,6 +37,12 @@ namespace lemon
 		return *mLocalVariablesByID[id];
 	}
 
+	size_t ScriptFunction::getLocalVariableMemoryOffset(uint32 id) const
+	{
+		// IDs behind the function's own local variables refer to inlined local variables, see "getInlinedLocalVariableID"
+		return (id < mLocalVariablesByID.size()) ? mLocalVariablesByID[id]->getLocalMemoryOffset() : mLocalVariablesMemorySize + (id - mLocalVariablesByID.size()) * 8;
+	}
+
 	LocalVariable& ScriptFunction::addLocalVariable(FlyweightString name, const DataTypeDefinition* dataType, uint32 lineNumber)
 	{
 		// Check if it already exists!
@@ -48,6 +48,11 @@ namespace lemon
 		LocalVariable* getLocalVariableByIdentifier(uint64 nameHash) const;
 		LocalVariable& getLocalVariableByID(uint32 id) const;
 		LocalVariable& addLocalVariable(FlyweightString name, const DataTypeDefinition* dataType, uint32 lineNumber);
+		size_t getLocalVariableMemoryOffset(uint32 id) const;
+
+		// Inlined local variables are 8-byte slots behind the function's own local variables, shared between all inlined function calls
+		//  -> They have no variable instances, so that inlining does not need to modify the function
+		inline uint32 getInlinedLocalVariableID(size_t slotIndex) const  { return (uint32)(mLocalVariablesByID.size() + slotIndex); }
 
 		const std::vector<Label>& getLabels() const  { return mLabels; }
 		const Label* findLabelByName(FlyweightString labelName) const;
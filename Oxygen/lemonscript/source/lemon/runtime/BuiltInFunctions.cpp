@@ -53,7 +53,8 @@ namespace lemon
 			RMX_ASSERT(nullptr != runtime, "No lemon script runtime active");
 			const std::vector<ConstantArray*>& constantArrays = runtime->getProgram().getConstantArrays();
 			RMX_CHECK(id < constantArrays.size(), "Invalid constant array ID " << id << " (must be below " << constantArrays.size() << ")", return StringRef());
-			return StringRef(constantArrays[id]->getElement(index).get<uint64>());
+			const FlyweightString* str = runtime->resolveStringByKey(constantArrays[id]->getElement(index).get<uint64>());
+			return (nullptr != str) ? StringRef(*str) : StringRef();
 		}
 
 		size_t getArraySize(Variable& var)
@@ -113,7 +114,10 @@ namespace lemon
 		template<>
 		StringRef array_bracket_getter(const NativeFunction::Context* context, uint32 variableId, uint32 index)
 		{
-			return StringRef(array_bracket_getter<uint64>(context, variableId, index));
+			// Strings created at runtime are only known to the runtime, not to the global flyweight string pool
+			const uint64 stringHash = array_bracket_getter<uint64>(context, variableId, index);
+			const FlyweightString* str = context->mControlFlow.getRuntime().resolveStringByKey(stringHash);
+			return (nullptr != str) ? StringRef(*str) : StringRef();
 		}
 
 		template<typename T>
@@ -198,7 +202,7 @@ namespace lemon
 			result.clear();
 			result.addString(str1.getStringRef());
 			result.addString(str2.getStringRef());
-			return StringRef(runtime->addString(std::string_view(result.mBuffer, result.mLength)));
+			return runtime->addStringRef(std::string_view(result.mBuffer, result.mLength));
 		}
 
 		StringRef string_operator_plus_int64(StringRef str, int64 value)
@@ -211,7 +215,7 @@ namespace lemon
 			result.clear();
 			result.addString(str.getStringRef());
 			result.addDecimal(value, 0);
-			return StringRef(runtime->addString(std::string_view(result.mBuffer, result.mLength)));
+			return runtime->addStringRef(std::string_view(result.mBuffer, result.mLength));
 		}
 
 		StringRef string_operator_plus_int64_inv(int64 value, StringRef str)
@@ -224,7 +228,7 @@ namespace lemon
 			result.clear();
 			result.addDecimal(value, 0);
 			result.addString(str.getStringRef());
-			return StringRef(runtime->addString(std::string_view(result.mBuffer, result.mLength)));
+			return runtime->addStringRef(std::string_view(result.mBuffer, result.mLength));
 		}
 
 		bool string_operator_less(StringRef str1, StringRef str2)
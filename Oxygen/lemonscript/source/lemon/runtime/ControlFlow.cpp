@@ -114,8 +114,7 @@ namespace lemon
 			default:
 			case Variable::Type::LOCAL:
 			{
-				const LocalVariable& variable = getCurrentFunction()->getLocalVariableByID(variableId);
-				return readLocalVariable<int64>(variable.getLocalMemoryOffset());
+				return readLocalVariable<int64>(getCurrentFunction()->getLocalVariableMemoryOffset(variableId));
 			}
 
 			case Variable::Type::GLOBAL:
@@ -149,8 +148,7 @@ namespace lemon
 			default:
 			case Variable::Type::LOCAL:
 			{
-				const LocalVariable& variable = getCurrentFunction()->getLocalVariableByID(variableId);
-				writeLocalVariable(variable.getLocalMemoryOffset(), value);
+				writeLocalVariable(getCurrentFunction()->getLocalVariableMemoryOffset(variableId), value);
 				break;
 			}
 
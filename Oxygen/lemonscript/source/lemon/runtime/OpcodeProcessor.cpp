@@ -17,9 +17,13 @@ namespace lemon
 {
 
 	void OpcodeProcessor::buildOpcodeData(std::vector<OpcodeData>& opcodeData, const ScriptFunction& function)
+	{
+		buildOpcodeData(opcodeData, function.mOpcodes);
+	}
+
+	void OpcodeProcessor::buildOpcodeData(std::vector<OpcodeData>& opcodeData, const std::vector<Opcode>& opcodes)
 	{
 		// Reset
-		const std::vector<Opcode>& opcodes = function.mOpcodes;
 		const size_t numOpcodes = opcodes.size();
 		opcodeData.resize(numOpcodes);
 
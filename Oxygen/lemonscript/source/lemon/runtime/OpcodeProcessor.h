@@ -13,6 +13,7 @@
 
 namespace lemon
 {
+	struct Opcode;
 	class ScriptFunction;
 
 	class OpcodeProcessor
@@ -25,6 +26,7 @@ namespace lemon
 
 	public:
 		static void buildOpcodeData(std::vector<OpcodeData>& opcodeData, const ScriptFunction& function);
+		static void buildOpcodeData(std::vector<OpcodeData>& opcodeData, const std::vector<Opcode>& opcodes);
 	};
 
 }
@@ -80,6 +80,9 @@ namespace lemon
 
 			return (newPC == -1) ? oldPC : newPC;
 		}
+
+		// Minimum number of runtime strings before a string garbage collection gets performed at all
+		const size_t MIN_STRING_COLLECTION_THRESHOLD = 0x1000;
 	}
 
 
@@ -111,6 +114,7 @@ namespace lemon
 		mSelectedControlFlow = mControlFlows[0];
 
 		mRuntimeOpcodesPool.setPageSize(0x40000);
+		mStringCollectionThreshold = MIN_STRING_COLLECTION_THRESHOLD;
 	}
 
 	Runtime::~Runtime()
@@ -132,6 +136,8 @@ namespace lemon
 		mRuntimeFunctionsBySignature.clear();
 		mRuntimeOpcodesPool.clear();
 		mStrings.clear();
+		mStringHeap.clear();
+		mStringCollectionThreshold = MIN_STRING_COLLECTION_THRESHOLD;
 
 		if (nullptr != mProgram)
 		{
@@ -245,13 +251,31 @@ namespace lemon
 	}
 
 	uint64 Runtime::addString(std::string_view str)
+	{
+		return addStringRef(str).getHash();
+	}
+
+	StringRef Runtime::addStringRef(std::string_view str)
 	{
 		const uint64 hash = rmx::getMurmur2_64(str);
-		if (nullptr == mStrings.getStringByHash(hash))
-		{
-			mStrings.addString(str, hash);
-		}
-		return hash;
+		const FlyweightString* existingString = mStrings.getStringByHash(hash);
+		if (nullptr != existingString)
+			return StringRef(*existingString);
+
+		// String literals are all registered already, so this is a new runtime string
+		const FlyweightString runtimeString = mStringHeap.addString(str, hash);
+		mStrings.addString(runtimeString);
+		return StringRef(runtimeString);
+	}
+
+	size_t Runtime::collectStringGarbage()
+	{
+		markReachableStrings();
+		const size_t numRemoved = mStringHeap.sweep([&](uint64 hash) { mStrings.removeString(hash); });
+
+		// Let the threshold grow with the number of surviving strings, so that collections don't happen all the time when many strings are in use
+		mStringCollectionThreshold = std::max(MIN_STRING_COLLECTION_THRESHOLD, mStringHeap.size() * 2);
+		return numRemoved;
 	}
 
 	AnyBaseValue Runtime::getGlobalVariableValue(const GlobalVariable& variable)
@@ -446,19 +470,31 @@ namespace lemon
 		mActiveControlFlow = mSelectedControlFlow;
 		mCurrentOpcodePtr = &context.mOpcode;
 
+		// Switches execution to the function on top of the call stack
+		ControlFlow::State* state = nullptr;
+		const auto enterTopOfCallStack = [&]()
+		{
+			RMX_CHECK(mSelectedControlFlow->mValueStackPtr >= mSelectedControlFlow->mValueStackStart, "Value stack error: Removed elements from empty stack", mSelectedControlFlow->mValueStackPtr = mSelectedControlFlow->mValueStackStart);
+			RMX_CHECK(mSelectedControlFlow->mValueStackPtr < &mSelectedControlFlow->mValueStackBuffer[ControlFlow::VALUE_STACK_LAST_INDEX], "Value stack error: Too many elements", mSelectedControlFlow->mValueStackPtr = &mSelectedControlFlow->mValueStackBuffer[0x77]);
+
+			state = &mSelectedControlFlow->mCallStack.back();
+			mSelectedControlFlow->mCurrentLocalVariables = reinterpret_cast<uint8*>(&mSelectedControlFlow->mLocalVariablesBuffer[state->mLocalVariablesStart]);
+			context.mOpcode = (const RuntimeOpcode*)state->mProgramCounter;
+		};
+
 		// Outer loop
-		//  -> Gets restarted whenever the currently running function changes
+		//  -> Gets restarted whenever the currently running function changes, unless fast calls are used
 		//  -> Gets exited only by a stop signal or a return
 		mReceivedStopSignal = false;
 		while (!mReceivedStopSignal)
 		{
-			ControlFlow::State& state = mSelectedControlFlow->mCallStack.back();
+			state = &mSelectedControlFlow->mCallStack.back();
 
 		#ifdef DEBUG
 			// Reached the end already?
 			//  -> Should not happen actually, as all functions end with a return opcode
 			//  -> That's why this check is only active in debug builds
-			if (state.mProgramCounter > state.mRuntimeFunction->mRuntimeOpcodeBuffer.getEnd())
+			if (state->mProgramCounter > state->mRuntimeFunction->mRuntimeOpcodeBuffer.getEnd())
 			{
 				RMX_ASSERT(false, "Program counter exceeded the end of function");
 				returnFromFunction();
@@ -468,18 +504,12 @@ namespace lemon
 			}
 		#endif
 
-			RMX_CHECK(mSelectedControlFlow->mValueStackPtr >= mSelectedControlFlow->mValueStackStart, "Value stack error: Removed elements from empty stack", mSelectedControlFlow->mValueStackPtr = mSelectedControlFlow->mValueStackStart);
-			RMX_CHECK(mSelectedControlFlow->mValueStackPtr < &mSelectedControlFlow->mValueStackBuffer[ControlFlow::VALUE_STACK_LAST_INDEX], "Value stack error: Too many elements", mSelectedControlFlow->mValueStackPtr = &mSelectedControlFlow->mValueStackBuffer[0x77]);
-
 			RMX_ASSERT(mSelectedControlFlow->mLocalVariablesSize <= ControlFlow::VAR_STACK_LIMIT, "Reached var stack limit");
-			mSelectedControlFlow->mCurrentLocalVariables = reinterpret_cast<uint8*>(&mSelectedControlFlow->mLocalVariablesBuffer[state.mLocalVariablesStart]);
-			RMX_ASSERT(nullptr != mSelectedControlFlow->mCurrentLocalVariables, "Reached var stack limit");
-
-			context.mOpcode = (const RuntimeOpcode*)state.mProgramCounter;
+			enterTopOfCallStack();
 
 			// Inner loop
 			//  -> Main execution of opcodes inside a single function
-			//  -> Not exited on jumps
+			//  -> Not exited on jumps, and neither on calls and returns in fast calls mode
 			//  -> Gets exited by changing stayInsideInnerLoop when the running function was changed
 			//  -> Gets exited by a return when control needs to be returned to the caller
 			bool stayInsideInnerLoop = true;
@@ -530,7 +560,7 @@ namespace lemon
 
 					case Opcode::Type::JUMP:
 					{
-						state.mProgramCounter = reinterpret_cast<const uint8*>(context.mOpcode->getParameter<uint64>());
+						state->mProgramCounter = reinterpret_cast<const uint8*>(context.mOpcode->getParameter<uint64>());
 
 						// Check if steps limit is reached (this usually means the limit was exceeded already, but that's okay)
 						//  -> This is needed to prevent endless loops
@@ -541,7 +571,7 @@ namespace lemon
 							return;
 						}
 
-						context.mOpcode = (const RuntimeOpcode*)state.mProgramCounter;
+						context.mOpcode = (const RuntimeOpcode*)state->mProgramCounter;
 						break;
 					}
 
@@ -565,11 +595,24 @@ namespace lemon
 
 					case Opcode::Type::CALL:
 					{
-						state.mProgramCounter = (uint8*)context.mOpcode + context.mOpcode->mOffsetToNext;
+						state->mProgramCounter = (uint8*)context.mOpcode + context.mOpcode->mOffsetToNext;
 						const uint64 callTarget = context.mOpcode->getParameter<uint64>();
 						++result.mStepsExecuted;
 
 						const Function* func = handleResultCall(*context.mOpcode);
+						if (result.mUseFastCalls && nullptr != func)
+						{
+							// Go on with either the called script function, or the calling function after a native call
+							//  -> Native functions may have triggered a stop signal, which needs to be checked in the outer loop
+							if (mReceivedStopSignal)
+							{
+								stayInsideInnerLoop = false;
+								break;
+							}
+							enterTopOfCallStack();
+							break;
+						}
+
 						if (result.handleCall(func, callTarget))
 						{
 							// Restart the outer loop now that the running function has changed
@@ -590,11 +633,17 @@ namespace lemon
 						mSelectedControlFlow->mCallStack.pop_back();
 						++result.mStepsExecuted;
 
-						if (result.handleReturn())
+						if (result.mUseFastCalls || result.handleReturn())
 						{
 							// Check stop conditions
 							if (mSelectedControlFlow->mCallStack.count > minimumCallStackSize && result.mStepsExecuted < stepsLimit)
 							{
+								if (result.mUseFastCalls)
+								{
+									enterTopOfCallStack();
+									break;
+								}
+
 								// Restart the outer loop now that the running function has changed
 								stayInsideInnerLoop = false;
 								break;
@@ -608,7 +657,7 @@ namespace lemon
 
 					case Opcode::Type::EXTERNAL_CALL:
 					{
-						state.mProgramCounter = (uint8*)context.mOpcode + context.mOpcode->mSize;
+						state->mProgramCounter = (uint8*)context.mOpcode + context.mOpcode->mSize;
 						--mSelectedControlFlow->mValueStackPtr;
 						const uint64 targetAddress = *mSelectedControlFlow->mValueStackPtr;
 						++result.mStepsExecuted;
@@ -628,7 +677,7 @@ namespace lemon
 
 					case Opcode::Type::EXTERNAL_JUMP:
 					{
-						state.mProgramCounter = (uint8*)context.mOpcode + context.mOpcode->mSize;
+						state->mProgramCounter = (uint8*)context.mOpcode + context.mOpcode->mSize;
 						--mSelectedControlFlow->mValueStackPtr;
 						returnFromFunction();
 						const uint64 targetAddress = *mSelectedControlFlow->mValueStackPtr;
@@ -719,6 +768,7 @@ namespace lemon
 		// Format version history:
 		//  - 0x00 = First version, no signature yet
 		//  - 0x01 = Added signature and version number + serialize global variable names
+		//  - 0x02 = Serialize runtime strings that are reachable from the serialized state
 
 		if (nullptr == mProgram)
 		{
@@ -739,7 +789,7 @@ namespace lemon
 
 		// Signature and version number
 		const uint32 SIGNATURE = *(uint32*)"LMN|";
-		uint16 version = 0x01;
+		uint16 version = 0x02;
 		if (serializer.isReading())
 		{
 			const uint32 signature = *(const uint32*)serializer.peek();
@@ -917,6 +967,33 @@ namespace lemon
 			}
 		}
 
+		// Serialize runtime strings
+		//  -> Otherwise string values in the call stack, value stack or global variables would not resolve any more after loading in another session
+		if (version >= 0x02)
+		{
+			if (serializer.isReading())
+			{
+				const size_t numStrings = (size_t)serializer.read<uint32>();
+				for (size_t i = 0; i < numStrings; ++i)
+				{
+					addString(serializer.readStringView());
+				}
+			}
+			else
+			{
+				std::vector<FlyweightString> strings;
+				markReachableStrings();
+				mStringHeap.getMarkedStrings(strings);
+				mStringHeap.clearMarks();
+
+				serializer.writeAs<uint32>(strings.size());
+				for (const FlyweightString& str : strings)
+				{
+					serializer.write(str.getString());
+				}
+			}
+		}
+
 		// Done
 		return true;
 	}
@@ -959,4 +1036,47 @@ namespace lemon
 		}
 	}
 
+	void Runtime::markReachableStrings()
+	{
+		// Value stacks and local variables don't have type information at runtime, so just treat every value as a potential string key
+		//  -> A non-string value colliding with a 64-bit string hash is very unlikely, and would only keep that string alive a little longer
+		for (ControlFlow* controlFlow : mControlFlows)
+		{
+			for (const uint64* valuePtr = controlFlow->mValueStackStart; valuePtr < controlFlow->mValueStackPtr; ++valuePtr)
+			{
+				mStringHeap.mark(*valuePtr);
+			}
+			for (size_t k = 0; k < controlFlow->mLocalVariablesSize; ++k)
+			{
+				mStringHeap.mark((uint64)controlFlow->mLocalVariablesBuffer[k]);
+			}
+		}
+
+		// Global variables do have a data type, so only look at strings and string arrays
+		if (nullptr != mProgram)
+		{
+			for (Variable* variable : mProgram->getGlobalVariables())
+			{
+				if (!variable->isA<GlobalVariable>())
+					continue;
+
+				const DataTypeDefinition* dataType = variable->getDataType();
+				size_t numElements = 1;
+				if (dataType->isA<ArrayDataType>())
+				{
+					numElements = dataType->as<ArrayDataType>().mArraySize;
+					dataType = &dataType->as<ArrayDataType>().mElementType;
+				}
+				if (!dataType->isA<StringDataType>())
+					continue;
+
+				const size_t offset = variable->as<GlobalVariable>().getStaticMemoryOffset();
+				for (size_t k = 0; k < numElements && offset + (k + 1) * sizeof(uint64) <= mStaticMemory.size(); ++k)
+				{
+					mStringHeap.mark(*(const uint64*)&mStaticMemory[offset + k * sizeof(uint64)]);
+				}
+			}
+		}
+	}
+
 }
@@ -11,6 +11,7 @@
 #include "lemon/program/function/ScriptFunction.h"
 #include "lemon/program/StringRef.h"
 #include "lemon/runtime/ControlFlow.h"
+#include "lemon/runtime/RuntimeStringHeap.h"
 
 
 namespace lemon
@@ -97,6 +98,10 @@ namespace lemon
 
 		struct ExecuteConnector : public ExecuteResult
 		{
+			// If set, calls and returns between script functions are handled right inside "executeSteps", without calling "handleCall" and "handleReturn"
+			//  -> Only use this if these don't need to do anything on success; external calls and jumps still go through the connector
+			bool mUseFastCalls = false;
+
 			virtual bool handleCall(const Function* func, uint64 callTarget) = 0;
 			virtual bool handleReturn() = 0;
 			virtual bool handleExternalCall(uint64 address) = 0;
@@ -154,6 +159,14 @@ namespace lemon
 		bool hasStringWithKey(uint64 key) const;
 		const FlyweightString* resolveStringByKey(uint64 key) const;
 		uint64 addString(std::string_view str);
+		StringRef addStringRef(std::string_view str);
+
+		// Runtime string garbage collection
+		//  -> Only call this while no native function is being executed, as these may still hold references to strings that are not reachable from script anymore
+		//  -> Strings written to emulated memory are not considered reachable, only those in value stacks, local and global variables
+		inline const RuntimeStringHeap& getStringHeap() const  { return mStringHeap; }
+		inline bool needsStringGarbageCollection() const  { return mStringHeap.size() >= mStringCollectionThreshold; }
+		size_t collectStringGarbage();
 
 		AnyBaseValue getGlobalVariableValue(const GlobalVariable& variable);
 		void setGlobalVariableValue(const GlobalVariable& variable, AnyBaseValue value);
@@ -183,6 +196,7 @@ namespace lemon
 
 	private:
 		void setupGlobalVariables();
+		void markReachableStrings();
 
 	private:
 		inline static ControlFlow* mActiveControlFlow = nullptr;
@@ -201,7 +215,9 @@ namespace lemon
 		// Static memory contains all global variables
 		std::vector<uint8> mStaticMemory;
 
-		StringLookup mStrings;
+		StringLookup mStrings;				// Contains both string literals and runtime strings
+		RuntimeStringHeap mStringHeap;		// Owns the runtime strings
+		size_t mStringCollectionThreshold = 0;
 
 		// TODO: Add functions to create / destroy control flows, otherwise we're stuck with just the main control flow
 		std::vector<ControlFlow*> mControlFlows;		// Contains at least one control flow at all times = the main control flow at index 0
@@ -14,11 +14,29 @@
 #include "lemon/runtime/provider/DefaultOpcodeProvider.h"
 #include "lemon/runtime/provider/OptimizedOpcodeProvider.h"
 #include "lemon/runtime/provider/NativizedOpcodeProvider.h"
+#include "lemon/compiler/backend/OpcodeOptimization.h"
 #include "lemon/program/Program.h"
 
 
 namespace lemon
 {
+	namespace
+	{
+		bool hasNativizedCode(const ScriptFunction& function, const std::vector<OpcodeProcessor::OpcodeData>& opcodeData, const Runtime& runtime)
+		{
+			const Program& program = runtime.getProgram();
+			if (program.getOptimizationLevel() < 2 || nullptr == program.mNativizedOpcodeProvider)
+				return false;
+
+			for (size_t i = 0; i < function.mOpcodes.size(); ++i)
+			{
+				if (program.mNativizedOpcodeProvider->hasLookupEntry(&function.mOpcodes[i], opcodeData[i].mRemainingSequenceLength, runtime))
+					return true;
+			}
+			return false;
+		}
+	}
+
 
 	RuntimeOpcodeBuffer::~RuntimeOpcodeBuffer()
 	{
@@ -93,16 +111,30 @@ namespace lemon
 		if (!mRuntimeOpcodeBuffer.empty() || mFunction->mOpcodes.empty())
 			return true;
 
+		// Preparation: Build some useful information about opcodes
+		static std::vector<OpcodeProcessor::OpcodeData> opcodeData;
+		OpcodeProcessor::buildOpcodeData(opcodeData, *mFunction);
+
+		// Optimize the opcodes now that all functions they could call are known
+		//  -> This is skipped if there's nativized code for the function, as that was created for the original opcodes
+		static std::vector<Opcode> optimizedOpcodes;
+		static std::vector<size_t> opcodeIndexRemap;
+		bool useOptimizedOpcodes = false;
+		if (runtime.getProgram().getOptimizationLevel() >= 1 && !hasNativizedCode(*mFunction, opcodeData, runtime))
+		{
+			useOptimizedOpcodes = OpcodeOptimization::optimizeForRuntime(*mFunction, runtime.getProgram(), optimizedOpcodes, opcodeIndexRemap);
+			if (useOptimizedOpcodes)
+			{
+				OpcodeProcessor::buildOpcodeData(opcodeData, optimizedOpcodes);
+			}
+		}
+
 		// Create the runtime opcodes
 		{
 			// Initialize runtime opcodes now that they are needed
-			const std::vector<Opcode>& opcodes = mFunction->mOpcodes;
+			const std::vector<Opcode>& opcodes = useOptimizedOpcodes ? optimizedOpcodes : mFunction->mOpcodes;
 			const size_t numOpcodes = opcodes.size();
 
-			// Preparation: Build some useful information about opcodes
-			static std::vector<OpcodeProcessor::OpcodeData> opcodeData;
-			OpcodeProcessor::buildOpcodeData(opcodeData, *mFunction);
-
 			// Using a static buffer as temporary buffer before knowing the final size
 			static RuntimeOpcodeBuffer tempBuffer;
 			tempBuffer.clear();
@@ -204,6 +236,17 @@ namespace lemon
 			}
 		}
 
+		// Program counters were collected for the optimized opcodes, but are needed per original opcode from here on
+		if (useOptimizedOpcodes)
+		{
+			const std::vector<size_t> programCounterByOptimizedOpcodeIndex = std::move(mProgramCounterByOpcodeIndex);
+			mProgramCounterByOpcodeIndex.assign(opcodeIndexRemap.size(), 0);
+			for (size_t i = 0; i < opcodeIndexRemap.size(); ++i)
+			{
+				mProgramCounterByOpcodeIndex[i] = programCounterByOptimizedOpcodeIndex[opcodeIndexRemap[i]];
+			}
+		}
+
 		return true;
 	}
 
@@ -236,9 +279,17 @@ namespace lemon
 			}
 			else
 			{
-				return (int)median;
+				// Several original opcodes can share the same runtime opcode, use the first one
+				size_t index = median;
+				while (index > 0 && mProgramCounterByOpcodeIndex[index - 1] == programCounter)
+					--index;
+				return (int)index;
 			}
 		}
+
+		// Inlined function calls have no original opcodes of their own, so use the last original opcode before
+		if (programCounter < mRuntimeOpcodeBuffer.size() && maximum < mProgramCounterByOpcodeIndex.size())
+			return (int)maximum;
 		return -1;
 	}
 
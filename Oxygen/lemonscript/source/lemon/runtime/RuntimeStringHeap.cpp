@@ -0,0 +1,106 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "lemon/pch.h"
+#include "lemon/runtime/RuntimeStringHeap.h"
+
+
+namespace lemon
+{
+
+	RuntimeStringHeap::~RuntimeStringHeap()
+	{
+		clear();
+	}
+
+	void RuntimeStringHeap::clear()
+	{
+		for (const auto& pair : mEntries)
+		{
+			destroyEntry(pair.second);
+		}
+		mEntries.clear();
+		mMemoryUsage = 0;
+	}
+
+	FlyweightString RuntimeStringHeap::addString(std::string_view str, uint64 hash)
+	{
+		HeapEntry*& heapEntry = mEntries[hash];
+		if (nullptr == heapEntry)
+		{
+			// Allocate enough memory to hold both the entry and the string content, like the flyweight string manager does
+			const size_t requiredSize = sizeof(HeapEntry) + str.length();
+			uint8* entryPointer = new uint8[requiredSize];
+			heapEntry = new (static_cast<void*>(entryPointer)) HeapEntry();
+			uint8* contentPointer = entryPointer + sizeof(HeapEntry);
+			memcpy(contentPointer, str.data(), str.length());
+
+			heapEntry->mEntry.mHash = hash;
+			heapEntry->mEntry.mString = std::string_view((const char*)contentPointer, str.length());
+			mMemoryUsage += requiredSize;
+		}
+		return FlyweightString(&heapEntry->mEntry);
+	}
+
+	bool RuntimeStringHeap::mark(uint64 hash)
+	{
+		const auto it = mEntries.find(hash);
+		if (it == mEntries.end())
+			return false;
+
+		it->second->mMarked = true;
+		return true;
+	}
+
+	void RuntimeStringHeap::clearMarks()
+	{
+		for (const auto& pair : mEntries)
+		{
+			pair.second->mMarked = false;
+		}
+	}
+
+	void RuntimeStringHeap::getMarkedStrings(std::vector<FlyweightString>& outStrings) const
+	{
+		for (const auto& pair : mEntries)
+		{
+			if (pair.second->mMarked)
+				outStrings.push_back(FlyweightString(&pair.second->mEntry));
+		}
+	}
+
+	size_t RuntimeStringHeap::sweep(const std::function<void(uint64)>& onRemove)
+	{
+		size_t numRemoved = 0;
+		for (auto it = mEntries.begin(); it != mEntries.end(); )
+		{
+			HeapEntry* heapEntry = it->second;
+			if (heapEntry->mMarked)
+			{
+				heapEntry->mMarked = false;
+				++it;
+			}
+			else
+			{
+				onRemove(it->first);
+				mMemoryUsage -= sizeof(HeapEntry) + heapEntry->mEntry.mString.length();
+				destroyEntry(heapEntry);
+				it = mEntries.erase(it);
+				++numRemoved;
+			}
+		}
+		return numRemoved;
+	}
+
+	void RuntimeStringHeap::destroyEntry(HeapEntry* heapEntry)
+	{
+		heapEntry->~HeapEntry();
+		delete[] reinterpret_cast<uint8*>(heapEntry);
+	}
+
+}
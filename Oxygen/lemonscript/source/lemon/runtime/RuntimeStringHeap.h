@@ -0,0 +1,54 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+#include "lemon/utility/FlyweightString.h"
+
+
+namespace lemon
+{
+
+	// Storage for strings created at runtime by scripts, e.g. by string concatenation or string formatting
+	//  -> Unlike string literals, these are not interned in the global flyweight string pool, but owned by the heap and freed again by a mark-and-sweep collection
+	//  -> The runtime is responsible for marking all reachable strings before a sweep
+	class API_EXPORT RuntimeStringHeap
+	{
+	public:
+		~RuntimeStringHeap();
+
+		inline size_t size() const  { return mEntries.size(); }
+		inline size_t getMemoryUsage() const  { return mMemoryUsage; }
+
+		void clear();
+
+		FlyweightString addString(std::string_view str, uint64 hash);
+
+		// Marking is conservative, i.e. it's fine to mark keys that don't belong to any string in the heap
+		bool mark(uint64 hash);
+		void clearMarks();
+		void getMarkedStrings(std::vector<FlyweightString>& outStrings) const;
+
+		// Frees all strings that were not marked, and calls the callback for each before it gets freed; all marks get reset
+		size_t sweep(const std::function<void(uint64)>& onRemove);
+
+	private:
+		struct HeapEntry
+		{
+			detail::FlyweightStringManager::Entry mEntry;
+			bool mMarked = false;
+		};
+
+		static void destroyEntry(HeapEntry* heapEntry);
+
+	private:
+		std::unordered_map<uint64, HeapEntry*> mEntries;
+		size_t mMemoryUsage = 0;
+	};
+
+}
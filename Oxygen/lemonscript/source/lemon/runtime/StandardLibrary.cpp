@@ -121,7 +121,7 @@ namespace lemon
 			result.clear();
 			StringFormatterLegacy::buildFormattedString(result, format.getString(), numArguments, args);
 
-			return StringRef(runtime->addString(std::string_view(result.mBuffer, result.mLength)));
+			return runtime->addStringRef(std::string_view(result.mBuffer, result.mLength));
 		}
 
 		StringRef stringformat1(StringRef format, AnyTypeWrapper arg1)
@@ -227,7 +227,7 @@ namespace lemon
 			result.clear();
 			StringFormatter::buildFormattedString(result, format.getString(), numArguments, args);
 
-			return StringRef(runtime->addString(std::string_view(result.mBuffer, result.mLength)));
+			return runtime->addStringRef(std::string_view(result.mBuffer, result.mLength));
 		}
 
 		StringRef string_build1(StringRef format, AnyTypeWrapper arg1)
@@ -306,7 +306,7 @@ namespace lemon
 				return StringRef();
 
 			const std::string_view part = string.getString().substr(index, length);
-			return StringRef(runtime->addString(part));
+			return runtime->addStringRef(part);
 		}
 
 		bool string_startsWith(StringRef string, StringRef substring)
@@ -336,7 +336,7 @@ namespace lemon
 			Runtime* runtime = Runtime::getActiveRuntime();
 			RMX_ASSERT(nullptr != runtime, "No lemon script runtime active");
 			const char str[2] = { (char)character, '\0' };
-			return StringRef(runtime->addString(str));
+			return runtime->addStringRef(str);
 		}
 
 		StringRef getStringFromHash(uint64 hash)
@@ -449,8 +449,7 @@ namespace lemon
 				{
 					case Variable::Type::LOCAL:
 					{
-						const LocalVariable& variable = function.getLocalVariableByID(variableId);
-						runtimeOpcode.setParameter(variable.getLocalMemoryOffset());
+						runtimeOpcode.setParameter(function.getLocalVariableMemoryOffset(variableId));
 						runtimeOpcode.mExecFunc = &OpcodeExec::exec_GET_VARIABLE_VALUE_LOCAL;
 						break;
 					}
@@ -503,8 +502,7 @@ namespace lemon
 				{
 					case Variable::Type::LOCAL:
 					{
-						const LocalVariable& variable = function.getLocalVariableByID(variableId);
-						runtimeOpcode.setParameter(variable.getLocalMemoryOffset());
+						runtimeOpcode.setParameter(function.getLocalVariableMemoryOffset(variableId));
 						runtimeOpcode.mExecFunc = &OpcodeExec::exec_SET_VARIABLE_VALUE_LOCAL;
 						break;
 					}
@@ -22,38 +22,35 @@ namespace lemon
 		(*buildFunction)(mLookupDictionary);
 	}
 
-	bool NativizedOpcodeProvider::buildRuntimeOpcode(RuntimeOpcodeBuffer& buffer, const Opcode* opcodes, int numOpcodesAvailable, int firstOpcodeIndex, int& outNumOpcodesConsumed, const Runtime& runtime, const ScriptFunction& function)
+	void NativizedOpcodeProvider::addLookup(BuildFunction buildFunction)
 	{
-		if (mLookupDictionary.mEntries.empty() || numOpcodesAvailable < (int)Nativizer::MIN_OPCODES)
-			return false;
+		Nativizer::LookupDictionary dict;
+		(*buildFunction)(dict);
+		addLookup(dict);
+	}
 
-		Nativizer::LookupEntry* bestEntry = nullptr;
-		uint64 bestEntryHash = 0;		// Variable exists only for debugging
+	void NativizedOpcodeProvider::addLookup(const Nativizer::LookupDictionary& dict)
+	{
+		// Parameter data of the added dictionary gets appended, so its entries' parameter start indices need to be shifted
+		const size_t parameterStartOffset = mLookupDictionary.mParameterData.size();
+		mLookupDictionary.mParameterData.insert(mLookupDictionary.mParameterData.end(), dict.mParameterData.begin(), dict.mParameterData.end());
+
+		mLookupDictionary.mEntries.reserve(mLookupDictionary.mEntries.size() + dict.mEntries.size());
+		for (const auto& pair : dict.mEntries)
 		{
-			uint64 hash = Nativizer::getStartHash();
-			for (size_t index = 0; index < (size_t)numOpcodesAvailable; )
+			// Hashes identify the opcode sequence, so entries with the same hash are interchangeable
+			//  -> Only an empty entry (marking a prefix of a longer sequence) gets replaced by one with actual code
+			Nativizer::LookupEntry& entry = mLookupDictionary.mEntries[pair.first];
+			if (nullptr == entry.mExecFunc && nullptr != pair.second.mExecFunc)
 			{
-				Nativizer::OpcodeSubtypeInfo info;
-				Nativizer::getOpcodeSubtypeInfo(info, &opcodes[index], numOpcodesAvailable, *runtime.getMemoryAccessHandler());
-				hash = Nativizer::addOpcodeSubtypeInfoToHash(hash, info);
-				index += info.mConsumedOpcodes;
-
-				if (index >= Nativizer::MIN_OPCODES)
-				{
-					const auto it = mLookupDictionary.mEntries.find(hash);
-					if (it == mLookupDictionary.mEntries.end())
-						return false;
-
-					if (nullptr != it->second.mExecFunc)
-					{
-						bestEntry = &it->second;
-						bestEntryHash = hash;
-						outNumOpcodesConsumed = (int)index;
-					}
-				}
+				entry = Nativizer::LookupEntry(pair.second.mExecFunc, pair.second.mParameterStart + parameterStartOffset);
 			}
 		}
+	}
 
+	bool NativizedOpcodeProvider::buildRuntimeOpcode(RuntimeOpcodeBuffer& buffer, const Opcode* opcodes, int numOpcodesAvailable, int firstOpcodeIndex, int& outNumOpcodesConsumed, const Runtime& runtime, const ScriptFunction& function)
+	{
+		const Nativizer::LookupEntry* bestEntry = findLookupEntry(opcodes, numOpcodesAvailable, runtime, outNumOpcodesConsumed);
 		if (nullptr != bestEntry)
 		{
 			// Find out number of parameters and total parameter size first
@@ -92,8 +89,7 @@ namespace lemon
 						case Nativizer::LookupEntry::ParameterInfo::Semantics::LOCAL_VARIABLE:
 						{
 							const uint32 variableId = (uint32)opcode.mParameter;
-							const LocalVariable& variable = function.getLocalVariableByID(variableId);
-							runtimeOpcode.setParameter(variable.getLocalMemoryOffset(), parameter.mOffset);
+							runtimeOpcode.setParameter(function.getLocalVariableMemoryOffset(variableId), parameter.mOffset);
 							break;
 						}
 
@@ -132,4 +128,42 @@ namespace lemon
 		return false;
 	}
 
+	bool NativizedOpcodeProvider::hasLookupEntry(const Opcode* opcodes, int numOpcodesAvailable, const Runtime& runtime) const
+	{
+		int numOpcodesConsumed = 0;
+		return (nullptr != findLookupEntry(opcodes, numOpcodesAvailable, runtime, numOpcodesConsumed));
+	}
+
+	const Nativizer::LookupEntry* NativizedOpcodeProvider::findLookupEntry(const Opcode* opcodes, int numOpcodesAvailable, const Runtime& runtime, int& outNumOpcodesConsumed) const
+	{
+		if (mLookupDictionary.mEntries.empty() || numOpcodesAvailable < (int)Nativizer::MIN_OPCODES)
+			return nullptr;
+
+		const Nativizer::LookupEntry* bestEntry = nullptr;
+		uint64 bestEntryHash = 0;		// Variable exists only for debugging
+		uint64 hash = Nativizer::getStartHash();
+		for (size_t index = 0; index < (size_t)numOpcodesAvailable; )
+		{
+			Nativizer::OpcodeSubtypeInfo info;
+			Nativizer::getOpcodeSubtypeInfo(info, &opcodes[index], numOpcodesAvailable, *runtime.getMemoryAccessHandler());
+			hash = Nativizer::addOpcodeSubtypeInfoToHash(hash, info);
+			index += info.mConsumedOpcodes;
+
+			if (index >= Nativizer::MIN_OPCODES)
+			{
+				const auto it = mLookupDictionary.mEntries.find(hash);
+				if (it == mLookupDictionary.mEntries.end())
+					return nullptr;
+
+				if (nullptr != it->second.mExecFunc)
+				{
+					bestEntry = &it->second;
+					bestEntryHash = hash;
+					outNumOpcodesConsumed = (int)index;
+				}
+			}
+		}
+		return bestEntry;
+	}
+
 }
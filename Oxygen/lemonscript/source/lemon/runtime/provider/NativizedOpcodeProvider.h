@@ -24,8 +24,14 @@ namespace lemon
 
 		inline bool isValid() const  { return !mLookupDictionary.mEntries.empty(); }
 		void buildLookup(BuildFunction buildFunction);
+		void addLookup(BuildFunction buildFunction);
+		void addLookup(const Nativizer::LookupDictionary& dict);
 
 		bool buildRuntimeOpcode(RuntimeOpcodeBuffer& buffer, const Opcode* opcodes, int numOpcodesAvailable, int firstOpcodeIndex, int& outNumOpcodesConsumed, const Runtime& runtime, const ScriptFunction& function) override;
+		bool hasLookupEntry(const Opcode* opcodes, int numOpcodesAvailable, const Runtime& runtime) const;
+
+	private:
+		const Nativizer::LookupEntry* findLookupEntry(const Opcode* opcodes, int numOpcodesAvailable, const Runtime& runtime, int& outNumOpcodesConsumed) const;
 
 	protected:
 		Nativizer::LookupDictionary mLookupDictionary;	// This needs to be filled by either a sub-class implementation or a call to the buildLookup method
@@ -320,8 +320,7 @@ namespace lemon
 					{
 						case Variable::Type::LOCAL:
 						{
-							const LocalVariable& variable = function.getLocalVariableByID(variableId);
-							runtimeOpcode.setParameter(variable.getLocalMemoryOffset());
+							runtimeOpcode.setParameter(function.getLocalVariableMemoryOffset(variableId));
 							runtimeOpcode.mExecFunc = &OptimizedOpcodeExec::exec_OPT_SET_VARIABLE_VALUE_LOCAL_DISCARD;
 							break;
 						}
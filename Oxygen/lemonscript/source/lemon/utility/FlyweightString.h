@@ -36,6 +36,8 @@ namespace lemon
 
 	class FlyweightString
 	{
+	friend class RuntimeStringHeap;
+
 	public:
 		inline FlyweightString() {}
 		inline explicit FlyweightString(uint64 hash) { set(hash); }
@@ -63,6 +65,10 @@ namespace lemon
 		void serialize(VectorBinarySerializer& serializer);
 		void write(VectorBinarySerializer& serializer) const;
 
+	private:
+		// Used for strings whose entry is not owned by the manager
+		inline explicit FlyweightString(detail::FlyweightStringManager::Entry* entry) : mEntry(entry) {}
+
 	private:
 		detail::FlyweightStringManager::Entry* mEntry = nullptr;
 
@@ -255,6 +255,33 @@ int main(int argc, char** argv)
 		}
 
 		RMX_CHECK(runtime.getMainControlFlow().getValueStackSize() == 0, "Runtime value stack must be empty at the end", );
+
+		// Run the serialization tests, saving and restoring the runtime state whenever execution stops
+		std::cout << "\r\n=== Serialization ===\r\n";
+		const Function* serializationTestFunc = program.getFunctionBySignature(rmx::getMurmur2_64(String("runSerializationTests")) + Function::getVoidSignatureHash());
+		RMX_CHECK(nullptr != serializationTestFunc, "Function not found", RMX_REACT_THROW);
+		runtime.callFunction(*serializationTestFunc);
+
+		RuntimeExecuteConnector serializationConnector(runtime);
+		std::vector<uint8> stateBuffer;
+		while (!serializationConnector.mStopped)
+		{
+			runtime.executeSteps(serializationConnector, 1, 0);
+
+			if (serializationConnector.mResult == Runtime::ExecuteResult::Result::HALT)
+			{
+				serializationConnector.mStopped = true;
+			}
+			else if (!serializationConnector.mStopped)
+			{
+				stateBuffer.clear();
+				VectorBinarySerializer writer(false, stateBuffer);
+				runtime.serializeState(writer);
+				VectorBinarySerializer reader(true, stateBuffer);
+				runtime.serializeState(reader);
+			}
+		}
+		std::cout << "Done with serialization tests\r\n";
 		doNothing();
 	}
 	catch (const std::exception& e)
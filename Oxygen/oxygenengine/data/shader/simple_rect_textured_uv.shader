@@ -33,13 +33,14 @@ out vec4 FragColor;
 uniform sampler2D MainTexture;
 #ifdef USE_TINT_COLOR
 	uniform vec4 TintColor;
+	uniform vec4 AddedColor;
 #endif
 
 void main()
 {
 	vec4 color = texture(MainTexture, uv0);
 #ifdef USE_TINT_COLOR
-	color *= TintColor;
+	color = vec4(AddedColor.rgb, 0.0) + color * TintColor;
 #endif
 #ifdef ALPHA_TEST
 	if (color.a < 0.01)
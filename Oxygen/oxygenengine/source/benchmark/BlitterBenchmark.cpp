@@ -0,0 +1,165 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+// Micro-benchmark for the blitter kernels
+//  -> Compares all instruction sets supported by this CPU against the scalar implementation, and checks that they produce identical results
+//  -> Usage: oxygen_blitter_benchmark [<iterations>]
+
+#include <rmxbase.h>
+#include "oxygen/drawing/software/BlitterKernels.h"
+#include "oxygen/helper/HighResolutionTimer.h"
+
+
+namespace
+{
+	// Sizes similar to the game screen with sprites of typical widths
+	static const size_t LINE_LENGTHS[] = { 7, 16, 24, 32, 48, 64, 400 };
+	static const size_t NUM_LINES = 224;
+
+	struct TestData
+	{
+		std::vector<uint32> mSource;
+		std::vector<uint32> mDestination;
+		std::vector<uint8> mDepth;
+		std::vector<uint8> mIndices;
+		std::vector<uint32> mPalette;
+		std::vector<uint32> mOutput;
+		size_t mLineLength = 0;
+
+		void setup(size_t lineLength)
+		{
+			mLineLength = lineLength;
+			const size_t numPixels = lineLength * NUM_LINES;
+			mSource.resize(numPixels);
+			mDestination.resize(numPixels);
+			mDepth.resize(numPixels);
+			mIndices.resize(numPixels);
+			mOutput.resize(numPixels);
+			mPalette.resize(64);
+
+			uint32 seed = 0x12345678;
+			const auto random = [&]() { seed = seed * 1664525 + 1013904223; return seed; };
+			for (size_t k = 0; k < numPixels; ++k)
+			{
+				// Mix of fully transparent, fully opaque and translucent pixels
+				const uint32 color = random() & 0x00ffffff;
+				const uint32 alphaType = random() % 3;
+				const uint32 alpha = (alphaType == 0) ? 0 : (alphaType == 1) ? 0xff : (random() & 0xff);
+				mSource[k] = color | (alpha << 24);
+				mDestination[k] = random();
+				mDepth[k] = (random() % 2) ? 0x80 : 0;
+				mIndices[k] = (uint8)(random() % 80);	// Includes indices outside of the palette
+			}
+			for (uint32& color : mPalette)
+				color = random();
+		}
+	};
+
+	enum class Kernel
+	{
+		ALPHA,
+		ALPHA_WITH_DEPTH,
+		OPAQUE_WITH_DEPTH,
+		PALETTE_LOOKUP
+	};
+
+	const char* getKernelName(Kernel kernel)
+	{
+		switch (kernel)
+		{
+			case Kernel::ALPHA:				 return "Alpha";
+			case Kernel::ALPHA_WITH_DEPTH:	 return "Alpha + depth";
+			case Kernel::OPAQUE_WITH_DEPTH:	 return "Opaque + depth";
+			case Kernel::PALETTE_LOOKUP:	 return "Palette lookup";
+		}
+		return "";
+	}
+
+	void runKernel(Kernel kernel, const BlitterKernels::Functions& functions, TestData& data)
+	{
+		const size_t lineLength = data.mLineLength;
+		for (size_t line = 0; line < NUM_LINES; ++line)
+		{
+			const size_t offset = line * lineLength;
+			switch (kernel)
+			{
+				case Kernel::ALPHA:				 functions.mBlendLineAlpha(&data.mOutput[offset], &data.mSource[offset], lineLength);  break;
+				case Kernel::ALPHA_WITH_DEPTH:	 functions.mBlendLineAlphaWithDepth(&data.mOutput[offset], &data.mSource[offset], lineLength, &data.mDepth[offset], 0);  break;
+				case Kernel::OPAQUE_WITH_DEPTH:	 functions.mBlendLineOpaqueWithDepth(&data.mOutput[offset], &data.mSource[offset], lineLength, &data.mDepth[offset], 0);  break;
+				case Kernel::PALETTE_LOOKUP:	 functions.mPaletteLookup(&data.mOutput[offset], &data.mIndices[offset], lineLength, &data.mPalette[0], data.mPalette.size());  break;
+			}
+		}
+	}
+
+	double measureKernel(Kernel kernel, const BlitterKernels::Functions& functions, TestData& data, int iterations)
+	{
+		HighResolutionTimer timer;
+		timer.start();
+		for (int k = 0; k < iterations; ++k)
+		{
+			// Blending into the same output again and again is fine, all that matters here is the amount of work
+			runKernel(kernel, functions, data);
+		}
+		return timer.getSecondsSinceStart();
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	const int iterations = (argc > 1) ? std::max((int)rmx::parseInteger(argv[1]), 1) : 200;
+
+	std::vector<BlitterKernels::InstructionSet> instructionSets;
+	for (size_t k = 0; k < (size_t)BlitterKernels::InstructionSet::_NUM; ++k)
+	{
+		const BlitterKernels::InstructionSet instructionSet = (BlitterKernels::InstructionSet)k;
+		if (BlitterKernels::isSupported(instructionSet))
+			instructionSets.push_back(instructionSet);
+	}
+	printf("Selected instruction set: %s\n", BlitterKernels::getInstructionSetName(BlitterKernels::get().mInstructionSet));
+	printf("%-16s %6s %-8s %12s %10s\n", "Kernel", "Width", "Variant", "MPixels/s", "Speedup");
+
+	bool success = true;
+	TestData data;
+	std::vector<uint32> expectedOutput;
+	for (Kernel kernel : { Kernel::ALPHA, Kernel::ALPHA_WITH_DEPTH, Kernel::OPAQUE_WITH_DEPTH, Kernel::PALETTE_LOOKUP })
+	{
+		for (size_t lineLength : LINE_LENGTHS)
+		{
+			data.setup(lineLength);
+			const double megaPixels = (double)(lineLength * NUM_LINES) * (double)iterations / 1000000.0;
+
+			double scalarSeconds = 0.0;
+			for (BlitterKernels::InstructionSet instructionSet : instructionSets)
+			{
+				const BlitterKernels::Functions& functions = BlitterKernels::getFunctions(instructionSet);
+
+				// Check results first
+				data.mOutput = data.mDestination;
+				runKernel(kernel, functions, data);
+				if (instructionSet == BlitterKernels::InstructionSet::SCALAR)
+				{
+					expectedOutput = data.mOutput;
+				}
+				else if (data.mOutput != expectedOutput)
+				{
+					printf("Error: Results of %s differ from the scalar implementation for kernel '%s' with width %d\n", BlitterKernels::getInstructionSetName(instructionSet), getKernelName(kernel), (int)lineLength);
+					success = false;
+				}
+
+				const double seconds = measureKernel(kernel, functions, data, iterations);
+				if (instructionSet == BlitterKernels::InstructionSet::SCALAR)
+					scalarSeconds = seconds;
+
+				const double speedup = (seconds > 0.0) ? scalarSeconds / seconds : 0.0;
+				printf("%-16s %6d %-8s %12.1f %9.2fx\n", getKernelName(kernel), (int)lineLength, BlitterKernels::getInstructionSetName(instructionSet), (seconds > 0.0) ? megaPixels / seconds : 0.0, speedup);
+			}
+		}
+	}
+	return success ? 0 : 1;
+}
@@ -74,10 +74,11 @@ public:
 	void processForwardedCommand(std::string_view command);
 	void processUrl(std::string_view url);
 
+	bool updateLoading();
+
 private:
 	int updateWindowDisplayIndex();
 	void setUnscaledWindow();
-	bool updateLoading();
 	void setPausedByFocusLoss(bool enable);
 
 	void checkActiveModsUsedFeatures();
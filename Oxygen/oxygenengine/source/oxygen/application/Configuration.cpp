@@ -478,6 +478,8 @@ void Configuration::loadConfigurationProperties(JsonSerializer& serializer)
 	serializer.serialize("Upscaling", mUpscaling);
 	serializer.serialize("BackgroundBlur", mBackgroundBlur);
 	serializer.serialize("PerformanceDisplay", mPerformanceDisplay);
+	serializer.serialize("SoftwareRendererThreads", mSoftwareRendererThreads);
+	serializer.serialize("PipelinedRendering", mPipelinedRendering);
 	tryReadRenderMethod(serializer, mFailSafeMode, mRenderMethod, mAutoDetectRenderMethod);
 
 	// Input recorder
@@ -495,6 +497,16 @@ void Configuration::loadConfigurationProperties(JsonSerializer& serializer)
 	// Script
 	serializer.serialize("CompileScripts", mForceCompileScripts);
 #endif
+
+	if (serializer.beginObject("ModScriptNativization"))
+	{
+		serializer.serialize("Enabled", mModScriptNativization.mEnabled);
+		serializer.serialize("Compiler", mModScriptNativization.mCompiler);
+		std::vector<std::string> includePaths;
+		if (serializer.serializeArray("IncludePaths", includePaths))
+			mModScriptNativization.mIncludePaths.swap(includePaths);
+		serializer.endObject();
+	}
 }
 
 void Configuration::serializeStandardSettings(JsonSerializer& serializer)
@@ -522,6 +534,8 @@ void Configuration::serializeStandardSettings(JsonSerializer& serializer)
 		serializer.serialize("MusicVolume", mAudio.mMusicVolume);
 		serializer.serialize("SoundVolume", mAudio.mSoundVolume);
 		serializer.serialize("SampleRate", mAudio.mSampleRate);
+		serializer.serialize("ResamplingQuality", mAudio.mResamplingQuality);
+		serializer.serialize("WorkerThreads", mAudio.mWorkerThreads);
 		serializer.endObject();
 	}
 	else if (serializer.isReading())
@@ -656,6 +670,13 @@ void Configuration::serializeStandardSettings(JsonSerializer& serializer)
 		serializer.serialize("ServerPortWSS", mGameServerBase.mServerPortWSS);
 		serializer.endObject();
 	}
+
+	// Netplay
+	if (serializer.beginObject("Netplay"))
+	{
+		serializer.serialize("RollbackWindow", mNetplay.mRollbackWindow);
+		serializer.endObject();
+	}
 }
 
 void Configuration::serializeDevMode(JsonSerializer& serializer)
@@ -51,6 +51,11 @@ public:
 		int mServerPortWSS = 21096;		// Used by the web version
 	};
 
+	struct Netplay
+	{
+		int mRollbackWindow = 8;		// Maximum number of frames to predict and roll back when hosting, 0 to use lockstep instead
+	};
+
 	struct ExternalCodeEditor
 	{
 		std::string mActiveType;			// Can be "custom", "vscode", "npp", or empty
@@ -83,7 +88,9 @@ public:
 		float mMusicVolume = 0.8f;
 		float mSoundVolume = 0.8f;
 		int   mSampleRate = 48000;
+		int   mResamplingQuality = 0;		// 0 = nearest sample (cheapest), 1 = polyphase filter (less aliasing with changed playback speeds)
 		bool  mUseAudioThreading = true;		// Disabled in constructor for platforms that don't support it
+		int   mWorkerThreads = 0;				// Maximum number of worker threads generating audio, 0 to choose depending on the number of CPU cores
 	};
 
 	struct ScreenFilter
@@ -101,6 +108,7 @@ public:
 		bool mEnablePlayback = false;
 		int mPlaybackStartFrame = 0;
 		bool mPlaybackIgnoreKeys = false;
+		std::wstring mPlaybackFilename;	// If empty, the default "gamerecording.bin" or "gamerec.bin" gets used
 	};
 
 	struct VirtualGamepad
@@ -183,6 +191,8 @@ public:
 	std::wstring mSaveStatesDirLocal;		// Save states dir in app data, specific for the game profile
 	std::wstring mAnalysisDir;
 	std::wstring mPersistentDataBasePath;
+	std::wstring mScriptCacheDir;			// Cache for compiled mod script modules
+	std::wstring mSpriteCacheDir;			// Cache for decoded sprite images
 
 	// General
 	bool   mFailSafeMode = false;
@@ -216,6 +226,8 @@ public:
 	int   mBackdrop = 0;
 	int   mBackgroundBlur = 0;
 	int   mPerformanceDisplay = 0;
+	int   mSoftwareRendererThreads = 1;		// Number of threads used by the software renderer, or -1 for automatic selection
+	bool  mPipelinedRendering = false;		// Software renderer only: render on a separate thread while the next frame gets simulated, adding one frame of latency
 
 	// Screen filter
 	ScreenFilter mScreenFilter;
@@ -240,6 +252,9 @@ public:
 	// Game server
 	GameServerBase mGameServerBase;
 
+	// Netplay
+	Netplay mNetplay;
+
 	// Internal
 	bool mForceCompileScripts = false;
 	int mScriptOptimizationLevel = -1;		// -1: Auto, 0: No optimization at all, up to 3: Full optimization
@@ -248,6 +263,13 @@ public:
 	bool mExitAfterScriptLoading = false;
 	int mRunScriptNativization = 0;			// 0: Disabled, 1: Run nativization, 2: Nativization done
 	std::wstring mScriptNativizationOutput;
+	struct ModScriptNativization
+	{
+		bool mEnabled = false;					// Nativize mod script modules at load time into cached shared libraries, only supported on Linux
+		std::string mCompiler = "c++";
+		std::vector<std::string> mIncludePaths = { "nativization/include", "../lemonscript/source", "../../librmx/source" };	// Relative paths are relative to the executable; the first is where installations ship the headers, the others are for the source tree
+	};
+	ModScriptNativization mModScriptNativization;
 	std::wstring mDumpCppDefinitionsOutput;
 
 	// Mod settings
@@ -12,6 +12,7 @@
 #include "oxygen/application/ArgumentsReader.h"
 #include "oxygen/application/Configuration.h"
 #include "oxygen/application/GameProfile.h"
+#include "oxygen/application/HeadlessRunner.h"
 #include "oxygen/application/audio/AudioOutBase.h"
 #include "oxygen/application/input/ControlsIn.h"
 #include "oxygen/application/input/InputManager.h"
@@ -116,8 +117,25 @@ void EngineMain::execute()
 	shutdown();
 }
 
+void EngineMain::executeHeadless(HeadlessRunner& headlessRunner)
+{
+	// Same as "execute", but without window, audio device, input devices and networking
+	mHeadless = true;
+	if (startupEngine())
+	{
+		RMX_LOG_INFO("");
+		RMX_LOG_INFO("--- HEADLESS RUN ---");
+		headlessRunner.run();
+	}
+
+	shutdown();
+}
+
 void EngineMain::onActiveModsChanged()
 {
+	// Pipelined rendering must not use any of the resources that get reloaded now
+	mInternal.mVideoOut.waitUntilRenderingIdle();
+
 	// Update sprites
 	RenderResources::instance().loadSprites(true);
 
@@ -286,11 +304,44 @@ bool EngineMain::startupEngine()
 	if (!initConfigAndSettings())
 		return false;
 
+	if (mHeadless)
+	{
+		// Headless runs always use the software renderer, and must not change any settings
+		config.mRenderMethod = Configuration::RenderMethod::SOFTWARE;
+		config.mFrameSync = Configuration::FrameSyncType::VSYNC_OFF;
+		config.setSettingsReadOnly(true);
+	}
+
 	// Setup file system
 	RMX_LOG_INFO("File system setup");
 	if (!initFileSystem())
 		return false;
 
+	// Audio sources get generated by the job manager's worker threads, use more than one if there's enough CPU cores
+	const int numAudioWorkerThreads = (config.mAudio.mWorkerThreads > 0) ? config.mAudio.mWorkerThreads : clamp(SDL_GetCPUCount() - 1, 1, 4);
+	FTX::JobManager->setMaxThreads(numAudioWorkerThreads);
+
+	if (mHeadless)
+	{
+		// No SDL video or audio subsystems and no window, just a software drawer for textures used by the game
+		RMX_LOG_INFO("Headless video initialization...");
+		mDrawer.createDrawer<SoftwareDrawer>();
+
+		RMX_LOG_INFO("Startup of VideoOut...");
+		mInternal.mVideoOut.startup();
+
+		RMX_LOG_INFO("Headless audio initialization...");
+		FTX::Audio->initializeWithoutDevice(config.mAudio.mSampleRate, 2, 1024);
+		FTX::Audio->setResamplingQuality((rmx::AudioManager::ResamplingQuality)clamp(config.mAudio.mResamplingQuality, 0, 1));
+
+		RMX_LOG_INFO("Startup of AudioOut");
+		mAudioOut = &EngineMain::getDelegate().createAudioOut();
+		mAudioOut->startup();
+
+		RMX_LOG_INFO("Engine startup successful");
+		return true;
+	}
+
 	// System
 	RMX_LOG_INFO("System initialization...");
 	if (!FTX::System->initialize())
@@ -320,6 +371,7 @@ bool EngineMain::startupEngine()
 	// Audio
 	RMX_LOG_INFO("Audio initialization...");
 	FTX::Audio->initialize(config.mAudio.mSampleRate, 2, 1024);
+	FTX::Audio->setResamplingQuality((rmx::AudioManager::ResamplingQuality)clamp(config.mAudio.mResamplingQuality, 0, 1));
 
 	RMX_LOG_INFO("Startup of AudioOut");
 	mAudioOut = &EngineMain::getDelegate().createAudioOut();
@@ -351,6 +403,25 @@ void EngineMain::run()
 
 void EngineMain::shutdown()
 {
+	if (mHeadless)
+	{
+		// Only a subset of subsystems got started in the first place
+		mInternal.mVideoOut.destroyRenderer();
+		mDrawer.destroyDrawer();
+		mInternal.mVideoOut.shutdown();
+		if (nullptr != mAudioOut)
+		{
+			mAudioOut->shutdown();
+			SAFE_DELETE(mAudioOut);
+		}
+		mDrawer.shutdown();
+
+		FTX::Audio->exit();
+		FTX::JobManager->~JobManager();
+		oxygen::Logging::shutdown();
+		return;
+	}
+
 	mInternal.mCommandForwarder.shutdown();
 
 	destroyWindow();
@@ -563,6 +634,8 @@ void EngineMain::updateGameProfilePaths()
 	// Update dependent paths
 	config.mSaveStatesDirLocal = config.mGameAppDataPath + L"savestates/";
 	config.mPersistentDataBasePath = config.mGameAppDataPath + L"storage/";
+	config.mScriptCacheDir = config.mGameAppDataPath + L"cache/scripts/";
+	config.mSpriteCacheDir = config.mGameAppDataPath + L"cache/sprites/";
 }
 
 bool EngineMain::initFileSystem()
@@ -16,6 +16,7 @@ class AudioOutBase;
 class CodeExec;
 class Configuration;
 class EmulatorInterface;
+class HeadlessRunner;
 class LogDisplay;
 class PackedFileProvider;
 
@@ -91,6 +92,9 @@ public:
 	~EngineMain();
 
 	void execute();
+	void executeHeadless(HeadlessRunner& headlessRunner);
+
+	inline bool isHeadless() const  { return mHeadless; }
 
 	void onActiveModsChanged();
 	bool reloadFilePackage(std::wstring_view packageName, bool forceReload);
@@ -133,4 +137,5 @@ private:
 	SDL_Window*	  mSDLWindow = nullptr;
 	Drawer		  mDrawer;
 	std::vector<PackedFileProvider*> mPackedFileProviders;
+	bool		  mHeadless = false;		// Set when running without window and audio device, see "executeHeadless"
 };
@@ -0,0 +1,130 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "oxygen/pch.h"
+#include "oxygen/application/HeadlessRunner.h"
+#include "oxygen/application/Application.h"
+#include "oxygen/application/Configuration.h"
+#include "oxygen/application/EngineMain.h"
+#include "oxygen/application/GameLoader.h"
+#include "oxygen/application/audio/AudioOutBase.h"
+#include "oxygen/application/video/VideoOut.h"
+#include "oxygen/helper/HighResolutionTimer.h"
+#include "oxygen/helper/Logging.h"
+#include "oxygen/helper/Profiling.h"
+#include "oxygen/simulation/CodeExec.h"
+#include "oxygen/simulation/GameRecorder.h"
+#include "oxygen/simulation/Simulation.h"
+
+
+namespace
+{
+	double getLastFrameTime(uint16 regionId)
+	{
+		const Profiling::Region* region = Profiling::getRegion(regionId);
+		return (nullptr == region || region->mFrameTimes.empty()) ? 0.0 : region->mFrameTimes.back().mInclusiveTime;
+	}
+}
+
+
+void HeadlessRunner::run()
+{
+	mResults = Results();
+
+	// Setup configuration for a deterministic playback
+	//  -> Keyframes in the recording get ignored, so that every single frame is actually simulated
+	//  -> Dev mode is disabled, as it would add keyframe recording during playback
+	Configuration& config = Configuration::instance();
+	config.mDevMode.mEnabled = false;
+	config.mStartPhase = 3;
+	config.mGameRecorder.mRecordingMode = 0;
+	config.mGameRecorder.mEnablePlayback = true;
+	config.mGameRecorder.mPlaybackStartFrame = (int)mOptions.mStartFrame;
+	config.mGameRecorder.mPlaybackIgnoreKeys = true;
+	config.mGameRecorder.mPlaybackFilename = mOptions.mRecordingFilename;
+	config.mSoftwareRendererThreads = mOptions.mRenderThreads;
+	config.mPipelinedRendering = mOptions.mPipelinedRendering;
+
+	// The application instance is needed for its simulation and as parent of the game app, but it never gets updated or rendered here
+	Application application;
+	application.initialize();
+
+	RMX_LOG_INFO("Headless runner: Loading game");
+	if (!application.updateLoading() || GameLoader::instance().isLoading())
+	{
+		RMX_LOG_ERROR("Headless runner: Failed to load the game");
+		return;
+	}
+
+	Simulation& simulation = application.getSimulation();
+	GameRecorder& gameRecorder = simulation.getGameRecorder();
+	if (!gameRecorder.hasFrameNumber(mOptions.mStartFrame))
+	{
+		RMX_LOG_ERROR("Headless runner: Game recording '" << WString(mOptions.mRecordingFilename).toStdString() << "' could not be loaded or does not contain frame " << mOptions.mStartFrame);
+		application.deinitialize();
+		return;
+	}
+
+	uint32 endFrame = gameRecorder.getRangeEnd() - 1;
+	if (mOptions.mMaxFrames > 0)
+		endFrame = std::min(endFrame, simulation.getFrameNumber() + mOptions.mMaxFrames);
+
+	const float frameSeconds = 1.0f / simulation.getSimulationFrequency();
+	const int samplesPerFrame = (int)std::ceil((float)FTX::Audio->getOutputFrequency() * frameSeconds);
+	std::vector<int16> audioBuffer((size_t)samplesPerFrame * 2);
+
+	AudioOutBase& audioOut = EngineMain::instance().getAudioOut();
+	VideoOut& videoOut = VideoOut::instance();
+
+	RMX_LOG_INFO("Headless runner: Playback from frame " << simulation.getFrameNumber() << " to " << endFrame);
+	simulation.setRunning(true);
+	Profiling::nextFrame(simulation.getFrameNumber());
+
+	HighResolutionTimer timer;
+	timer.start();
+
+	while (simulation.getFrameNumber() < endFrame)
+	{
+		Profiling::pushRegion(ProfilingRegion::SIMULATION);
+		const bool completedFrame = simulation.generateFrame();
+		Profiling::popRegion(ProfilingRegion::SIMULATION);
+
+		if (mOptions.mMixAudio)
+		{
+			Profiling::pushRegion(ProfilingRegion::AUDIO);
+			audioOut.realtimeUpdate(frameSeconds);
+			FTX::Audio->mixAudioWithoutDevice((uint8*)audioBuffer.data(), samplesPerFrame * 2 * sizeof(int16));
+			Profiling::popRegion(ProfilingRegion::AUDIO);
+		}
+
+		if (mOptions.mRenderFrames)
+		{
+			Profiling::pushRegion(ProfilingRegion::RENDERING);
+			videoOut.updateGameScreen();
+			Profiling::popRegion(ProfilingRegion::RENDERING);
+		}
+
+		Profiling::nextFrame(simulation.getFrameNumber());
+		mResults.mSimulationSeconds += getLastFrameTime(ProfilingRegion::SIMULATION);
+		mResults.mAudioSeconds += getLastFrameTime(ProfilingRegion::AUDIO);
+		mResults.mRenderingSeconds += getLastFrameTime(ProfilingRegion::RENDERING);
+		++mResults.mSimulatedFrames;
+
+		if (!completedFrame && !simulation.getCodeExec().isCodeExecutionPossible())
+		{
+			RMX_LOG_ERROR("Headless runner: Code execution stopped at frame " << simulation.getFrameNumber());
+			break;
+		}
+	}
+
+	mResults.mTotalSeconds = timer.getSecondsSinceStart();
+	mResults.mSuccess = (simulation.getFrameNumber() >= endFrame);
+	RMX_LOG_INFO("Headless runner: Simulated " << mResults.mSimulatedFrames << " frames in " << mResults.mTotalSeconds << " seconds");
+
+	application.deinitialize();
+}
@@ -0,0 +1,52 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+#include <rmxbase.h>
+
+
+// Plays back a game recording as fast as possible, without window or audio device
+//  -> Meant to be used with "EngineMain::executeHeadless", e.g. for benchmarking
+class HeadlessRunner
+{
+public:
+	struct Options
+	{
+		std::wstring mRecordingFilename;
+		uint32 mStartFrame = 0;
+		uint32 mMaxFrames = 0;		// 0 for playback until the end of the recording
+		bool mRenderFrames = true;	// Render each frame with the software renderer
+		bool mMixAudio = true;		// Update audio playback and mix one frame's worth of audio samples
+		int mRenderThreads = 1;		// Number of threads for the software renderer, -1 for automatic selection
+		bool mPipelinedRendering = false;	// Render on a separate thread while the next frame gets simulated
+	};
+
+	struct Results
+	{
+		bool   mSuccess = false;
+		uint32 mSimulatedFrames = 0;
+		double mTotalSeconds = 0.0;
+		double mSimulationSeconds = 0.0;
+		double mAudioSeconds = 0.0;
+		double mRenderingSeconds = 0.0;
+
+		inline double getFramesPerSecond() const  { return (mTotalSeconds > 0.0) ? (double)mSimulatedFrames / mTotalSeconds : 0.0; }
+	};
+
+public:
+	explicit HeadlessRunner(const Options& options) : mOptions(options) {}
+
+	void run();
+
+	inline const Results& getResults() const  { return mResults; }
+
+private:
+	Options mOptions;
+	Results mResults;
+};
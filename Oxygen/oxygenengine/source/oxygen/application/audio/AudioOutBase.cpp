@@ -126,11 +126,17 @@ bool AudioOutBase::isPlayingAudioKey(uint64 audioKey) const
 
 bool AudioOutBase::playAudioBase(uint64 audioKey, uint8 contextId)
 {
+	if (mPlaybackSuppressed)
+		return (nullptr != mAudioCollection.getSourceRegistration(audioKey));
+
 	return mAudioPlayer.playAudio(audioKey, contextId);
 }
 
 void AudioOutBase::playOverride(uint64 audioKey, uint8 contextId, uint8 channelId, uint8 overriddenChannelId)
 {
+	if (mPlaybackSuppressed)
+		return;
+
 	mAudioPlayer.playOverride(audioKey, contextId, channelId, overriddenChannelId);
 }
 
@@ -65,6 +65,10 @@ public:
 	std::string_view getAudioKeyDisplayName(uint64 audioKey) const;
 	bool isPlayingAudioKey(uint64 audioKey) const;
 
+	// While suppressed, scripts can't start any new audio playback; used when re-simulating frames whose audio got played already
+	inline bool isPlaybackSuppressed() const  { return mPlaybackSuppressed; }
+	inline void setPlaybackSuppressed(bool suppress)  { mPlaybackSuppressed = suppress; }
+
 	bool playAudioBase(uint64 audioKey, uint8 contextId);
 	void playOverride(uint64 audioKey, uint8 contextId, uint8 channelId, uint8 overriddenChannelId);
 
@@ -89,4 +93,6 @@ protected:
 	float mGlobalVolume = 1.0f;
 	float mMusicVolume = 1.0f;
 	float mSoundVolume = 1.0f;
+
+	bool mPlaybackSuppressed = false;
 };
@@ -22,9 +22,7 @@ AudioSourceBase::~AudioSourceBase()
 	RMX_ASSERT(!isJobRegistered(), "Job still registered, even though it should have been removed in 'shutdown'");
 	SDL_DestroyMutex(mMutex);
 
-	mAudioBuffer.lock();
 	mAudioBuffer.clear();
-	mAudioBuffer.unlock();
 }
 
 AudioBuffer* AudioSourceBase::startup()
@@ -54,6 +52,17 @@ void AudioSourceBase::progress(float precacheTime)
 	}
 }
 
+AudioSourceBase::EmulationScratchBuffers& AudioSourceBase::getEmulationScratchBuffers()
+{
+	// Allocated on first use, as these are too large to be placed in thread-local storage directly
+	static thread_local std::unique_ptr<EmulationScratchBuffers> scratchBuffers;
+	if (!scratchBuffers)
+	{
+		scratchBuffers = std::make_unique<EmulationScratchBuffers>();
+	}
+	return *scratchBuffers;
+}
+
 bool AudioSourceBase::checkForUnload(float timestamp)
 {
 	bool mayUnload = false;
@@ -104,9 +113,7 @@ bool AudioSourceBase::checkForUnload(float timestamp)
 		}
 
 		SDL_LockMutex(mMutex);
-		mAudioBuffer.lock();
 		mAudioBuffer.clear();
-		mAudioBuffer.unlock();
 		mState = State::INACTIVE;
 		mReadTime = 0.0f;
 
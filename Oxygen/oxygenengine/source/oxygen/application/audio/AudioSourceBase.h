@@ -65,7 +65,16 @@ protected:
 		COMPLETED,	// Streaming completely done
 	};
 
+	// Scratch buffers for sound chip emulation output, with a separate instance for each thread, so that multiple worker threads can generate audio in parallel
+	struct EmulationScratchBuffers
+	{
+		int16 mSoundBuffer[0x10000];
+		int16 mPCM[2][0x10000];
+	};
+
 protected:
+	static EmulationScratchBuffers& getEmulationScratchBuffers();
+
 	virtual void resetInternal() = 0;
 	virtual State startupInternal() = 0;
 	virtual void progressInternal(float targetTime) = 0;
@@ -98,9 +98,7 @@ AudioSourceBase::State ChipWritesAudioSource::startupInternal()
 	}
 
 	SDL_LockMutex(mMutex);
-	mAudioBuffer.lock();
 	mAudioBuffer.clear(Configuration::instance().mAudio.mSampleRate, 2);
-	mAudioBuffer.unlock();
 
 	mSoundEmulation.init(Configuration::instance().mAudio.mSampleRate, 60.0);
 	SDL_UnlockMutex(mMutex);
@@ -150,7 +148,8 @@ bool ChipWritesAudioSource::jobFunc()
 		const std::vector<SoundChipWrite>& writes = isPlaying ? mSoundChipWritesByFrame[mCurrentFrame] : EMPTY_LIST;
 		++mCurrentFrame;
 
-		static int16 soundBuffer[0x10000];
+		EmulationScratchBuffers& scratchBuffers = getEmulationScratchBuffers();
+		int16* soundBuffer = scratchBuffers.mSoundBuffer;
 		const uint32 length = mSoundEmulation.update(soundBuffer, writes);	// Returns length in samples
 
 		if (!isPlaying)
@@ -168,17 +167,13 @@ bool ChipWritesAudioSource::jobFunc()
 
 		if (isPlaying)
 		{
-			static int16 pcm[2][0x10000];
-			int16* pcmPtr[2] = { pcm[0], pcm[1] };
-
+			int16* pcmPtr[2] = { scratchBuffers.mPCM[0], scratchBuffers.mPCM[1] };
 			for (uint32 i = 0; i < length; ++i)
 			{
-				pcm[0][i] = soundBuffer[i*2];
-				pcm[1][i] = soundBuffer[i*2+1];
+				pcmPtr[0][i] = soundBuffer[i*2];
+				pcmPtr[1][i] = soundBuffer[i*2+1];
 			}
-			mAudioBuffer.lock();
 			mAudioBuffer.addData(pcmPtr, length);
-			mAudioBuffer.unlock();
 		}
 		else
 		{
@@ -102,9 +102,7 @@ AudioSourceBase::State EmulationAudioSource::startupInternal()
 	}
 
 	SDL_LockMutex(mMutex);
-	mAudioBuffer.lock();
 	mAudioBuffer.clear(Configuration::instance().mAudio.mSampleRate, 2);
-	mAudioBuffer.unlock();
 
 	mSoundEmulation.init(Configuration::instance().mAudio.mSampleRate, 60.0);
 	mSoundDriver.reset();
@@ -154,7 +152,8 @@ bool EmulationAudioSource::jobFunc()
 		const std::vector<SoundChipWrite>& writes = mSoundDriver.getSoundChipWrites();
 		bool isPlaying = (updateResult == SoundDriver::UpdateResult::CONTINUE);
 
-		static int16 soundBuffer[0x10000];
+		EmulationScratchBuffers& scratchBuffers = getEmulationScratchBuffers();
+		int16* soundBuffer = scratchBuffers.mSoundBuffer;
 		const uint32 length = mSoundEmulation.update(soundBuffer, writes);	// Returns length in samples
 
 		if (updateResult == SoundDriver::UpdateResult::FINISHED)
@@ -172,17 +171,13 @@ bool EmulationAudioSource::jobFunc()
 
 		if (isPlaying)
 		{
-			static int16 pcm[2][0x10000];
-			int16* pcmPtr[2] = { pcm[0], pcm[1] };
-
+			int16* pcmPtr[2] = { scratchBuffers.mPCM[0], scratchBuffers.mPCM[1] };
 			for (uint32 i = 0; i < length; ++i)
 			{
-				pcm[0][i] = soundBuffer[i*2];
-				pcm[1][i] = soundBuffer[i*2+1];
+				pcmPtr[0][i] = soundBuffer[i*2];
+				pcmPtr[1][i] = soundBuffer[i*2+1];
 			}
-			mAudioBuffer.lock();
 			mAudioBuffer.addData(pcmPtr, length);
-			mAudioBuffer.unlock();
 		}
 		else
 		{
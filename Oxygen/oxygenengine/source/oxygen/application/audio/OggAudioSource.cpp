@@ -78,16 +78,14 @@ void OggAudioSource::onPlaybackStart(AudioReference& audioRef, float time)
 		audioRef.setLoop(false);
 
 		// Always start with an empty audio buffer, it will get filled now
-		mAudioBuffer.lock();
 		mAudioBuffer.clear(mAudioBuffer.getFrequency());
-		mAudioBuffer.unlock();
 		mReadTime = 0.0f;
 
 		// Perform seeking if needed
 		if (time >= 0.0f)
 		{
 			mOggLoader->seek(time);
-			mInitialSeekPos = roundToInt(time * mAudioBuffer.getFrequency());
+			mInitialSeekPos = (int64)std::round((double)time * mAudioBuffer.getFrequency());
 		}
 	}
 
@@ -103,21 +101,21 @@ float OggAudioSource::mapAudioRefPositionToTrackPosition(float audioRefPosition)
 	}
 
 	// Account for the difference in audio ref position (i.e. position inside the audio buffer) and absolute position inside the audio track
-	const float frequency = (float)mAudioBuffer.getFrequency();
-	int trackPosition = mInitialSeekPos + roundToInt(audioRefPosition * frequency);
+	const double frequency = (double)mAudioBuffer.getFrequency();
+	int64 trackPosition = mInitialSeekPos + (int64)std::round((double)audioRefPosition * frequency);
 
 	// If track length is not known, we certainly did not loop yet, and it's very unlikely to get an input value after the track length
 	const bool afterFirstLoop = (mTrackLength > 0 && trackPosition >= mTrackLength);
 	if (afterFirstLoop)
 	{
 		// Otherwise normalize track position into the looping range
-		const int loopingPartLength = mTrackLength - mLoopStart;
+		const int64 loopingPartLength = mTrackLength - mLoopStart;
 		if (loopingPartLength > 0)
 		{
 			trackPosition = mLoopStart + (trackPosition - mLoopStart) % loopingPartLength;
 		}
 	}
-	return (float)trackPosition / frequency;
+	return (float)((double)trackPosition / frequency);
 }
 
 void OggAudioSource::resetInternal()
@@ -149,9 +147,7 @@ AudioSourceBase::State OggAudioSource::startupInternal()
 	{
 		mOggLoader = new OggLoader();
 	}
-	mAudioBuffer.lock();
 	const bool success = mOggLoader->startVorbisStreaming(mAudioBuffer, mInputStream);
-	mAudioBuffer.unlock();
 	SDL_UnlockMutex(mMutex);
 
 	return success ? State::STREAMING : State::COMPLETED;
@@ -233,11 +229,9 @@ bool OggAudioSource::jobFunc()
 
 void OggAudioSource::updateStreaming(float targetTime)
 {
-	mAudioBuffer.lock();
 	while (mAudioBuffer.getLengthInSec() < targetTime)
 	{
 		if (!mOggLoader->updateStreaming())
 			break;
 	}
-	mAudioBuffer.unlock();
 }
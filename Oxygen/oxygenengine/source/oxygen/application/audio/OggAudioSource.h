@@ -44,8 +44,8 @@ private:
 	bool mIsLooping = false;
 	int mLoopStart = -1;		// In samples
 
-	int mTrackLength = -1;		// In samples - but it's only set if looped back at least once
-	int mInitialSeekPos = 0;	// In samples, start position of initial seek (zero if playback started at the beginning)
+	int64 mTrackLength = -1;	// In samples - but it's only set if looped back at least once
+	int64 mInitialSeekPos = 0;	// In samples, start position of initial seek (zero if playback started at the beginning)
 
 	float mPrecacheTime = 0.0f;
 };
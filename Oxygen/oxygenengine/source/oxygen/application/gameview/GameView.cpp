@@ -266,6 +266,7 @@ void GameView::keyboard(const rmx::KeyboardEvent& ev)
 						{
 							HighResolutionTimer timer;
 							timer.start();
+							VideoOut::instance().waitUntilRenderingIdle();
 							EngineMain::instance().getAudioOut().reloadAudioCollection();
 							RenderResources::instance().loadSprites();
 							ResourcesCache::instance().loadAllResources();
@@ -825,9 +825,9 @@ void DebugSidePanel::buildInternalCategoryContent(DebugSidePanelCategory& catego
 						break;
 					}
 
-					case Geometry::Type::TEXTURED_RECT:
+					case Geometry::Type::TEXT:
 					{
-						builder.addLine(*String(0, "0x%04x:   Textured rect / Text", geometry->mRenderQueue), Color::fromABGR32(0xffc0ffff));
+						builder.addLine(*String(0, "0x%04x:   Text", geometry->mRenderQueue), Color::fromABGR32(0xffc0ffff));
 						break;
 					}
 
@@ -0,0 +1,109 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "oxygen/pch.h"
+#include "oxygen/application/video/RenderThread.h"
+#include "oxygen/rendering/Geometry.h"
+#include "oxygen/rendering/parts/RenderParts.h"
+#include "oxygen/rendering/software/SoftwareRenderer.h"
+
+
+RenderThread::RenderThread(const Vec2i& gameResolution)
+{
+	mSnapshotRenderParts = RenderParts::createSnapshotInstance();
+
+	mSoftwareRenderer = new SoftwareRenderer(*mSnapshotRenderParts, mRenderTexture);
+	mSoftwareRenderer->initialize();
+	setGameResolution(gameResolution);
+
+	mThread = std::thread(&RenderThread::runThread, this);
+}
+
+RenderThread::~RenderThread()
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mShutdown = true;
+	}
+	mWakeCondition.notify_all();
+	mThread.join();
+
+	delete mSoftwareRenderer;
+	delete mSnapshotRenderParts;
+}
+
+void RenderThread::setGameResolution(const Vec2i& gameResolution)
+{
+	waitUntilIdle();
+	mGameResolution = gameResolution;
+	mSoftwareRenderer->setGameResolution(gameResolution);
+}
+
+void RenderThread::startRendering(const std::vector<Geometry*>& geometries)
+{
+	waitUntilIdle();
+
+	// The bitmap might be a different one than last time, after it got swapped with the output texture's one
+	Bitmap& bitmap = mRenderTexture.accessBitmap();
+	if (bitmap.getSize() != mGameResolution)
+		bitmap.create(mGameResolution.x, mGameResolution.y);
+
+	// Anything that gets created lazily has to be there already, as the main thread might access it as well
+	SoftwareRenderer::prepareLazySpriteData(geometries);
+
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mGeometries = &geometries;
+		mState = State::RENDERING;
+	}
+	mWakeCondition.notify_one();
+}
+
+bool RenderThread::finishRendering(DrawerTexture& outputTexture)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mDoneCondition.wait(lock, [this] { return mState != State::RENDERING; });
+		if (mState != State::FINISHED)
+			return false;
+		mState = State::IDLE;
+	}
+
+	// Texture updates have to be done on the main thread
+	outputTexture.accessBitmap().swap(mRenderTexture.accessBitmap());
+	outputTexture.bitmapUpdated();
+	return true;
+}
+
+void RenderThread::waitUntilIdle()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDoneCondition.wait(lock, [this] { return mState != State::RENDERING; });
+}
+
+void RenderThread::runThread()
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWakeCondition.wait(lock, [this] { return mShutdown || mState == State::RENDERING; });
+			if (mShutdown)
+				return;
+		}
+
+		mSoftwareRenderer->renderGameScreenToBitmap(*mGeometries);
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mState = State::FINISHED;
+			mGeometries = nullptr;
+		}
+		mDoneCondition.notify_all();
+	}
+}
@@ -0,0 +1,66 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+#include "oxygen/drawing/DrawerTexture.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class Geometry;
+class RenderParts;
+class SoftwareRenderer;
+
+
+// Renders the game screen with the software renderer on a separate thread, while the next frame gets simulated already
+//  -> Rendering uses a snapshot of the render parts, so the simulation can freely change the original ones in the meantime
+//  -> The rendered image gets shown one update later, so this adds one frame of latency
+class RenderThread
+{
+public:
+	RenderThread(const Vec2i& gameResolution);
+	~RenderThread();
+
+	inline RenderParts& getSnapshotRenderParts()  { return *mSnapshotRenderParts; }
+
+	void setGameResolution(const Vec2i& gameResolution);
+
+	// Starts rendering of the given geometries, which must be built from the snapshot render parts and stay unchanged until rendering is finished
+	void startRendering(const std::vector<Geometry*>& geometries);
+
+	// Waits until rendering is done, then moves the rendered image into the output texture; returns false if there was no image to show
+	bool finishRendering(DrawerTexture& outputTexture);
+
+	void waitUntilIdle();
+
+private:
+	enum class State
+	{
+		IDLE,		// Nothing to do
+		RENDERING,	// Currently rendering
+		FINISHED	// Rendered image is waiting to be shown
+	};
+
+private:
+	void runThread();
+
+private:
+	RenderParts* mSnapshotRenderParts = nullptr;
+	DrawerTexture mRenderTexture;		// Only its bitmap is used, it never gets an implementation of its own
+	SoftwareRenderer* mSoftwareRenderer = nullptr;
+	Vec2i mGameResolution;
+
+	std::thread mThread;
+	std::mutex mMutex;
+	std::condition_variable mWakeCondition;
+	std::condition_variable mDoneCondition;
+	State mState = State::IDLE;
+	bool mShutdown = false;
+	const std::vector<Geometry*>* mGeometries = nullptr;
+};
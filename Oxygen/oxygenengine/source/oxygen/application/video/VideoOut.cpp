@@ -8,6 +8,7 @@
 
 #include "oxygen/pch.h"
 #include "oxygen/application/video/VideoOut.h"
+#include "oxygen/application/video/RenderThread.h"
 #include "oxygen/application/Configuration.h"
 #include "oxygen/application/EngineMain.h"
 #include "oxygen/drawing/opengl/OpenGLDrawer.h"
@@ -31,6 +32,7 @@ VideoOut::VideoOut() :
 
 VideoOut::~VideoOut()
 {
+	delete mRenderThread;
 	delete mRenderParts;
 	delete &mRenderResources;
 	delete mSoftwareRenderer;
@@ -57,11 +59,14 @@ void VideoOut::startup()
 
 void VideoOut::shutdown()
 {
+	SAFE_DELETE(mRenderThread);
 	clearGeometries();
 }
 
 void VideoOut::reset()
 {
+	waitUntilRenderingIdle();
+
 	mRenderParts->reset();
 	mActiveRenderer->reset();
 
@@ -77,6 +82,13 @@ void VideoOut::handleActiveModsChanged()
 	reset();
 }
 
+void VideoOut::waitUntilRenderingIdle()
+{
+	// The frame being rendered references sprites, fonts and glyph atlas pages directly
+	if (nullptr != mRenderThread)
+		mRenderThread->waitUntilIdle();
+}
+
 void VideoOut::createRenderer(bool reset)
 {
 	setActiveRenderer(Configuration::instance().mRenderMethod == Configuration::RenderMethod::OPENGL_FULL, reset);
@@ -84,6 +96,7 @@ void VideoOut::createRenderer(bool reset)
 
 void VideoOut::destroyRenderer()
 {
+	SAFE_DELETE(mRenderThread);
 	SAFE_DELETE(mSoftwareRenderer);
 #ifdef RMX_WITH_OPENGL_SUPPORT
 	SAFE_DELETE(mOpenGLRenderer);
@@ -134,6 +147,8 @@ void VideoOut::setScreenSize(uint32 width, uint32 height)
 	mGameScreenTexture.setupAsRenderTarget(mGameResolution);
 
 	mActiveRenderer->setGameResolution(mGameResolution);
+	if (nullptr != mRenderThread)
+		mRenderThread->setGameResolution(mGameResolution);
 
 	// Render game screen again (this is particularly needed when switching from in-game Options back to the Pause Menu)
 	mRequireGameScreenUpdate = true;
@@ -201,6 +216,10 @@ bool VideoOut::updateGameScreen()
 	const bool hasNewSimulationFrame = (mFrameState == FrameState::FRAME_READY);
 	if (!hasNewSimulationFrame && !mFrameInterpolation.mCurrentlyInterpolating && !mDebugDrawRenderingRequested && !mRequireGameScreenUpdate)
 	{
+		// With pipelined rendering, the last frame might not have been shown yet
+		if (nullptr != mRenderThread && usePipelinedRendering() && mRenderThread->finishRendering(mGameScreenTexture))
+			return true;
+
 		// No update
 		return false;
 	}
@@ -260,16 +279,14 @@ void VideoOut::clearGeometries()
 		mGeometryFactory.destroy(*geometry);
 	}
 	mGeometries.clear();
-
-	// Regularly cleanup old cache items -- it's safe now that no geometry references a texture in there any more
-	RenderResources::instance().mPrintedTextCache.regularCleanup();
+	mGeometryFactory.clearGlyphQuads();
 }
 
-void VideoOut::collectGeometries(std::vector<Geometry*>& geometries)
+void VideoOut::collectGeometries(RenderParts& renderParts, std::vector<Geometry*>& geometries)
 {
 	// Add plane geometries
 	{
-		const PlaneManager& pm = mRenderParts->getPlaneManager();
+		const PlaneManager& pm = renderParts.getPlaneManager();
 		const Recti fullscreenRect(0, 0, mGameResolution.x, mGameResolution.y);
 
 		static std::vector<PlaneManager::PlaneRect> planeRects;
@@ -287,7 +304,7 @@ void VideoOut::collectGeometries(std::vector<Geometry*>& geometries)
 				const int layerIndex = (isPlaneB ? 0 : 1) + (priorityFlag ? 4 : 0);
 				const int defaultPlaneIndex = (isPlaneB ? 0 : 1) + (priorityFlag ? 2 : 0);
 
-				if (mRenderParts->mLayerRendering[layerIndex] && pm.isDefaultPlaneEnabled(defaultPlaneIndex))
+				if (renderParts.mLayerRendering[layerIndex] && pm.isDefaultPlaneEnabled(defaultPlaneIndex))
 				{
 					uint8 scrollOffsets = (uint8)planeRect.mPlane;
 					int renderQueue;
@@ -316,8 +333,8 @@ void VideoOut::collectGeometries(std::vector<Geometry*>& geometries)
 
 	// Add render item geometries (sprites, texts, etc.)
 	{
-		SpriteManager& spriteManager = mRenderParts->getSpriteManager();
-		const Vec2i worldSpaceOffset = mRenderParts->getSpacesManager().getWorldSpaceOffset();
+		SpriteManager& spriteManager = renderParts.getSpriteManager();
+		const Vec2i worldSpaceOffset = renderParts.getSpacesManager().getWorldSpaceOffset();
 		FontCollection& fontCollection = FontCollection::instance();
 
 		for (int index = 0; index < RenderItem::NUM_LIFETIME_CONTEXTS; ++index)
@@ -336,7 +353,7 @@ void VideoOut::collectGeometries(std::vector<Geometry*>& geometries)
 						Color color = rectangle.mColor;
 						if (rectangle.mUseGlobalComponentTint)
 						{
-							mRenderParts->getPaletteManager().applyGlobalComponentTint(color);
+							renderParts.getPaletteManager().applyGlobalComponentTint(color);
 						}
 
 						Geometry& geometry = mGeometryFactory.createRectGeometry(Recti(rectangle.mPosition, rectangle.mSize), color);
@@ -356,24 +373,21 @@ void VideoOut::collectGeometries(std::vector<Geometry*>& geometries)
 						}
 						if (nullptr != font)
 						{
-							const PrintedTextCache::Key key(text.mFontKeyHash, text.mTextHash, (uint8)text.mSpacing);
-							PrintedTextCache& cache = RenderResources::instance().mPrintedTextCache;
-							PrintedTextCache::CacheItem* cacheItem = cache.getCacheItem(key);
-							if (nullptr == cacheItem)
-							{
-								cacheItem = &cache.addCacheItem(key, *font, text.mTextString);
-							}
-							const Vec2i drawPosition = Font::applyAlignment(Recti(text.mPosition, Vec2i(0, 0)), cacheItem->mInnerRect, text.mAlignment);
-							const Recti rect(drawPosition, cacheItem->mTexture.getSize());
+							// Text gets drawn as a batch of glyph quads, all referencing the font's glyph atlas
+							std::vector<GlyphAtlas::GlyphQuad>& glyphQuads = mGeometryFactory.getGlyphQuads();
+							const size_t firstGlyphQuad = glyphQuads.size();
+							DrawerTexture* atlasTexture = RenderResources::instance().mGlyphAtlas.buildGlyphQuads(glyphQuads, text.mFontKeyHash, *font, text.mTextString, text.mSpacing, text.mPosition, text.mAlignment);
+							if (nullptr == atlasTexture || glyphQuads.size() == firstGlyphQuad)
+								break;
 
 							Color tintColor = text.mColor;
 							Color addedColor = Color::TRANSPARENT;
 							if (text.mUseGlobalComponentTint)
 							{
-								mRenderParts->getPaletteManager().applyGlobalComponentTint(tintColor, addedColor);
+								renderParts.getPaletteManager().applyGlobalComponentTint(tintColor, addedColor);
 							}
 
-							Geometry& geometry = mGeometryFactory.createTexturedRectGeometry(rect, cacheItem->mTexture, tintColor, addedColor);
+							Geometry& geometry = mGeometryFactory.createTextGeometry(*atlasTexture, firstGlyphQuad, tintColor, addedColor);
 							geometry.mRenderQueue = text.mRenderQueue;
 							geometries.push_back(&geometry);
 						}
@@ -391,14 +405,14 @@ void VideoOut::collectGeometries(std::vector<Geometry*>& geometries)
 						{
 							case RenderItem::Type::VDP_SPRITE:
 							{
-								accept = (mRenderParts->mLayerRendering[sprite.mPriorityFlag ? 6 : 2]);
+								accept = (renderParts.mLayerRendering[sprite.mPriorityFlag ? 6 : 2]);
 								break;
 							}
 
 							case RenderItem::Type::PALETTE_SPRITE:
 							case RenderItem::Type::COMPONENT_SPRITE:
 							{
-								accept = (mRenderParts->mLayerRendering[sprite.mPriorityFlag ? 7 : 3]);
+								accept = (renderParts.mLayerRendering[sprite.mPriorityFlag ? 7 : 3]);
 								break;
 							}
 
@@ -488,13 +502,49 @@ void VideoOut::collectGeometries(std::vector<Geometry*>& geometries)
 					 [](const Geometry* a, const Geometry* b) { return a->mRenderQueue < b->mRenderQueue; });
 }
 
+bool VideoOut::usePipelinedRendering() const
+{
+#if defined(PLATFORM_WEB)
+	return false;
+#else
+	// Only the software renderer supports this, as OpenGL rendering has to stay on the main thread
+	return Configuration::instance().mPipelinedRendering && mActiveRenderer == mSoftwareRenderer;
+#endif
+}
+
 void VideoOut::renderGameScreen()
 {
+	if (usePipelinedRendering())
+	{
+		if (nullptr == mRenderThread)
+		{
+			mRenderThread = new RenderThread(mGameResolution);
+		}
+
+		// Show the previously rendered frame, before the geometries it used get replaced
+		mRenderThread->finishRendering(mGameScreenTexture);
+
+		// Render the current state from a snapshot on the render thread
+		RenderParts& snapshotRenderParts = mRenderThread->getSnapshotRenderParts();
+		snapshotRenderParts.copyForRendering(*mRenderParts);
+
+		clearGeometries();
+		if (snapshotRenderParts.getActiveDisplay())
+		{
+			collectGeometries(snapshotRenderParts, mGeometries);
+		}
+		mRenderThread->startRendering(mGeometries);
+		return;
+	}
+
+	// Pipelined rendering might have been disabled in the meantime
+	SAFE_DELETE(mRenderThread);
+
 	// Collect geometries to render
 	clearGeometries();
 	if (mRenderParts->getActiveDisplay())
 	{
-		collectGeometries(mGeometries);
+		collectGeometries(*mRenderParts, mGeometries);
 	}
 
 	// Render them
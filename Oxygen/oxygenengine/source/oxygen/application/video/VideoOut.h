@@ -16,6 +16,7 @@ class OpenGLRenderer;
 class SoftwareRenderer;
 class RenderParts;
 class RenderResources;
+class RenderThread;
 
 
 class VideoOut : public SingleInstance<VideoOut>
@@ -30,6 +31,9 @@ public:
 
 	void handleActiveModsChanged();
 
+	// Needs to be called before sprites, fonts or glyph atlases get reloaded or cleared, as pipelined rendering might still be using them
+	void waitUntilRenderingIdle();
+
 	void createRenderer(bool reset);
 	void destroyRenderer();
 	void setActiveRenderer(bool useOpenGLRenderer, bool reset);
@@ -72,8 +76,9 @@ public:
 
 private:
 	void clearGeometries();
-	void collectGeometries(std::vector<Geometry*>& geometries);
+	void collectGeometries(RenderParts& renderParts, std::vector<Geometry*>& geometries);
 
+	bool usePipelinedRendering() const;
 	void renderGameScreen();
 
 private:
@@ -100,6 +105,7 @@ private:
 #endif
 
 	RenderParts* mRenderParts = nullptr;
+	RenderThread* mRenderThread = nullptr;	// Only used with pipelined rendering
 	DrawerTexture mGameScreenTexture;
 	RenderResources& mRenderResources;
 
@@ -241,17 +241,10 @@ BitmapViewMutable<uint32> Blitter::makeTempBitmapAsCopy(const BitmapView<uint32>
 BitmapViewMutable<uint32> Blitter::makeTempBitmapAsCopy(const BitmapView<uint8>& input, const PaletteWrapper& palette, Vec2i size, Vec2i innerIndent)
 {
 	BitmapViewMutable<uint32> result = makeTempBitmap(size);
+	const BlitterKernels::PaletteLookupFunction paletteLookupFunction = BlitterKernels::get().mPaletteLookup;
 	for (int y = 0; y < size.y; ++y)
 	{
-		uint32* dst = result.getLinePointer(y);
-		const uint8* src = input.getPixelPointer(innerIndent.x, innerIndent.y + y);
-		for (int x = 0; x < size.x; ++x)
-		{
-			const uint8 index = *src;
-			*dst = (index < palette.mNumEntries) ? palette.mPalette[index] : 0;
-			++dst;
-			++src;
-		}
+		paletteLookupFunction(result.getLinePointer(y), input.getPixelPointer(innerIndent.x, innerIndent.y + y), (size_t)size.x, palette.mPalette, palette.mNumEntries);
 	}
 	return result;
 }
@@ -7,6 +7,7 @@
 */
 
 #include "oxygen/drawing/software/Blitter.h"
+#include "oxygen/drawing/software/BlitterKernels.h"
 
 
 struct BlitterHelper
@@ -398,8 +399,9 @@ struct BlitterHelper
 		{
 			case BlendMode::ALPHA:
 			{
+				const BlitterKernels::BlendLineFunction blendLineFunction = BlitterKernels::get().mBlendLineAlpha;
 				for (const Blitter::PixelSegment& pixelSegment : pixelSegments)
-					blendLineAlpha(output.getPixelPointer(pixelSegment.mPosition), input.getPixelPointer(pixelSegment.mPosition), pixelSegment.mNumPixels);
+					blendLineFunction(output.getPixelPointer(pixelSegment.mPosition), input.getPixelPointer(pixelSegment.mPosition), pixelSegment.mNumPixels);
 				break;
 			}
 
@@ -460,8 +462,9 @@ struct BlitterHelper
 		{
 			case BlendMode::ALPHA:
 			{
+				const BlitterKernels::BlendLineWithDepthFunction blendLineFunction = BlitterKernels::get().mBlendLineAlphaWithDepth;
 				for (const Blitter::PixelSegment& pixelSegment : pixelSegments)
-					blendLineAlphaWithDepth(output.getPixelPointer(pixelSegment.mPosition), input.getPixelPointer(pixelSegment.mPosition), pixelSegment.mNumPixels, depthBuffer.getPixelPointer(pixelSegment.mPosition), options.mDepthTestValue);
+					blendLineFunction(output.getPixelPointer(pixelSegment.mPosition), input.getPixelPointer(pixelSegment.mPosition), pixelSegment.mNumPixels, depthBuffer.getPixelPointer(pixelSegment.mPosition), options.mDepthTestValue);
 				break;
 			}
 
@@ -509,8 +512,9 @@ struct BlitterHelper
 
 			default:
 			{
+				const BlitterKernels::BlendLineWithDepthFunction blendLineFunction = BlitterKernels::get().mBlendLineOpaqueWithDepth;
 				for (const Blitter::PixelSegment& pixelSegment : pixelSegments)
-					blendLineOpaqueWithDepth(output.getPixelPointer(pixelSegment.mPosition), input.getPixelPointer(pixelSegment.mPosition), pixelSegment.mNumPixels, depthBuffer.getPixelPointer(pixelSegment.mPosition), options.mDepthTestValue);
+					blendLineFunction(output.getPixelPointer(pixelSegment.mPosition), input.getPixelPointer(pixelSegment.mPosition), pixelSegment.mNumPixels, depthBuffer.getPixelPointer(pixelSegment.mPosition), options.mDepthTestValue);
 				break;
 			}
 		}
@@ -0,0 +1,401 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "oxygen/pch.h"
+#include "oxygen/drawing/software/BlitterKernels.h"
+#include "oxygen/drawing/software/BlitterHelper.h"
+
+#if !defined(PLATFORM_WEB) && (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define BLITTER_KERNELS_X86
+	#include <immintrin.h>
+
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#define TARGET_AVX2
+	#else
+		#define TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define BLITTER_KERNELS_NEON
+	#include <arm_neon.h>
+#endif
+
+
+namespace
+{
+	// Note about the alpha blending in all variants:
+	//  -> The scalar code calculates "(src * alpha + dst * (255 - alpha)) / 255" for each color channel, and leaves the destination's alpha channel unchanged
+	//  -> For all values that can occur here, the division by 255 is the same as "(x + 1 + (x >> 8)) >> 8", which fits into 16 bits
+	//  -> Source pixels with an alpha of zero don't need special handling, as the formula leaves the destination unchanged then anyways
+
+	void paletteLookupScalar(uint32* dst, const uint8* src, size_t numPixels, const uint32* palette, size_t numEntries)
+	{
+		for (size_t x = 0; x < numPixels; ++x)
+		{
+			const uint8 index = src[x];
+			dst[x] = (index < numEntries) ? palette[index] : 0;
+		}
+	}
+
+
+#if defined(BLITTER_KERNELS_X86)
+
+	FORCE_INLINE __m128i blendPixelsAlphaSSE2(__m128i src, __m128i dst)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi16(1);
+		const __m128i all255 = _mm_set1_epi16(255);
+
+		// Alpha of each pixel in all four 16-bit values of this pixel
+		__m128i alpha = _mm_srli_epi32(src, 24);
+		alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+		const __m128i alphaLo = _mm_unpacklo_epi32(alpha, alpha);
+		const __m128i alphaHi = _mm_unpackhi_epi32(alpha, alpha);
+
+		__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), alphaLo), _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), _mm_sub_epi16(all255, alphaLo)));
+		__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(src, zero), alphaHi), _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), _mm_sub_epi16(all255, alphaHi)));
+		lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)), 8);
+
+		// Keep the destination's alpha
+		const __m128i alphaMask = _mm_set1_epi32((int)0xff000000);
+		return _mm_or_si128(_mm_andnot_si128(alphaMask, _mm_packus_epi16(lo, hi)), _mm_and_si128(alphaMask, dst));
+	}
+
+	FORCE_INLINE __m128i loadDepthMaskSSE2(const uint8* depthBuffer, __m128i depthTestValue)
+	{
+		// Results in all bits set for pixels that pass the depth test, i.e. where "depthTestValue >= depth"
+		int32 depthValues;
+		memcpy(&depthValues, depthBuffer, 4);
+		const __m128i depth = _mm_cvtsi32_si128(depthValues);
+		__m128i mask = _mm_cmpeq_epi8(_mm_max_epu8(depth, depthTestValue), depthTestValue);
+		mask = _mm_unpacklo_epi8(mask, mask);
+		return _mm_unpacklo_epi16(mask, mask);
+	}
+
+	void blendLineAlphaSSE2(uint32* dst, const uint32* src, size_t numPixels)
+	{
+		size_t x = 0;
+		for (; x + 4 <= numPixels; x += 4)
+		{
+			const __m128i srcPixels = _mm_loadu_si128((const __m128i*)&src[x]);
+			const __m128i dstPixels = _mm_loadu_si128((const __m128i*)&dst[x]);
+			_mm_storeu_si128((__m128i*)&dst[x], blendPixelsAlphaSSE2(srcPixels, dstPixels));
+		}
+		BlitterHelper::blendLineAlpha(&dst[x], &src[x], numPixels - x);
+	}
+
+	void blendLineAlphaWithDepthSSE2(uint32* dst, const uint32* src, size_t numPixels, uint8* depthBuffer, uint8 depthTestValue)
+	{
+		const __m128i depthTestValues = _mm_set1_epi8((char)depthTestValue);
+		size_t x = 0;
+		for (; x + 4 <= numPixels; x += 4)
+		{
+			const __m128i srcPixels = _mm_loadu_si128((const __m128i*)&src[x]);
+			const __m128i dstPixels = _mm_loadu_si128((const __m128i*)&dst[x]);
+			const __m128i mask = loadDepthMaskSSE2(&depthBuffer[x], depthTestValues);
+			const __m128i blended = blendPixelsAlphaSSE2(srcPixels, dstPixels);
+			_mm_storeu_si128((__m128i*)&dst[x], _mm_or_si128(_mm_and_si128(mask, blended), _mm_andnot_si128(mask, dstPixels)));
+		}
+		BlitterHelper::blendLineAlphaWithDepth(&dst[x], &src[x], numPixels - x, &depthBuffer[x], depthTestValue);
+	}
+
+	void blendLineOpaqueWithDepthSSE2(uint32* dst, const uint32* src, size_t numPixels, uint8* depthBuffer, uint8 depthTestValue)
+	{
+		const __m128i depthTestValues = _mm_set1_epi8((char)depthTestValue);
+		size_t x = 0;
+		for (; x + 4 <= numPixels; x += 4)
+		{
+			const __m128i srcPixels = _mm_loadu_si128((const __m128i*)&src[x]);
+			const __m128i dstPixels = _mm_loadu_si128((const __m128i*)&dst[x]);
+			const __m128i mask = loadDepthMaskSSE2(&depthBuffer[x], depthTestValues);
+			_mm_storeu_si128((__m128i*)&dst[x], _mm_or_si128(_mm_and_si128(mask, srcPixels), _mm_andnot_si128(mask, dstPixels)));
+		}
+		BlitterHelper::blendLineOpaqueWithDepth(&dst[x], &src[x], numPixels - x, &depthBuffer[x], depthTestValue);
+	}
+
+
+	TARGET_AVX2 FORCE_INLINE __m256i blendPixelsAlphaAVX2(__m256i src, __m256i dst)
+	{
+		// Same as the SSE2 variant, see there; the unpacks and the pack operate inside each 128-bit lane, which is fine here
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i one = _mm256_set1_epi16(1);
+		const __m256i all255 = _mm256_set1_epi16(255);
+
+		__m256i alpha = _mm256_srli_epi32(src, 24);
+		alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+		const __m256i alphaLo = _mm256_unpacklo_epi32(alpha, alpha);
+		const __m256i alphaHi = _mm256_unpackhi_epi32(alpha, alpha);
+
+		__m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(src, zero), alphaLo), _mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), _mm256_sub_epi16(all255, alphaLo)));
+		__m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(src, zero), alphaHi), _mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), _mm256_sub_epi16(all255, alphaHi)));
+		lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(lo, one), _mm256_srli_epi16(lo, 8)), 8);
+		hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(hi, one), _mm256_srli_epi16(hi, 8)), 8);
+
+		const __m256i alphaMask = _mm256_set1_epi32((int)0xff000000);
+		return _mm256_or_si256(_mm256_andnot_si256(alphaMask, _mm256_packus_epi16(lo, hi)), _mm256_and_si256(alphaMask, dst));
+	}
+
+	TARGET_AVX2 FORCE_INLINE __m256i loadDepthMaskAVX2(const uint8* depthBuffer, __m128i depthTestValue)
+	{
+		const __m128i depth = _mm_loadl_epi64((const __m128i*)depthBuffer);
+		const __m128i mask = _mm_cmpeq_epi8(_mm_max_epu8(depth, depthTestValue), depthTestValue);
+		return _mm256_cvtepi8_epi32(mask);
+	}
+
+	TARGET_AVX2 void blendLineAlphaAVX2(uint32* dst, const uint32* src, size_t numPixels)
+	{
+		size_t x = 0;
+		for (; x + 8 <= numPixels; x += 8)
+		{
+			const __m256i srcPixels = _mm256_loadu_si256((const __m256i*)&src[x]);
+			const __m256i dstPixels = _mm256_loadu_si256((const __m256i*)&dst[x]);
+			_mm256_storeu_si256((__m256i*)&dst[x], blendPixelsAlphaAVX2(srcPixels, dstPixels));
+		}
+		_mm256_zeroupper();		// Avoid AVX-SSE transition penalties in the non-VEX tail code
+		blendLineAlphaSSE2(&dst[x], &src[x], numPixels - x);
+	}
+
+	TARGET_AVX2 void blendLineAlphaWithDepthAVX2(uint32* dst, const uint32* src, size_t numPixels, uint8* depthBuffer, uint8 depthTestValue)
+	{
+		const __m128i depthTestValues = _mm_set1_epi8((char)depthTestValue);
+		size_t x = 0;
+		for (; x + 8 <= numPixels; x += 8)
+		{
+			const __m256i srcPixels = _mm256_loadu_si256((const __m256i*)&src[x]);
+			const __m256i dstPixels = _mm256_loadu_si256((const __m256i*)&dst[x]);
+			const __m256i mask = loadDepthMaskAVX2(&depthBuffer[x], depthTestValues);
+			_mm256_storeu_si256((__m256i*)&dst[x], _mm256_blendv_epi8(dstPixels, blendPixelsAlphaAVX2(srcPixels, dstPixels), mask));
+		}
+		_mm256_zeroupper();
+		blendLineAlphaWithDepthSSE2(&dst[x], &src[x], numPixels - x, &depthBuffer[x], depthTestValue);
+	}
+
+	TARGET_AVX2 void blendLineOpaqueWithDepthAVX2(uint32* dst, const uint32* src, size_t numPixels, uint8* depthBuffer, uint8 depthTestValue)
+	{
+		const __m128i depthTestValues = _mm_set1_epi8((char)depthTestValue);
+		size_t x = 0;
+		for (; x + 8 <= numPixels; x += 8)
+		{
+			const __m256i srcPixels = _mm256_loadu_si256((const __m256i*)&src[x]);
+			const __m256i mask = loadDepthMaskAVX2(&depthBuffer[x], depthTestValues);
+			_mm256_maskstore_epi32((int*)&dst[x], mask, srcPixels);
+		}
+		_mm256_zeroupper();
+		blendLineOpaqueWithDepthSSE2(&dst[x], &src[x], numPixels - x, &depthBuffer[x], depthTestValue);
+	}
+
+	TARGET_AVX2 void paletteLookupAVX2(uint32* dst, const uint8* src, size_t numPixels, const uint32* palette, size_t numEntries)
+	{
+		// Indices are at most 255 anyways, so larger palettes don't need any range check
+		const __m256i numEntriesVector = _mm256_set1_epi32((int)std::min<size_t>(numEntries, 256));
+		size_t x = 0;
+		for (; x + 8 <= numPixels; x += 8)
+		{
+			const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&src[x]));
+			const __m256i mask = _mm256_cmpgt_epi32(numEntriesVector, indices);
+			const __m256i colors = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), (const int*)palette, indices, mask, 4);
+			_mm256_storeu_si256((__m256i*)&dst[x], colors);
+		}
+		_mm256_zeroupper();
+		paletteLookupScalar(&dst[x], &src[x], numPixels - x, palette, numEntries);
+	}
+
+#endif
+
+
+#if defined(BLITTER_KERNELS_NEON)
+
+	FORCE_INLINE uint8x16_t blendPixelsAlphaNEON(uint8x16_t src, uint8x16_t dst)
+	{
+		// Alpha of each pixel in all four bytes of this pixel
+		const uint8x16_t alpha = vreinterpretq_u8_u32(vmulq_n_u32(vshrq_n_u32(vreinterpretq_u32_u8(src), 24), 0x01010101));
+		const uint8x16_t oneMinusAlpha = vmvnq_u8(alpha);
+
+		uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(src), vget_low_u8(alpha)), vget_low_u8(dst), vget_low_u8(oneMinusAlpha));
+		uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(src), vget_high_u8(alpha)), vget_high_u8(dst), vget_high_u8(oneMinusAlpha));
+		const uint16x8_t one = vdupq_n_u16(1);
+		lo = vsraq_n_u16(vaddq_u16(lo, one), lo, 8);
+		hi = vsraq_n_u16(vaddq_u16(hi, one), hi, 8);
+		const uint8x16_t blended = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+
+		// Keep the destination's alpha
+		const uint8x16_t colorMask = vreinterpretq_u8_u32(vdupq_n_u32(0x00ffffff));
+		return vbslq_u8(colorMask, blended, dst);
+	}
+
+	FORCE_INLINE uint32x4_t loadDepthMaskNEON(const uint8* depthBuffer, uint8x8_t depthTestValue)
+	{
+		// Results in all bits set for pixels that pass the depth test, i.e. where "depthTestValue >= depth"
+		uint32 depthValues;
+		memcpy(&depthValues, depthBuffer, 4);
+		const uint8x8_t depth = vreinterpret_u8_u32(vdup_n_u32(depthValues));
+		const int8x8_t mask = vreinterpret_s8_u8(vcge_u8(depthTestValue, depth));
+		return vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(vmovl_s8(mask))));
+	}
+
+	void blendLineAlphaNEON(uint32* dst, const uint32* src, size_t numPixels)
+	{
+		size_t x = 0;
+		for (; x + 4 <= numPixels; x += 4)
+		{
+			const uint8x16_t srcPixels = vld1q_u8((const uint8*)&src[x]);
+			const uint8x16_t dstPixels = vld1q_u8((const uint8*)&dst[x]);
+			vst1q_u8((uint8*)&dst[x], blendPixelsAlphaNEON(srcPixels, dstPixels));
+		}
+		BlitterHelper::blendLineAlpha(&dst[x], &src[x], numPixels - x);
+	}
+
+	void blendLineAlphaWithDepthNEON(uint32* dst, const uint32* src, size_t numPixels, uint8* depthBuffer, uint8 depthTestValue)
+	{
+		const uint8x8_t depthTestValues = vdup_n_u8(depthTestValue);
+		size_t x = 0;
+		for (; x + 4 <= numPixels; x += 4)
+		{
+			const uint8x16_t srcPixels = vld1q_u8((const uint8*)&src[x]);
+			const uint8x16_t dstPixels = vld1q_u8((const uint8*)&dst[x]);
+			const uint8x16_t mask = vreinterpretq_u8_u32(loadDepthMaskNEON(&depthBuffer[x], depthTestValues));
+			vst1q_u8((uint8*)&dst[x], vbslq_u8(mask, blendPixelsAlphaNEON(srcPixels, dstPixels), dstPixels));
+		}
+		BlitterHelper::blendLineAlphaWithDepth(&dst[x], &src[x], numPixels - x, &depthBuffer[x], depthTestValue);
+	}
+
+	void blendLineOpaqueWithDepthNEON(uint32* dst, const uint32* src, size_t numPixels, uint8* depthBuffer, uint8 depthTestValue)
+	{
+		const uint8x8_t depthTestValues = vdup_n_u8(depthTestValue);
+		size_t x = 0;
+		for (; x + 4 <= numPixels; x += 4)
+		{
+			const uint32x4_t srcPixels = vld1q_u32(&src[x]);
+			const uint32x4_t dstPixels = vld1q_u32(&dst[x]);
+			vst1q_u32(&dst[x], vbslq_u32(loadDepthMaskNEON(&depthBuffer[x], depthTestValues), srcPixels, dstPixels));
+		}
+		BlitterHelper::blendLineOpaqueWithDepth(&dst[x], &src[x], numPixels - x, &depthBuffer[x], depthTestValue);
+	}
+
+#endif
+
+
+	BlitterKernels::Functions buildFunctions(BlitterKernels::InstructionSet instructionSet)
+	{
+		BlitterKernels::Functions functions;
+		functions.mInstructionSet = BlitterKernels::InstructionSet::SCALAR;
+		functions.mBlendLineAlpha = &BlitterHelper::blendLineAlpha;
+		functions.mBlendLineAlphaWithDepth = &BlitterHelper::blendLineAlphaWithDepth;
+		functions.mBlendLineOpaqueWithDepth = &BlitterHelper::blendLineOpaqueWithDepth;
+		functions.mPaletteLookup = &paletteLookupScalar;
+
+		if (!BlitterKernels::isSupported(instructionSet))
+			return functions;
+
+		switch (instructionSet)
+		{
+		#if defined(BLITTER_KERNELS_X86)
+			case BlitterKernels::InstructionSet::SSE2:
+			{
+				functions.mInstructionSet = instructionSet;
+				functions.mBlendLineAlpha = &blendLineAlphaSSE2;
+				functions.mBlendLineAlphaWithDepth = &blendLineAlphaWithDepthSSE2;
+				functions.mBlendLineOpaqueWithDepth = &blendLineOpaqueWithDepthSSE2;
+				break;
+			}
+
+			case BlitterKernels::InstructionSet::AVX2:
+			{
+				functions.mInstructionSet = instructionSet;
+				functions.mBlendLineAlpha = &blendLineAlphaAVX2;
+				functions.mBlendLineAlphaWithDepth = &blendLineAlphaWithDepthAVX2;
+				functions.mBlendLineOpaqueWithDepth = &blendLineOpaqueWithDepthAVX2;
+				functions.mPaletteLookup = &paletteLookupAVX2;
+				break;
+			}
+		#endif
+
+		#if defined(BLITTER_KERNELS_NEON)
+			case BlitterKernels::InstructionSet::NEON:
+			{
+				functions.mInstructionSet = instructionSet;
+				functions.mBlendLineAlpha = &blendLineAlphaNEON;
+				functions.mBlendLineAlphaWithDepth = &blendLineAlphaWithDepthNEON;
+				functions.mBlendLineOpaqueWithDepth = &blendLineOpaqueWithDepthNEON;
+				break;
+			}
+		#endif
+
+			default:
+				break;
+		}
+		return functions;
+	}
+
+	BlitterKernels::InstructionSet getBestInstructionSet()
+	{
+		if (BlitterKernels::isSupported(BlitterKernels::InstructionSet::AVX2))
+			return BlitterKernels::InstructionSet::AVX2;
+		if (BlitterKernels::isSupported(BlitterKernels::InstructionSet::SSE2))
+			return BlitterKernels::InstructionSet::SSE2;
+		if (BlitterKernels::isSupported(BlitterKernels::InstructionSet::NEON))
+			return BlitterKernels::InstructionSet::NEON;
+		return BlitterKernels::InstructionSet::SCALAR;
+	}
+}
+
+
+const BlitterKernels::Functions& BlitterKernels::get()
+{
+	static const Functions functions = buildFunctions(getBestInstructionSet());
+	return functions;
+}
+
+bool BlitterKernels::isSupported(InstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+		case InstructionSet::SCALAR:
+			return true;
+
+	#if defined(BLITTER_KERNELS_X86)
+		case InstructionSet::SSE2:
+			return true;
+
+		case InstructionSet::AVX2:
+			return SDL_HasAVX2();
+	#endif
+
+	#if defined(BLITTER_KERNELS_NEON)
+		case InstructionSet::NEON:
+			return true;
+	#endif
+
+		default:
+			return false;
+	}
+}
+
+const BlitterKernels::Functions& BlitterKernels::getFunctions(InstructionSet instructionSet)
+{
+	static const Functions functions[(size_t)InstructionSet::_NUM] =
+	{
+		buildFunctions(InstructionSet::SCALAR),
+		buildFunctions(InstructionSet::SSE2),
+		buildFunctions(InstructionSet::AVX2),
+		buildFunctions(InstructionSet::NEON)
+	};
+	return ((size_t)instructionSet < (size_t)InstructionSet::_NUM) ? functions[(size_t)instructionSet] : functions[0];
+}
+
+const char* BlitterKernels::getInstructionSetName(InstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+		case InstructionSet::SCALAR:  return "Scalar";
+		case InstructionSet::SSE2:	  return "SSE2";
+		case InstructionSet::AVX2:	  return "AVX2";
+		case InstructionSet::NEON:	  return "NEON";
+		default:					  return "Unknown";
+	}
+}
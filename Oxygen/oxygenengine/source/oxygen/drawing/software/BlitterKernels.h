@@ -0,0 +1,48 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+#include <rmxbase.h>
+
+
+// Implementations of the blitter's most common inner loops, using SIMD instructions where available
+//  -> All variants produce exactly the same results as the scalar code in "BlitterHelper"
+//  -> The instruction set gets selected at runtime, depending on what the CPU supports
+class BlitterKernels
+{
+public:
+	enum class InstructionSet
+	{
+		SCALAR,
+		SSE2,
+		AVX2,
+		NEON,
+		_NUM
+	};
+
+	typedef void(*BlendLineFunction)(uint32* dst, const uint32* src, size_t numPixels);
+	typedef void(*BlendLineWithDepthFunction)(uint32* dst, const uint32* src, size_t numPixels, uint8* depthBuffer, uint8 depthTestValue);
+	typedef void(*PaletteLookupFunction)(uint32* dst, const uint8* src, size_t numPixels, const uint32* palette, size_t numEntries);
+
+	struct Functions
+	{
+		InstructionSet mInstructionSet = InstructionSet::SCALAR;
+		BlendLineFunction mBlendLineAlpha = nullptr;
+		BlendLineWithDepthFunction mBlendLineAlphaWithDepth = nullptr;
+		BlendLineWithDepthFunction mBlendLineOpaqueWithDepth = nullptr;
+		PaletteLookupFunction mPaletteLookup = nullptr;		// Writes transparent black for indices outside of the palette
+	};
+
+public:
+	static const Functions& get();		// Returns the functions for the best supported instruction set
+
+	static bool isSupported(InstructionSet instructionSet);
+	static const Functions& getFunctions(InstructionSet instructionSet);	// Falls back to scalar functions if the instruction set is not supported
+	static const char* getInstructionSetName(InstructionSet instructionSet);
+};
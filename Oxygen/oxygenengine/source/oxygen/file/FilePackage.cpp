@@ -11,7 +11,16 @@
 #include "oxygen/helper/Utils.h"
 
 
-bool FilePackage::loadPackage(std::wstring_view packageFilename, std::map<std::wstring, PackedFile>& outPackedFiles, bool forceLoadAll, bool showErrors)
+namespace
+{
+	// Compression is only used if it saves at least this fraction, otherwise it's not worth the decompression time
+	//  -> This is usually the case for data that is already compressed, like .ogg or .png files
+	const constexpr size_t MIN_COMPRESSION_SAVINGS_DIVISOR = 16;
+	const constexpr int PACKAGE_COMPRESSION_LEVEL = 9;
+}
+
+
+bool FilePackage::loadPackage(std::wstring_view packageFilename, PackedFileList& outPackedFiles, bool forceLoadAll, bool showErrors)
 {
 	// Try to load the package
 	InputStream* inputStream = FTX::FileSystem->createInputStream(packageFilename);
@@ -27,13 +36,16 @@ bool FilePackage::loadPackage(std::wstring_view packageFilename, std::map<std::w
 	if (forceLoadAll)
 	{
 		// Read entry contents
-		for (auto& pair : outPackedFiles)
+		std::vector<uint8> storedData;
+		for (PackedFile& packedFile : outPackedFiles)
 		{
-			pair.second.mContent.resize((size_t)pair.second.mSizeInFile);
-			inputStream->setPosition(pair.second.mPositionInFile);
-			const size_t bytesRead = inputStream->read(&pair.second.mContent[0], (size_t)pair.second.mSizeInFile);
-			RMX_CHECK(pair.second.mSizeInFile == bytesRead, "Failed to load entry '" << WString(pair.first).toStdString() << "' from package", continue);
-			pair.second.mLoadedContent = true;
+			storedData.resize((size_t)packedFile.mSizeInFile);
+			inputStream->setPosition(packedFile.mPositionInFile);
+			const size_t bytesRead = storedData.empty() ? 0 : inputStream->read(&storedData[0], storedData.size());
+			RMX_CHECK(packedFile.mSizeInFile == bytesRead, "Failed to load entry '" << WString(packedFile.mPath).toStdString() << "' from package", continue);
+			if (!decodeContent(packedFile, storedData.data(), packedFile.mContent))
+				continue;
+			packedFile.mLoadedContent = true;
 		}
 	}
 
@@ -41,11 +53,34 @@ bool FilePackage::loadPackage(std::wstring_view packageFilename, std::map<std::w
 	return true;
 }
 
+bool FilePackage::loadPackageFromMemory(const uint8* data, size_t size, std::wstring_view packageFilename, PackedFileList& outPackedFiles, bool showErrors)
+{
+	MemInputStream inputStream(data, size);
+	if (!loadPackageInternal(inputStream, packageFilename, outPackedFiles, showErrors))
+		return false;
+
+	// Callers will access entry contents directly in memory, so make sure none of them exceeds the data
+	for (const PackedFile& packedFile : outPackedFiles)
+	{
+		if ((uint64)packedFile.mPositionInFile + (uint64)packedFile.mSizeInFile > (uint64)size)
+		{
+			if (showErrors)
+			{
+				RMX_ERROR("Entry '" << WString(packedFile.mPath).toStdString() << "' exceeds the size of package '" << WString(packageFilename).toStdString() << "'", );
+			}
+			outPackedFiles.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
 void FilePackage::createFilePackage(const std::wstring& packageFilename, const std::wstring& basePath, const std::vector<std::wstring>& includedPaths, const std::vector<std::wstring>& excludedPaths, const std::wstring& comparisonPath, uint32 contentVersion, bool forceReplace)
 {
 	// Collect file contents
-	std::map<std::wstring, PackedFile> packedFiles;
+	PackedFileList packedFiles;
 	{
+		std::map<std::wstring, std::vector<uint8>> contents;
 		FileCrawler fc;
 		for (const std::wstring& includedPath : includedPaths)
 		{
@@ -75,27 +110,38 @@ void FilePackage::createFilePackage(const std::wstring& packageFilename, const s
 				std::vector<uint8> content;
 				if (FTX::FileSystem->readFile(path, content))
 				{
-					PackedFile& packedFile = packedFiles[relativePath];
-					packedFile.mContent.swap(content);
+					contents[relativePath].swap(content);
 				}
 			}
 		}
+
+		packedFiles.reserve(contents.size());
+		for (auto& [relativePath, content] : contents)
+		{
+			PackedFile& packedFile = vectorAdd(packedFiles);
+			packedFile.mPath = relativePath;
+			packedFile.mPathHash = getPathHash(relativePath);
+			packedFile.mUncompressedSize = (uint32)content.size();
+			packedFile.mContentHash = getContentHash(content.data(), content.size());
+			packedFile.mContent.swap(content);
+		}
+		sortPackedFiles(packedFiles);
 	}
 
 	// Check against existing file, if there is one already
 	if (!forceReplace && !comparisonPath.empty())
 	{
-		std::map<std::wstring, PackedFile> existingPackedFiles;
+		PackedFileList existingPackedFiles;
 		if (loadPackage(comparisonPath + packageFilename, existingPackedFiles, true, false))
 		{
-			// Compare
+			// Compare; note that packages in older format versions have no content hashes, and thus always get replaced
 			bool isEqual = (existingPackedFiles.size() == packedFiles.size());
 			if (isEqual)
 			{
-				for (const auto& pair : packedFiles)
+				for (PackedFile& packedFile : packedFiles)
 				{
-					PackedFile* packedFile = mapFind(existingPackedFiles, pair.first);
-					if (nullptr == packedFile || packedFile->mContent != pair.second.mContent)
+					const PackedFile* existingPackedFile = findPackedFile(existingPackedFiles, packedFile.mPath);
+					if (nullptr == existingPackedFile || existingPackedFile->mContentHash != packedFile.mContentHash || existingPackedFile->mContent != packedFile.mContent)
 					{
 						isEqual = false;
 						break;
@@ -111,6 +157,25 @@ void FilePackage::createFilePackage(const std::wstring& packageFilename, const s
 		}
 	}
 
+	// Compress where it's worth it
+	std::vector<std::vector<uint8>> storedContents(packedFiles.size());
+	for (size_t index = 0; index < packedFiles.size(); ++index)
+	{
+		PackedFile& packedFile = packedFiles[index];
+		std::vector<uint8>& storedContent = storedContents[index];
+		if (!packedFile.mContent.empty() && ZlibDeflate::encode(storedContent, packedFile.mContent.data(), packedFile.mContent.size(), PACKAGE_COMPRESSION_LEVEL)
+			&& storedContent.size() < packedFile.mContent.size() - packedFile.mContent.size() / MIN_COMPRESSION_SAVINGS_DIVISOR)
+		{
+			packedFile.mCompression = Compression::DEFLATE;
+		}
+		else
+		{
+			packedFile.mCompression = Compression::NONE;
+			storedContent = packedFile.mContent;
+		}
+		packedFile.mSizeInFile = (uint32)storedContent.size();
+	}
+
 	// Collect output content
 	std::vector<uint8> output;
 	size_t entryHeaderSize = 0;
@@ -126,22 +191,27 @@ void FilePackage::createFilePackage(const std::wstring& packageFilename, const s
 		serializer.writeAs<uint32>(0);		// Will get overwritten
 
 		serializer.writeAs<uint32>(packedFiles.size());
-		for (auto& [key, packedFile] : packedFiles)
+		for (PackedFile& packedFile : packedFiles)
 		{
-			serializer.write(key, 1024);
+			serializer.write(packedFile.mPathHash);
+			serializer.write(packedFile.mPath, 1024);
 			packedFile.mPositionInFile = (uint32)output.size();		// Temporarily misusing this variable to store the position where to write the content's position in file when it got determined
 			serializer.writeAs<uint32>(0);							// Will get overwritten
-			serializer.writeAs<uint32>(packedFile.mContent.size());
+			serializer.write(packedFile.mSizeInFile);
+			serializer.write(packedFile.mUncompressedSize);
+			serializer.writeAs<uint8>(packedFile.mCompression);
+			serializer.write(packedFile.mContentHash);
 		}
 
 		// Write entry header size
 		entryHeaderSize = output.size() - PackageHeader::HEADER_SIZE;
 		*(uint32*)&output[headerSizePosition] = (uint32)entryHeaderSize;
 
-		for (auto& [key, packedFile] : packedFiles)
+		for (size_t index = 0; index < packedFiles.size(); ++index)
 		{
+			PackedFile& packedFile = packedFiles[index];
 			const uint32 position = (uint32)output.size();
-			serializer.write(&packedFile.mContent[0], packedFile.mContent.size());
+			serializer.write(storedContents[index].data(), storedContents[index].size());
 			*(uint32*)&output[packedFile.mPositionInFile] = position;
 			packedFile.mPositionInFile = position;
 		}
@@ -151,7 +221,71 @@ void FilePackage::createFilePackage(const std::wstring& packageFilename, const s
 	FTX::FileSystem->saveFile(packageFilename, output);
 }
 
-bool FilePackage::loadPackageInternal(InputStream& inputStream, std::wstring_view packageFilename, std::map<std::wstring, PackedFile>& outPackedFiles, bool showErrors)
+FilePackage::PackedFile* FilePackage::findPackedFile(PackedFileList& packedFiles, std::wstring_view path)
+{
+	const uint64 pathHash = getPathHash(path);
+	auto it = std::lower_bound(packedFiles.begin(), packedFiles.end(), pathHash, [](const PackedFile& packedFile, uint64 hash) { return packedFile.mPathHash < hash; });
+	for (; it != packedFiles.end() && it->mPathHash == pathHash; ++it)
+	{
+		if (it->mPath == path)
+			return &*it;
+	}
+	return nullptr;
+}
+
+bool FilePackage::decodeContent(const PackedFile& packedFile, const uint8* storedData, std::vector<uint8>& outContent)
+{
+	switch (packedFile.mCompression)
+	{
+		case Compression::NONE:
+		{
+			outContent.assign(storedData, storedData + packedFile.mSizeInFile);
+			return true;
+		}
+
+		case Compression::DEFLATE:
+		{
+			outContent.clear();
+			outContent.reserve((size_t)packedFile.mUncompressedSize);
+			if (!ZlibDeflate::decode(outContent, storedData, (size_t)packedFile.mSizeInFile) || outContent.size() != (size_t)packedFile.mUncompressedSize)
+			{
+				RMX_ERROR("Failed to decompress package entry '" << WString(packedFile.mPath).toStdString() << "'", );
+				return false;
+			}
+
+			// Decompression touches all of the data anyways, so checking the content hash as well is comparatively cheap
+			RMX_CHECK(getContentHash(outContent.data(), outContent.size()) == packedFile.mContentHash, "Content hash mismatch for package entry '" << WString(packedFile.mPath).toStdString() << "'", return false);
+			return true;
+		}
+	}
+	return false;
+}
+
+uint64 FilePackage::getPathHash(std::wstring_view path)
+{
+	// Hash the code points, so that the result is the same for 16-bit and 32-bit wchar_t
+	uint64 hash = rmx::startFNV1a_64();
+	for (size_t k = 0; k < path.length(); ++k)
+	{
+		uint32 codePoint = (uint32)path[k];
+		if (codePoint >= 0xd800 && codePoint < 0xdc00 && k + 1 < path.length() && (uint32)path[k+1] >= 0xdc00 && (uint32)path[k+1] < 0xe000)
+		{
+			// UTF-16 surrogate pair
+			codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + ((uint32)path[k+1] - 0xdc00);
+			++k;
+		}
+		const uint8 bytes[4] = { (uint8)codePoint, (uint8)(codePoint >> 8), (uint8)(codePoint >> 16), (uint8)(codePoint >> 24) };
+		hash = rmx::addToFNV1a_64(hash, bytes, 4);
+	}
+	return hash;
+}
+
+uint64 FilePackage::getContentHash(const uint8* data, size_t size)
+{
+	return rmx::getMurmur2_64(data, size);
+}
+
+bool FilePackage::loadPackageInternal(InputStream& inputStream, std::wstring_view packageFilename, PackedFileList& outPackedFiles, bool showErrors)
 {
 	std::vector<uint8> content;
 	content.resize(PackageHeader::HEADER_SIZE);
@@ -164,7 +298,7 @@ bool FilePackage::loadPackageInternal(InputStream& inputStream, std::wstring_vie
 	{
 		if (showErrors)
 		{
-			if (header.mFormatVersion == PackageHeader::CURRENT_FORMAT_VERSION)
+			if (header.mFormatVersion != 0)
 			{
 				RMX_ERROR("Unsupported format version " << header.mFormatVersion << " of file '" << WString(packageFilename).toStdString() << "'", );
 			}
@@ -176,35 +310,60 @@ bool FilePackage::loadPackageInternal(InputStream& inputStream, std::wstring_vie
 		return false;
 	}
 
+	// Each entry needs more than a single byte, so this is a cheap check against broken headers
+	if (header.mNumEntries > (size_t)header.mEntryHeaderSize)
+		return false;
+
 	// Load table of contents
 	content.resize(PackageHeader::HEADER_SIZE + header.mEntryHeaderSize);
 	if (inputStream.read(&content[PackageHeader::HEADER_SIZE], header.mEntryHeaderSize) != header.mEntryHeaderSize)
 		return false;
 
 	// Read entry headers
-	for (size_t i = 0; i < header.mNumEntries; ++i)
+	outPackedFiles.clear();
+	outPackedFiles.resize(header.mNumEntries);
+	for (PackedFile& packedFile : outPackedFiles)
 	{
-		std::wstring key;
-		serializer.serialize(key, 1024);
-		PackedFile& packedFile = outPackedFiles[key];
-		packedFile.mPath = key;
-		packedFile.mPositionInFile = serializer.read<uint32>();
-		packedFile.mSizeInFile = serializer.read<uint32>();
+		if (header.mFormatVersion >= 4)
+		{
+			packedFile.mPathHash = serializer.read<uint64>();
+			serializer.serialize(packedFile.mPath, 1024);
+			packedFile.mPositionInFile = serializer.read<uint32>();
+			packedFile.mSizeInFile = serializer.read<uint32>();
+			packedFile.mUncompressedSize = serializer.read<uint32>();
+			packedFile.mCompression = (Compression)serializer.read<uint8>();
+			packedFile.mContentHash = serializer.read<uint64>();
+			RMX_CHECK(packedFile.mCompression <= Compression::DEFLATE, "Unsupported compression type for entry '" << WString(packedFile.mPath).toStdString() << "' in file '" << WString(packageFilename).toStdString() << "'", outPackedFiles.clear(); return false);
+		}
+		else
+		{
+			serializer.serialize(packedFile.mPath, 1024);
+			packedFile.mPathHash = getPathHash(packedFile.mPath);
+			packedFile.mPositionInFile = serializer.read<uint32>();
+			packedFile.mSizeInFile = serializer.read<uint32>();
+			packedFile.mUncompressedSize = packedFile.mSizeInFile;
+		}
 	}
 
+	// Older packages are sorted by path instead, so they need sorting here
+	if (header.mFormatVersion < 4)
+	{
+		sortPackedFiles(outPackedFiles);
+	}
 	return true;
 }
 
 bool FilePackage::readPackageHeader(PackageHeader& outHeader, VectorBinarySerializer& serializer)
 {
 	// Read header
+	outHeader.mFormatVersion = 0;
 	char signature[4];
 	serializer.read(signature, 4);
 	if (memcmp(signature, PackageHeader::SIGNATURE, 4) != 0)
 		return false;
 
 	outHeader.mFormatVersion = serializer.read<uint32>();
-	if (outHeader.mFormatVersion != PackageHeader::CURRENT_FORMAT_VERSION)
+	if (outHeader.mFormatVersion < PackageHeader::MIN_SUPPORTED_FORMAT_VERSION || outHeader.mFormatVersion > PackageHeader::CURRENT_FORMAT_VERSION)
 		return false;
 
 	outHeader.mContentVersion = serializer.read<uint32>();
@@ -214,3 +373,8 @@ bool FilePackage::readPackageHeader(PackageHeader& outHeader, VectorBinarySerial
 	RMX_ASSERT(serializer.getReadPosition() == PackageHeader::HEADER_SIZE, "Got wrong package header size");
 	return true;
 }
+
+void FilePackage::sortPackedFiles(PackedFileList& packedFiles)
+{
+	std::sort(packedFiles.begin(), packedFiles.end(), [](const PackedFile& a, const PackedFile& b) { return (a.mPathHash != b.mPathHash) ? (a.mPathHash < b.mPathHash) : (a.mPath < b.mPath); });
+}
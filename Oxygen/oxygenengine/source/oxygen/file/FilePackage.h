@@ -14,19 +14,33 @@
 class FilePackage
 {
 public:
+	enum class Compression : uint8
+	{
+		NONE	= 0,
+		DEFLATE	= 1
+	};
+
 	struct PackedFile
 	{
 		std::wstring mPath;
+		uint64 mPathHash = 0;
 		uint32 mPositionInFile = 0;
-		uint32 mSizeInFile = 0;
+		uint32 mSizeInFile = 0;			// Size of the stored data, i.e. the compressed size for compressed entries
+		uint32 mUncompressedSize = 0;
+		Compression mCompression = Compression::NONE;
+		uint64 mContentHash = 0;		// Hash of the uncompressed content, only stored since format version 4
 		bool mLoadedContent = false;
-		std::vector<uint8> mContent;
+		std::vector<uint8> mContent;	// Always the uncompressed content
 	};
 
+	// Table of contents, sorted by path hash (and path for the unlikely case of hash collisions)
+	typedef std::vector<PackedFile> PackedFileList;
+
 	struct PackageHeader
 	{
 		static const constexpr char SIGNATURE[] = "OPCK";
-		static const constexpr uint32 CURRENT_FORMAT_VERSION = 3;
+		static const constexpr uint32 CURRENT_FORMAT_VERSION = 4;
+		static const constexpr uint32 MIN_SUPPORTED_FORMAT_VERSION = 3;
 		static const constexpr size_t HEADER_SIZE = 20;
 
 		uint32 mFormatVersion = CURRENT_FORMAT_VERSION;
@@ -36,10 +50,18 @@ public:
 	};
 
 public:
-	static bool loadPackage(std::wstring_view packageFilename, std::map<std::wstring, PackedFile>& outPackedFiles, bool forceLoadAll, bool showErrors = true);
+	static bool loadPackage(std::wstring_view packageFilename, PackedFileList& outPackedFiles, bool forceLoadAll, bool showErrors = true);
+	static bool loadPackageFromMemory(const uint8* data, size_t size, std::wstring_view packageFilename, PackedFileList& outPackedFiles, bool showErrors = true);
 	static void createFilePackage(const std::wstring& packageFilename, const std::wstring& basePath, const std::vector<std::wstring>& includedPaths, const std::vector<std::wstring>& excludedPaths, const std::wstring& comparisonPath, uint32 contentVersion, bool forceReplace = false);
 
+	static PackedFile* findPackedFile(PackedFileList& packedFiles, std::wstring_view path);
+	static bool decodeContent(const PackedFile& packedFile, const uint8* storedData, std::vector<uint8>& outContent);
+
+	static uint64 getPathHash(std::wstring_view path);
+	static uint64 getContentHash(const uint8* data, size_t size);
+
 private:
-	static bool loadPackageInternal(InputStream& inputStream, std::wstring_view packageFilename, std::map<std::wstring, PackedFile>& outPackedFiles, bool showErrors = true);
+	static bool loadPackageInternal(InputStream& inputStream, std::wstring_view packageFilename, PackedFileList& outPackedFiles, bool showErrors = true);
 	static bool readPackageHeader(PackageHeader& outHeader, VectorBinarySerializer& serializer);
+	static void sortPackedFiles(PackedFileList& packedFiles);
 };
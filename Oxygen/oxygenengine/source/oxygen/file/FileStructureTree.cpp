@@ -14,7 +14,7 @@ uint64 FileStructureTree::getLowercaseStringHash(const wchar_t* string, size_t l
 {
 	// Get hash of the lowercase version of the input string, to allow for case insensitive comparisons
 	// Note: This can produce different hashes on different platforms
-	static std::vector<wchar_t> lowercaseString;
+	static thread_local std::vector<wchar_t> lowercaseString;
 	lowercaseString.resize(std::max<size_t>(1, length));
 	for (size_t k = 0; k < length; ++k)
 	{
@@ -242,6 +242,36 @@ bool FileStructureTree::listDirectories(std::vector<std::wstring>& outDirectorie
 	return true;
 }
 
+void FileStructureTree::listAllPaths(std::vector<std::wstring>& outPaths) const
+{
+	// Go through all directories, starting with the root
+	std::vector<std::pair<int, std::wstring>> openDirectories;
+	openDirectories.emplace_back(0, std::wstring());
+
+	while (!openDirectories.empty())
+	{
+		const int directoryNodeIndex = openDirectories.back().first;
+		const std::wstring directoryPath = std::move(openDirectories.back().second);
+		openDirectories.pop_back();
+
+		int nodeIndex = mNodes[directoryNodeIndex].mChildFileIndex;
+		while (nodeIndex != -1)
+		{
+			outPaths.emplace_back(directoryPath + mNodes[nodeIndex].mName);
+			nodeIndex = mNodes[nodeIndex].mNextSiblingIndex;
+		}
+
+		nodeIndex = mNodes[directoryNodeIndex].mChildDirectoryIndex;
+		while (nodeIndex != -1)
+		{
+			std::wstring path = directoryPath + mNodes[nodeIndex].mName + L'/';
+			outPaths.emplace_back(path);
+			openDirectories.emplace_back(nodeIndex, std::move(path));
+			nodeIndex = mNodes[nodeIndex].mNextSiblingIndex;
+		}
+	}
+}
+
 bool FileStructureTree::listEntriesInternal(std::vector<const Entry*>& outEntries, const std::wstring& directoryPath, bool listFiles) const
 {
 	size_t fileNameStartPos;
@@ -38,6 +38,7 @@ public:
 	bool listFilesByMask(std::vector<const Entry*>& outFiles, const std::wstring& filemask, bool recursive) const;
 	bool listDirectories(std::vector<const Entry*>& outDirectories, const std::wstring& directoryPath) const;
 	bool listDirectories(std::vector<std::wstring>& outDirectories, const std::wstring& directoryPath) const;
+	void listAllPaths(std::vector<std::wstring>& outPaths) const;		// Lists all files and directories, with directory paths ending with a slash
 
 private:
 	bool listEntriesInternal(std::vector<const Entry*>& outEntries, const std::wstring& directoryPath, bool listFiles) const;
@@ -56,5 +57,5 @@ private:
 	};
 	std::vector<Node> mNodes;
 
-	mutable std::vector<const Entry*> mTempBuffer;		// For temporary internal use
+	mutable std::vector<const Entry*> mTempBuffer;		// For temporary internal use, i.e. const methods using it are not thread-safe
 };
@@ -29,7 +29,7 @@ struct PackedFileProvDetail
 					const size_t slashPosition = packedFile.mPath.find_last_of(L"/\\");
 					fileEntry.mFilename = (slashPosition == std::wstring::npos) ? packedFile.mPath : packedFile.mPath.substr(slashPosition + 1);
 					fileEntry.mPath = (slashPosition == std::wstring::npos) ? L"" : packedFile.mPath.substr(0, slashPosition + 1);
-					fileEntry.mSize = packedFile.mContent.size();
+					fileEntry.mSize = packedFile.mUncompressedSize;
 				}
 			}
 		}
@@ -37,12 +37,13 @@ struct PackedFileProvDetail
 };
 
 
-// At the moment, this class is not really necessary, as the provider never invalidates its created input streams.
+// Reads from memory owned by the provider, i.e. either the mapped package or cached content
+//  -> Gets invalidated when the provider gets destroyed
 class PackedFileInputStream : public MemInputStream
 {
 public:
 	inline PackedFileInputStream(PackedFileProvider& provider, const void* data, size_t size) : MemInputStream(data, size), mProvider(provider) {}
-	inline ~PackedFileInputStream() { mProvider.unregisterPackedFileInputStream(*this); }
+	inline ~PackedFileInputStream() { if (mIsValid) mProvider.unregisterPackedFileInputStream(*this); }
 
 	inline bool valid() const override				{ return mIsValid && MemInputStream::valid(); }
 	inline const char* getType() const override		{ return "packed"; }
@@ -74,7 +75,8 @@ public:
 
 	inline ~StreamingPackedFileInputStream()
 	{
-		mProvider.unregisterStreamingPackedFileInputStream(*this);
+		if (mIsValid)
+			mProvider.unregisterStreamingPackedFileInputStream(*this);
 		delete &mBaseInputStream;
 	}
 
@@ -107,6 +109,8 @@ struct PackedFileProvider::Internal
 {
 	FileStructureTree mFileStructureTree;
 	std::vector<const FileStructureTree::Entry*> mEntriesBuffer;
+	MemoryMappedFile mMappedFile;		// Only open if the package could get mapped into memory, in which case the cache type does not matter
+	std::mutex mMutex;					// Guards the cached contents, the entries buffer and the managed input streams; not needed for reading uncompressed entries from the mapped package
 };
 
 
@@ -135,17 +139,32 @@ PackedFileProvider::PackedFileProvider(std::wstring_view packageFilename, CacheT
 	mPackageFilename = packageFilename;
 	mCacheType = cacheType;
 
+	// Prefer mapping the package into memory, so that entries can be read without any file access or extra buffers
+	MemoryMappedFile& mappedFile = mInternal.mMappedFile;
+	if (mappedFile.open(packageFilename))
+	{
+		mLoaded = FilePackage::loadPackageFromMemory(mappedFile.getData(), mappedFile.getSize(), packageFilename, mPackedFiles, false);
+		if (!mLoaded)
+		{
+			// Let the regular loading below output the error, if there is one
+			mappedFile.close();
+		}
+	}
+
 	// Load the package if there is one
-	const bool forceLoadAll = (mCacheType == CacheType::CACHE_EVERYTHING);
-	mLoaded = FilePackage::loadPackage(packageFilename, mPackedFiles, forceLoadAll);
+	if (!mLoaded)
+	{
+		const bool forceLoadAll = (mCacheType == CacheType::CACHE_EVERYTHING);
+		mLoaded = FilePackage::loadPackage(packageFilename, mPackedFiles, forceLoadAll);
+	}
+
 	if (mLoaded)
 	{
-		RMX_LOG_INFO("Loaded file package '" << WString(packageFilename).toStdString() << "' with " << mPackedFiles.size() << " entries");
+		RMX_LOG_INFO("Loaded file package '" << WString(packageFilename).toStdString() << "' with " << mPackedFiles.size() << " entries" << (mappedFile.isOpen() ? " (memory-mapped)" : ""));
 
 		// Setup file structure tree
-		for (const auto& pair : mPackedFiles)
+		for (const PackedFile& packedFile : mPackedFiles)
 		{
-			const PackedFile& packedFile = pair.second;
 			mInternal.mFileStructureTree.insertPath(packedFile.mPath, (void*)&packedFile);
 		}
 		mInternal.mFileStructureTree.sortTreeNodes();
@@ -158,16 +177,23 @@ PackedFileProvider::PackedFileProvider(std::wstring_view packageFilename, CacheT
 
 PackedFileProvider::~PackedFileProvider()
 {
+	// Input streams may outlive the provider, and must not access the unmapped memory or cached contents any more
+	{
+		std::lock_guard<std::mutex> lock(mInternal.mMutex);
+		invalidateAllPackedFileInputStreams();
+	}
 	delete &mInternal;
 }
 
 void PackedFileProvider::unregisterPackedFileInputStream(PackedFileInputStream& packedFileInputStream)
 {
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
 	mPackedFileInputStreams.erase(&packedFileInputStream);
 }
 
 void PackedFileProvider::unregisterStreamingPackedFileInputStream(StreamingPackedFileInputStream& packedFileInputStream)
 {
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
 	mStreamingPackedFileInputStreams.erase(&packedFileInputStream);
 }
 
@@ -185,11 +211,19 @@ bool PackedFileProvider::readFile(const std::wstring& filename, std::vector<uint
 	PackedFile* packedFile = findPackedFile(filename);
 	if (nullptr != packedFile)
 	{
+		const uint8* mappedContent = getMappedContent(*packedFile);
+		if (nullptr != mappedContent && packedFile->mCompression == FilePackage::Compression::NONE)
+		{
+			// Single copy straight from the mapped package
+			outData.assign(mappedContent, mappedContent + packedFile->mSizeInFile);
+			return true;
+		}
+
+		std::lock_guard<std::mutex> lock(mInternal.mMutex);
 		if (packedFile->mLoadedContent)
 		{
 			// Copy over the already cache content
-			outData.resize(packedFile->mContent.size());
-			memcpy(&outData[0], &packedFile->mContent[0], packedFile->mContent.size());
+			outData.assign(packedFile->mContent.begin(), packedFile->mContent.end());
 		}
 		else
 		{
@@ -201,8 +235,7 @@ bool PackedFileProvider::readFile(const std::wstring& filename, std::vector<uint
 			else
 			{
 				loadPackedFile(*packedFile);
-				outData.resize(packedFile->mContent.size());
-				memcpy(&outData[0], &packedFile->mContent[0], packedFile->mContent.size());
+				outData.assign(packedFile->mContent.begin(), packedFile->mContent.end());
 			}
 		}
 		return true;
@@ -210,11 +243,38 @@ bool PackedFileProvider::readFile(const std::wstring& filename, std::vector<uint
 	return false;
 }
 
+bool PackedFileProvider::getFileView(const std::wstring& filename, rmx::FileView& outFileView)
+{
+	const PackedFile* packedFile = findPackedFile(filename);
+	if (nullptr == packedFile)
+		return false;
+
+	// Compressed entries can't be viewed directly, unless they got cached already
+	const uint8* mappedContent = getMappedContent(*packedFile);
+	if (nullptr != mappedContent && packedFile->mCompression == FilePackage::Compression::NONE)
+	{
+		outFileView.mData = mappedContent;
+		outFileView.mSize = (size_t)packedFile->mSizeInFile;
+		return true;
+	}
+
+	// Cached content does not change any more once loaded, so the view stays valid outside of the lock
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
+	if (packedFile->mLoadedContent)
+	{
+		outFileView.mData = packedFile->mContent.data();
+		outFileView.mSize = packedFile->mContent.size();
+		return true;
+	}
+	return false;
+}
+
 bool PackedFileProvider::listFiles(const std::wstring& path, bool recursive, std::vector<rmx::FileIO::FileEntry>& outFileEntries)
 {
 	if (mPackedFiles.empty())
 		return false;
 
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
 	mInternal.mEntriesBuffer.clear();
 	if (!mInternal.mFileStructureTree.listFiles(mInternal.mEntriesBuffer, path))
 		return false;
@@ -228,6 +288,7 @@ bool PackedFileProvider::listFilesByMask(const std::wstring& filemask, bool recu
 	if (mPackedFiles.empty())
 		return false;
 
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
 	mInternal.mEntriesBuffer.clear();
 	if (!mInternal.mFileStructureTree.listFilesByMask(mInternal.mEntriesBuffer, filemask, recursive))
 		return false;
@@ -241,15 +302,26 @@ bool PackedFileProvider::listDirectories(const std::wstring& path, std::vector<s
 	if (mPackedFiles.empty())
 		return false;
 
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
 	return mInternal.mFileStructureTree.listDirectories(outDirectories, path);
 }
 
+bool PackedFileProvider::listAllPaths(std::vector<std::wstring>& outPaths)
+{
+	if (!mLoaded)
+		return false;
+
+	mInternal.mFileStructureTree.listAllPaths(outPaths);
+	return true;
+}
+
 InputStream* PackedFileProvider::createInputStream(const std::wstring& filename)
 {
 	// Try to first read from package
 	PackedFile* packedFile = findPackedFile(filename);
 	if (nullptr != packedFile)
 	{
+		std::lock_guard<std::mutex> lock(mInternal.mMutex);
 		return createPackedFileInputStream(*packedFile);
 	}
 	return nullptr;
@@ -257,15 +329,13 @@ InputStream* PackedFileProvider::createInputStream(const std::wstring& filename)
 
 PackedFileProvider::PackedFile* PackedFileProvider::findPackedFile(const std::wstring& filename)
 {
-	if (!mPackedFiles.empty())
-	{
-		const auto it = mPackedFiles.find(filename);
-		if (it != mPackedFiles.end())
-		{
-			return &it->second;
-		}
-	}
-	return nullptr;
+	return FilePackage::findPackedFile(mPackedFiles, filename);
+}
+
+const uint8* PackedFileProvider::getMappedContent(const PackedFile& packedFile) const
+{
+	// Entry ranges were already checked against the mapped size when loading the package
+	return mInternal.mMappedFile.isOpen() ? (mInternal.mMappedFile.getData() + packedFile.mPositionInFile) : nullptr;
 }
 
 void PackedFileProvider::loadPackedFile(PackedFile& packedFile)
@@ -282,6 +352,12 @@ void PackedFileProvider::loadPackedFile(PackedFile& packedFile)
 
 bool PackedFileProvider::loadPackedFile(PackedFile& packedFile, std::vector<uint8>& outData)
 {
+	const uint8* mappedContent = getMappedContent(packedFile);
+	if (nullptr != mappedContent)
+	{
+		return FilePackage::decodeContent(packedFile, mappedContent, outData);
+	}
+
 	InputStream* inputStream = FTX::FileSystem->createInputStream(mPackageFilename);
 	if (nullptr == inputStream)
 	{
@@ -289,18 +365,34 @@ bool PackedFileProvider::loadPackedFile(PackedFile& packedFile, std::vector<uint
 		return false;
 	}
 
-	outData.resize((size_t)packedFile.mSizeInFile);
+	// Uncompressed data can be read directly into the output
+	std::vector<uint8> compressedData;
+	std::vector<uint8>& storedData = (packedFile.mCompression == FilePackage::Compression::NONE) ? outData : compressedData;
+	storedData.resize((size_t)packedFile.mSizeInFile);
 	inputStream->setPosition(packedFile.mPositionInFile);
-	const size_t bytesRead = inputStream->read(&outData[0], outData.size());
+	const size_t bytesRead = storedData.empty() ? 0 : inputStream->read(&storedData[0], storedData.size());
 	delete inputStream;
 
 	RMX_CHECK(packedFile.mSizeInFile == bytesRead, "Failed to load entry '" << WString(packedFile.mPath).toStdString() << "' from package '" << WString(mPackageFilename).toStdString() << "'", return false);
+	if (packedFile.mCompression != FilePackage::Compression::NONE)
+	{
+		return FilePackage::decodeContent(packedFile, compressedData.data(), outData);
+	}
 	return true;
 }
 
 InputStream* PackedFileProvider::createPackedFileInputStream(PackedFile& packedFile)
 {
-	if (mCacheType == CacheType::NO_CACHING)
+	const bool isCompressed = (packedFile.mCompression != FilePackage::Compression::NONE);
+	const uint8* mappedContent = getMappedContent(packedFile);
+	if (nullptr != mappedContent && !isCompressed)
+	{
+		// Read directly from the mapped package, without any copy
+		PackedFileInputStream* inputStream = new PackedFileInputStream(*this, mappedContent, (size_t)packedFile.mSizeInFile);
+		mPackedFileInputStreams.insert(inputStream);
+		return inputStream;
+	}
+	else if (mCacheType == CacheType::NO_CACHING && !isCompressed)
 	{
 		InputStream* baseInputStream = FTX::FileSystem->createInputStream(mPackageFilename);
 		if (nullptr == baseInputStream)
@@ -315,7 +407,11 @@ InputStream* PackedFileProvider::createPackedFileInputStream(PackedFile& packedF
 	}
 	else
 	{
+		// Compressed entries always get cached, as there's no way around decompressing them as a whole anyways
 		loadPackedFile(packedFile);
+		if (!packedFile.mLoadedContent)
+			return nullptr;
+
 		PackedFileInputStream* inputStream = new PackedFileInputStream(*this, &packedFile.mContent[0], packedFile.mContent.size());
 		mPackedFileInputStreams.insert(inputStream);
 		return inputStream;
@@ -41,13 +41,16 @@ public:
 
 	bool exists(const std::wstring& path) override;
 	bool readFile(const std::wstring& filename, std::vector<uint8>& outData) override;
+	bool getFileView(const std::wstring& filename, rmx::FileView& outFileView) override;
 	bool listFiles(const std::wstring& path, bool recursive, std::vector<rmx::FileIO::FileEntry>& outFileEntries) override;
 	bool listFilesByMask(const std::wstring& filemask, bool recursive, std::vector<rmx::FileIO::FileEntry>& outFileEntries) override;
 	bool listDirectories(const std::wstring& path, std::vector<std::wstring>& outDirectories) override;
+	bool listAllPaths(std::vector<std::wstring>& outPaths) override;
 	InputStream* createInputStream(const std::wstring& filename) override;
 
 private:
 	PackedFile* findPackedFile(const std::wstring& filename);
+	const uint8* getMappedContent(const PackedFile& packedFile) const;	// Returns the stored, i.e. possibly compressed data
 	void loadPackedFile(PackedFile& packedFile);
 	bool loadPackedFile(PackedFile& packedFile, std::vector<uint8>& outData);
 	InputStream* createPackedFileInputStream(PackedFile& packedFile);
@@ -59,7 +62,7 @@ private:
 
 	CacheType mCacheType = CacheType::NO_CACHING;
 	std::wstring mPackageFilename;
-	std::map<std::wstring, PackedFile> mPackedFiles;
+	FilePackage::PackedFileList mPackedFiles;
 	bool mLoaded = false;
 
 	// Managed input streams created in "createInputStream" calls
@@ -230,6 +230,7 @@ struct ZipFileProvider::Internal
 	unz_global_info64 mGlobalInfo;
 	FileStructureTree mFileStructureTree;
 	std::vector<const FileStructureTree::Entry*> mEntriesBuffer;
+	std::mutex mMutex;		// Guards the zip file access and the entries buffer
 };
 
 
@@ -302,6 +303,7 @@ bool ZipFileProvider::listFiles(const std::wstring& path, bool recursive, std::v
 	if (mContainedFiles.empty())
 		return false;
 
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
 	mInternal.mEntriesBuffer.clear();
 	if (!mInternal.mFileStructureTree.listFiles(mInternal.mEntriesBuffer, path))
 		return false;
@@ -315,6 +317,7 @@ bool ZipFileProvider::listFilesByMask(const std::wstring& filemask, bool recursi
 	if (mContainedFiles.empty())
 		return false;
 
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
 	mInternal.mEntriesBuffer.clear();
 	if (!mInternal.mFileStructureTree.listFilesByMask(mInternal.mEntriesBuffer, filemask, recursive))
 		return false;
@@ -328,9 +331,19 @@ bool ZipFileProvider::listDirectories(const std::wstring& path, std::vector<std:
 	if (mContainedFiles.empty())
 		return false;
 
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
 	return mInternal.mFileStructureTree.listDirectories(outDirectories, path);
 }
 
+bool ZipFileProvider::listAllPaths(std::vector<std::wstring>& outPaths)
+{
+	if (!mLoaded)
+		return false;
+
+	mInternal.mFileStructureTree.listAllPaths(outPaths);
+	return true;
+}
+
 InputStream* ZipFileProvider::createInputStream(const std::wstring& filename)
 {
 	const ContainedFile* containedFile = readFile(filename);
@@ -416,6 +429,8 @@ const ZipFileProvider::ContainedFile* ZipFileProvider::readFile(const std::wstri
 	if (nullptr == containedFile)
 		return nullptr;
 
+	// Once loaded, the cached content does not change any more, so it can be used outside of the lock
+	std::lock_guard<std::mutex> lock(mInternal.mMutex);
 	const rmx::FileIO::FileEntry& fileEntry = containedFile->mFileEntry;
 	if (!containedFile->mContent.empty() || fileEntry.mSize == 0)
 	{
@@ -26,6 +26,7 @@ public:
 	bool listFiles(const std::wstring& path, bool recursive, std::vector<rmx::FileIO::FileEntry>& outFileEntries) override;
 	bool listFilesByMask(const std::wstring& filemask, bool recursive, std::vector<rmx::FileIO::FileEntry>& outFileEntries) override;
 	bool listDirectories(const std::wstring& path, std::vector<std::wstring>& outDirectories) override;
+	bool listAllPaths(std::vector<std::wstring>& outPaths) override;
 	InputStream* createInputStream(const std::wstring& filename) override;
 
 private:
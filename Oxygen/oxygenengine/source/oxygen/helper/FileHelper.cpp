@@ -113,8 +113,10 @@ bool FileHelper::loadPaletteBitmap(PaletteBitmap& bitmap, const std::wstring& fi
 
 bool FileHelper::loadBitmap(Bitmap& bitmap, const std::wstring& filename, bool showError)
 {
+	// Decode directly from the file package if possible, without copying the file content first
+	rmx::FileView fileView;
 	std::vector<uint8> content;
-	if (!FTX::FileSystem->readFile(filename, content))
+	if (!FTX::FileSystem->readFileView(filename, fileView, content))
 	{
 		RMX_CHECK(!showError, "Failed to load image file '" << *WString(filename).toString() << "': File not found", );
 		return false;
@@ -129,7 +131,7 @@ bool FileHelper::loadBitmap(Bitmap& bitmap, const std::wstring& filename, bool s
 		format = fname.getSubString(pos+1, -1).toString();
 	}
 
-	MemInputStream stream(&content[0], (int)content.size());
+	MemInputStream stream(fileView.mData, fileView.mSize);
 	Bitmap::LoadResult loadResult;
 	if (!bitmap.decode(stream, loadResult, *format))
 	{
@@ -147,6 +147,11 @@ Profiling::Region& Profiling::getRootRegion()
 	return mRootRegion;
 }
 
+Profiling::Region* Profiling::getRegion(uint16 id)
+{
+	return getRegionByID(id);
+}
+
 void Profiling::listRegionsRecursive(std::vector<std::pair<Region*, int>>& outRegions)
 {
 	outRegions.clear();
@@ -85,6 +85,7 @@ public:
 	static void nextFrame(int simulationFrameNumber);
 
 	static Region& getRootRegion();
+	static Region* getRegion(uint16 id);
 	static void listRegionsRecursive(std::vector<std::pair<Region*,int>>& outRegions);
 
 	static AdditionalData& getAdditionalData();
@@ -130,3 +130,51 @@ private:
 	std::vector<Entry*> mTable;
 	size_t mNumEntries = 0;
 };
+
+
+// Two-level page table for a direct mapping from keys to values, meant to be filled once and then used for lookups only
+//  -> A lookup is just two loads, with keys in unused pages all referring to a shared page of default values
+template<typename VALUE, int TABLESIZE, int PAGE_SHIFT>
+class PageTableLookup
+{
+public:
+	inline PageTableLookup()
+	{
+		clear();
+	}
+
+	inline void clear()
+	{
+		mPageIndices.assign(TABLESIZE >> PAGE_SHIFT, 0);
+		mValues.assign(PAGE_SIZE, VALUE());		// Page 0 is the shared empty page
+	}
+
+	inline bool set(uint32 key, VALUE value)
+	{
+		if (key >= (uint32)TABLESIZE)
+			return false;
+
+		uint32& pageIndex = mPageIndices[key >> PAGE_SHIFT];
+		if (pageIndex == 0)
+		{
+			pageIndex = (uint32)(mValues.size() >> PAGE_SHIFT);
+			mValues.resize(mValues.size() + PAGE_SIZE, VALUE());
+		}
+		mValues[(pageIndex << PAGE_SHIFT) + (key & PAGE_MASK)] = value;
+		return true;
+	}
+
+	inline VALUE get(uint32 key) const
+	{
+		if (key >= (uint32)TABLESIZE)
+			return VALUE();
+		return mValues[(mPageIndices[key >> PAGE_SHIFT] << PAGE_SHIFT) + (key & PAGE_MASK)];
+	}
+
+private:
+	static const uint32 PAGE_SIZE = 1 << PAGE_SHIFT;
+	static const uint32 PAGE_MASK = PAGE_SIZE - 1;
+
+	std::vector<uint32> mPageIndices;
+	std::vector<VALUE> mValues;
+};
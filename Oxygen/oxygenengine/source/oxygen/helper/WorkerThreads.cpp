@@ -0,0 +1,116 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "oxygen/pch.h"
+#include "oxygen/helper/WorkerThreads.h"
+
+
+size_t WorkerThreads::getDefaultNumThreads()
+{
+#if defined(PLATFORM_WEB)
+	return 0;
+#else
+	const size_t hardwareThreads = (size_t)std::thread::hardware_concurrency();
+	return (hardwareThreads > 1) ? (hardwareThreads - 1) : 0;
+#endif
+}
+
+WorkerThreads::~WorkerThreads()
+{
+	setNumThreads(0);
+}
+
+void WorkerThreads::setNumThreads(size_t numThreads)
+{
+	if (numThreads == mThreads.size())
+		return;
+
+	// Stop all running threads first
+	if (!mThreads.empty())
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mShutdown = true;
+		}
+		mWakeCondition.notify_all();
+		for (std::thread& thread : mThreads)
+			thread.join();
+		mThreads.clear();
+		mShutdown = false;
+	}
+
+#if !defined(PLATFORM_WEB)
+	mThreads.reserve(numThreads);
+	for (size_t k = 0; k < numThreads; ++k)
+	{
+		mThreads.emplace_back(&WorkerThreads::runWorkerThread, this, mGeneration);
+	}
+#endif
+}
+
+void WorkerThreads::runJobs(size_t numJobs, const JobFunction& function)
+{
+	if (mThreads.empty() || numJobs <= 1)
+	{
+		// No need for any synchronization
+		for (size_t index = 0; index < numJobs; ++index)
+			function(index);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mFunction = &function;
+		mNumJobs = numJobs;
+		mNextJob = 0;
+		mRunningThreads = mThreads.size();
+		++mGeneration;
+	}
+	mWakeCondition.notify_all();
+
+	// Take part in the work on this thread as well
+	processJobs();
+
+	// Wait until all worker threads are done
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDoneCondition.wait(lock, [this] { return mRunningThreads == 0; });
+	mFunction = nullptr;
+}
+
+void WorkerThreads::runWorkerThread(uint32 lastGeneration)
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWakeCondition.wait(lock, [&] { return mShutdown || mGeneration != lastGeneration; });
+			if (mShutdown)
+				return;
+			lastGeneration = mGeneration;
+		}
+
+		processJobs();
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			--mRunningThreads;
+		}
+		mDoneCondition.notify_one();
+	}
+}
+
+void WorkerThreads::processJobs()
+{
+	while (true)
+	{
+		const size_t index = mNextJob.fetch_add(1);
+		if (index >= mNumJobs)
+			break;
+		(*mFunction)(index);
+	}
+}
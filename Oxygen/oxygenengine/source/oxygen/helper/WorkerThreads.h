@@ -0,0 +1,54 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+#include <rmxbase.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+// Small pool of persistent worker threads, for splitting up work that has to be done e.g. once per frame
+//  -> The calling thread takes part in the work as well, so e.g. 3 worker threads means up to 4 jobs running in parallel
+class WorkerThreads
+{
+public:
+	typedef std::function<void(size_t)> JobFunction;
+
+public:
+	static size_t getDefaultNumThreads();	// Returns the number of hardware threads minus one for the calling thread
+
+public:
+	~WorkerThreads();
+
+	inline size_t getNumThreads() const  { return mThreads.size(); }
+	void setNumThreads(size_t numThreads);
+
+	// Calls the function once for each job index from 0 to numJobs-1, and returns only after all jobs are done
+	void runJobs(size_t numJobs, const JobFunction& function);
+
+private:
+	void runWorkerThread(uint32 lastGeneration);
+	void processJobs();
+
+private:
+	std::vector<std::thread> mThreads;
+	std::mutex mMutex;
+	std::condition_variable mWakeCondition;
+	std::condition_variable mDoneCondition;
+	uint32 mGeneration = 0;
+	size_t mRunningThreads = 0;
+	bool mShutdown = false;
+
+	const JobFunction* mFunction = nullptr;
+	size_t mNumJobs = 0;
+	std::atomic<size_t> mNextJob = 0;
+};
@@ -258,6 +258,16 @@ void NetworkingWindow::buildContent()
 				ImGui::BulletText("Netplay latency:  %d frames", netplayClient->getCurrentLatency());
 			}
 		}
+
+		const NetplayRollback& rollback = netplayManager.getRollback();
+		if (rollback.isEnabled())
+		{
+			const NetplayRollback::Statistics& statistics = rollback.getStatistics();
+			ImGui::Text("Rollback window:  %d frames", rollback.getRollbackWindow());
+			ImGui::BulletText("Predicted frames:  %u, mispredicted inputs:  %u", statistics.mPredictedFrames, statistics.mMispredictions);
+			ImGui::BulletText("Rollbacks:  %u, re-simulated frames:  %u, max. depth:  %u frames", statistics.mRollbacks, statistics.mResimulatedFrames, statistics.mMaxRollbackFrames);
+			ImGui::BulletText("Last rollback took %.2f ms, failed rollbacks:  %u", statistics.mLastRollbackTime, statistics.mFailedRollbacks);
+		}
 	}
 }
 
@@ -153,14 +153,27 @@ void RenderedGeometryWindow::buildContent()
 					break;
 				}
 
-				case Geometry::Type::TEXTURED_RECT:
+				case Geometry::Type::TEXT:
 				{
-					const TexturedRectGeometry& tg = static_cast<const TexturedRectGeometry&>(*geometry);
-					typeString = "Textured rect / Text";
+					const TextGeometry& tg = static_cast<const TextGeometry&>(*geometry);
+					typeString.formatString("Text (%d glyphs)", (int)tg.getNumGlyphQuads());
 					color.setABGR32(0xffc0ffff);
-					position = tg.mRect.getPos();
-					size = tg.mRect.getSize();
-					highlightRect = tg.mRect;
+
+					// Bounding box of all glyphs
+					const GlyphAtlas::GlyphQuad* glyphQuads = tg.getGlyphQuads();
+					Vec2i boundsMin(+10000, +10000);
+					Vec2i boundsMax(-10000, -10000);
+					for (size_t k = 0; k < tg.getNumGlyphQuads(); ++k)
+					{
+						const Vec2i maxPos = glyphQuads[k].mPosition + glyphQuads[k].mAtlasRect.getSize();
+						boundsMin.x = std::min(boundsMin.x, glyphQuads[k].mPosition.x);
+						boundsMin.y = std::min(boundsMin.y, glyphQuads[k].mPosition.y);
+						boundsMax.x = std::max(boundsMax.x, maxPos.x);
+						boundsMax.y = std::max(boundsMax.y, maxPos.y);
+					}
+					position = boundsMin;
+					size = boundsMax - boundsMin;
+					highlightRect.set(position, size);
 					break;
 				}
 
@@ -127,8 +127,8 @@ bool NetplayClient::onReceivedGameServerPacket(ReceivedPacketEvaluation& evaluat
 
 bool NetplayClient::canBeginNextFrame(uint32 frameNumber)
 {
-	// Don't proceed beyond the latest received frame number
-	if (frameNumber >= mNextFrameNumber)
+	// Don't proceed beyond the latest received frame number, except for the frames that rollback may predict
+	if (frameNumber >= mNextFrameNumber + (uint32)mNetplayManager.getRollback().getRollbackWindow())
 		return false;
 
 	return true;
@@ -139,6 +139,12 @@ void NetplayClient::onFrameUpdate(ControlsIn& controlsIn, uint32 frameNumber)
 	if (mHostConnection.getState() != NetConnection::State::CONNECTED)
 		return;
 
+	if (mNetplayManager.getRollback().isEnabled())
+	{
+		updateFrameWithRollback(controlsIn, frameNumber);
+		return;
+	}
+
 	// Get current input state and send it to the host
 	{
 		PlayerInputIncrementPacket packet;
@@ -150,17 +156,10 @@ void NetplayClient::onFrameUpdate(ControlsIn& controlsIn, uint32 frameNumber)
 	}
 
 	// Inject input from what we received from host
-	if (!mReceivedFrames.empty())
+	const ReceivedFrame* receivedFrame = findReceivedFrame(frameNumber);
+	if (nullptr != receivedFrame)
 	{
-		const int indexFromBack = mNextFrameNumber - frameNumber - 1;
-		if (indexFromBack >= 0 && indexFromBack < (int)mReceivedFrames.size())
-		{
-			auto it = mReceivedFrames.rbegin();
-			for (int k = 0; k < indexFromBack; ++k)
-				++it;
-
-			controlsIn.injectInputs(it->mInputsByPlayer, MAX_PLAYERS);
-		}
+		controlsIn.injectInputs(receivedFrame->mInputsByPlayer, MAX_PLAYERS);
 	}
 }
 
@@ -217,6 +216,14 @@ bool NetplayClient::onReceivedPacket(ReceivedPacketEvaluation& evaluation)
 					mRegularInputChecksum = mInputChecksum;
 					mRegularChecksumFrameNumber = frameNumber;
 				}
+
+				// Compare with the inputs this frame got simulated with, if it was predicted already
+				NetplayRollback::FrameRecord* record = mNetplayManager.getRollback().findFrameRecord((uint32)frameNumber);
+				if (nullptr != record)
+				{
+					for (int playerIndex = 0; playerIndex < MAX_PLAYERS; ++playerIndex)
+						mNetplayManager.getRollback().confirmInput(*record, playerIndex, newFrame.mInputsByPlayer[playerIndex]);
+				}
 			}
 
 			mNextFrameNumber = packet.mFrameNumber + 1;
@@ -266,6 +273,11 @@ void NetplayClient::startGame(const StartGamePacket& packet)
 	VectorBinarySerializer serializer(true, packet.mSerializedGameSettings);
 	EngineMain::getDelegate().serializeGameSettings(serializer);
 
+	// Use the same rollback window as the host
+	mPlayerIndex = packet.mPlayerIndex;
+	mNetplayManager.getRollback().setup(packet.mRollbackWindow);
+	mLocalInputHistory.clear();
+
 	// Setup input checksum tracking
 	mInputChecksum = rmx::startFNV1a_32();
 	mRegularInputChecksum = mInputChecksum;
@@ -275,3 +287,62 @@ void NetplayClient::startGame(const StartGamePacket& packet)
 
 	EngineMain::getDelegate().onStartNetplayGame(false);
 }
+
+const NetplayClient::ReceivedFrame* NetplayClient::findReceivedFrame(uint32 frameNumber) const
+{
+	const int indexFromBack = mNextFrameNumber - frameNumber - 1;
+	if (indexFromBack < 0 || indexFromBack >= (int)mReceivedFrames.size())
+		return nullptr;
+
+	return &mReceivedFrames[mReceivedFrames.size() - 1 - indexFromBack];
+}
+
+void NetplayClient::updateFrameWithRollback(ControlsIn& controlsIn, uint32 frameNumber)
+{
+	NetplayRollback& rollback = mNetplayManager.getRollback();
+	NetplayRollback::FrameRecord& record = rollback.getFrameRecord(frameNumber);
+	const uint16 localInput = controlsIn.getInputFromController(0);
+
+	// When re-simulating, the frame keeps its inputs, including the corrected ones
+	if (!record.mSimulated)
+	{
+		const ReceivedFrame* receivedFrame = findReceivedFrame(frameNumber);
+		if (nullptr != receivedFrame)
+		{
+			// All inputs are confirmed by the host already
+			for (int playerIndex = 0; playerIndex < MAX_PLAYERS; ++playerIndex)
+				record.mInputsByPlayer[playerIndex] = receivedFrame->mInputsByPlayer[playerIndex];
+			record.mConfirmedPlayers = (1 << MAX_PLAYERS) - 1;
+		}
+		else
+		{
+			// Predict that other players keep their last confirmed input, and use our own local input
+			if (!mReceivedFrames.empty())
+			{
+				for (int playerIndex = 0; playerIndex < MAX_PLAYERS; ++playerIndex)
+					record.mInputsByPlayer[playerIndex] = mReceivedFrames.back().mInputsByPlayer[playerIndex];
+			}
+			if (mPlayerIndex < MAX_PLAYERS)
+				record.mInputsByPlayer[mPlayerIndex] = localInput;
+		}
+	}
+
+	rollback.applyFrameInputs(record, controlsIn, record.mConfirmedPlayers != (1 << MAX_PLAYERS) - 1);
+	if (rollback.isResimulating())
+		return;
+
+	// Send local inputs of the last frames to the host, so it can still correct its predictions if a packet got lost
+	if (frameNumber != mLocalInputFrameNumber + 1)
+		mLocalInputHistory.clear();
+	mLocalInputHistory.push_back(localInput);
+	mLocalInputFrameNumber = frameNumber;
+	while (mLocalInputHistory.size() > (size_t)rollback.getRollbackWindow())
+		mLocalInputHistory.pop_front();
+
+	PlayerInputIncrementPacket packet;
+	packet.mFrameNumber = frameNumber;
+	packet.mNumFrames = (uint8)mLocalInputHistory.size();
+	packet.mInputs.assign(mLocalInputHistory.begin(), mLocalInputHistory.end());
+
+	mHostConnection.sendPacket(packet, NetConnection::SendFlags::UNRELIABLE);
+}
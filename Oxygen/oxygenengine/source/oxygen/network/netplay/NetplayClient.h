@@ -68,6 +68,8 @@ private:
 
 private:
 	void startGame(const StartGamePacket& packet);
+	const ReceivedFrame* findReceivedFrame(uint32 frameNumber) const;
+	void updateFrameWithRollback(ControlsIn& controlsIn, uint32 frameNumber);
 
 private:
 	ConnectionManager& mConnectionManager;
@@ -82,6 +84,10 @@ private:
 	uint32 mNextFrameNumber = 0;
 	int mCurrentLatency = 0;
 
+	uint8 mPlayerIndex = 0;
+	std::deque<uint16> mLocalInputHistory;	// Only used with rollback: Local inputs of the last frames, to be sent to the host
+	uint32 mLocalInputFrameNumber = 0;
+
 	uint32 mInputChecksum = 0;
 	uint32 mRegularInputChecksum = 0;
 	int mRegularChecksumFrameNumber = 0;
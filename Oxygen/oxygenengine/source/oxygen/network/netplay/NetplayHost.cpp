@@ -11,6 +11,7 @@
 #include "oxygen/network/netplay/NetplayManager.h"
 #include "oxygen/network/EngineServerClient.h"
 #include "oxygen/application/Application.h"
+#include "oxygen/application/Configuration.h"
 #include "oxygen/application/input/ControlsIn.h"
 #include "oxygen/simulation/Simulation.h"
 #include "oxygen/simulation/SimulationState.h"
@@ -203,9 +204,15 @@ void NetplayHost::startGame()
 		EngineMain::getDelegate().serializeGameSettings(serializer);
 	}
 
+	// Setup rollback, clients will use the same window
+	NetplayRollback& rollback = mNetplayManager.getRollback();
+	rollback.setup(Configuration::instance().mNetplay.mRollbackWindow);
+	packet.mRollbackWindow = (uint8)rollback.getRollbackWindow();
+
 	// Send to players
 	for (PlayerConnection* connection : mPlayerConnections)
 	{
+		packet.mPlayerIndex = connection->mPlayerIndex;
 		connection->sendPacket(packet, NetConnection::SendFlags::NONE, &connection->mStartGamePacketID);
 	}
 
@@ -214,6 +221,9 @@ void NetplayHost::startGame()
 	mRegularInputChecksum = mInputChecksum;
 	mRegularChecksumFrameNumber = 0;
 
+	mInputHistory.clear();
+	mNextFinalizedFrame = 0;
+
 	mHostState = HostState::GAME_RUNNING;
 
 	EngineMain::getDelegate().onStartNetplayGame(true);
@@ -245,10 +255,15 @@ void NetplayHost::onFrameUpdate(ControlsIn& controlsIn, uint32 frameNumber)
 		}
 	}
 
+	if (mNetplayManager.getRollback().isEnabled())
+	{
+		updateFrameWithRollback(controlsIn, frameNumber, activeConnections);
+		return;
+	}
+
 	// Add new frame to the history
 	{
-		mInputHistory.emplace_back();
-		InputFrame& newInputFrame = mInputHistory.back();
+		InputFrame newInputFrame;
 
 		// Apply host's local input (local player 1 only)
 		newInputFrame.mInputsByPlayer[0] = controlsIn.getInputFromController(0);
@@ -263,17 +278,7 @@ void NetplayHost::onFrameUpdate(ControlsIn& controlsIn, uint32 frameNumber)
 			}
 		}
 
-		// Checksum for debugging
-		mInputChecksum = rmx::addToFNV1a_32(mInputChecksum, reinterpret_cast<uint8*>(newInputFrame.mInputsByPlayer), sizeof(newInputFrame.mInputsByPlayer));
-		if (frameNumber % 200 == 0)
-		{
-			mRegularInputChecksum = mInputChecksum;
-			mRegularChecksumFrameNumber = frameNumber;
-		}
-
-		// Limit inputs history to a reasonable number of frames
-		while (mInputHistory.size() > 30)
-			mInputHistory.pop_front();
+		addToInputHistory(newInputFrame.mInputsByPlayer, frameNumber);
 	}
 
 	// Apply input locally
@@ -282,7 +287,97 @@ void NetplayHost::onFrameUpdate(ControlsIn& controlsIn, uint32 frameNumber)
 		controlsIn.injectInputs(inputFrame.mInputsByPlayer, MAX_PLAYERS);
 	}
 
-	if (activeConnections.empty())
+	sendInputHistory(activeConnections, frameNumber, frameNumber);
+}
+
+void NetplayHost::updateFrameWithRollback(ControlsIn& controlsIn, uint32 frameNumber, const std::vector<PlayerConnection*>& activeConnections)
+{
+	NetplayRollback& rollback = mNetplayManager.getRollback();
+	NetplayRollback::FrameRecord& record = rollback.getFrameRecord(frameNumber);
+
+	uint8 activePlayers = 1;
+	for (PlayerConnection* playerConnection : activeConnections)
+	{
+		if (playerConnection->mPlayerIndex < MAX_PLAYERS)
+			activePlayers |= (1 << playerConnection->mPlayerIndex);
+	}
+
+	// When re-simulating, the frame keeps its inputs, including the corrected ones
+	if (!record.mSimulated)
+	{
+		// Host's local input is known right away
+		record.mInputsByPlayer[0] = controlsIn.getInputFromController(0);
+		record.mConfirmedPlayers |= 1;
+
+		for (PlayerConnection* playerConnection : activeConnections)
+		{
+			const uint8 playerIndex = playerConnection->mPlayerIndex;
+			if (playerIndex >= MAX_PLAYERS || (record.mConfirmedPlayers & (1 << playerIndex)))
+				continue;
+
+			const auto it = playerConnection->mEarlyInputs.find(frameNumber);
+			if (it != playerConnection->mEarlyInputs.end())
+			{
+				record.mInputsByPlayer[playerIndex] = it->second;
+				record.mConfirmedPlayers |= (1 << playerIndex);
+			}
+			else
+			{
+				// Predict that the client's last received input is still held
+				record.mInputsByPlayer[playerIndex] = playerConnection->mLastReceivedInput;
+			}
+			playerConnection->mEarlyInputs.erase(playerConnection->mEarlyInputs.begin(), playerConnection->mEarlyInputs.upper_bound(frameNumber));
+		}
+	}
+
+	rollback.applyFrameInputs(record, controlsIn, (record.mConfirmedPlayers & activePlayers) != activePlayers);
+	if (rollback.isResimulating())
+		return;
+
+	// Finalize frames whose inputs are all known, or that can't be corrected any more anyways
+	//  -> Only finalized frames get sent to the clients, as the host's simulation is the authoritative one
+	mNextFinalizedFrame = std::max(mNextFinalizedFrame, rollback.getOldestFrameNumber());
+	while (mNextFinalizedFrame <= frameNumber)
+	{
+		const NetplayRollback::FrameRecord* finalizedRecord = rollback.findFrameRecord(mNextFinalizedFrame);
+		if (nullptr == finalizedRecord)
+			break;
+
+		if ((finalizedRecord->mConfirmedPlayers & activePlayers) != activePlayers && mNextFinalizedFrame + rollback.getRollbackWindow() > frameNumber)
+			break;
+
+		addToInputHistory(finalizedRecord->mInputsByPlayer, mNextFinalizedFrame);
+		++mNextFinalizedFrame;
+	}
+
+	if (mNextFinalizedFrame > 0)
+	{
+		sendInputHistory(activeConnections, mNextFinalizedFrame - 1, frameNumber);
+	}
+}
+
+void NetplayHost::addToInputHistory(const uint16* inputsByPlayer, uint32 frameNumber)
+{
+	InputFrame& newInputFrame = mInputHistory.emplace_back();
+	for (int playerIndex = 0; playerIndex < MAX_PLAYERS; ++playerIndex)
+		newInputFrame.mInputsByPlayer[playerIndex] = inputsByPlayer[playerIndex];
+
+	// Checksum for debugging
+	mInputChecksum = rmx::addToFNV1a_32(mInputChecksum, reinterpret_cast<uint8*>(newInputFrame.mInputsByPlayer), sizeof(newInputFrame.mInputsByPlayer));
+	if (frameNumber % 200 == 0)
+	{
+		mRegularInputChecksum = mInputChecksum;
+		mRegularChecksumFrameNumber = frameNumber;
+	}
+
+	// Limit inputs history to a reasonable number of frames
+	while (mInputHistory.size() > 30)
+		mInputHistory.pop_front();
+}
+
+void NetplayHost::sendInputHistory(const std::vector<PlayerConnection*>& activeConnections, uint32 lastFrameNumber, uint32 currentFrameNumber)
+{
+	if (activeConnections.empty() || mInputHistory.empty())
 		return;
 
 	const size_t numPlayers = activeConnections.size() + 1;
@@ -293,7 +388,7 @@ void NetplayHost::onFrameUpdate(ControlsIn& controlsIn, uint32 frameNumber)
 	packet.mGameplayState = 1;			// TODO: Set this to some other value during paused game
 	packet.mNumPlayers = (uint8)numPlayers;
 	packet.mNumFrames = (uint8)numFrames;
-	packet.mFrameNumber = frameNumber;
+	packet.mFrameNumber = lastFrameNumber;
 	packet.mInputs.resize(packet.mNumPlayers * packet.mNumFrames);
 
 	// Copy input data from players
@@ -314,7 +409,7 @@ void NetplayHost::onFrameUpdate(ControlsIn& controlsIn, uint32 frameNumber)
 	for (PlayerConnection* playerConnection : activeConnections)
 	{
 		packet.mLastClientReceivedFrame = playerConnection->mLastReceivedFrameNumber;
-		playerConnection->mCurrentLatency = frameNumber - playerConnection->mLastReceivedFrameNumber;
+		playerConnection->mCurrentLatency = currentFrameNumber - playerConnection->mLastReceivedFrameNumber;
 
 		playerConnection->sendPacket(packet, NetConnection::SendFlags::UNRELIABLE);
 	}
@@ -334,6 +429,28 @@ bool NetplayHost::onReceivedPacket(ReceivedPacketEvaluation& evaluation)
 			{
 				PlayerConnection& connection = static_cast<PlayerConnection&>(evaluation.mConnection);
 
+				NetplayRollback& rollback = mNetplayManager.getRollback();
+				if (rollback.isEnabled())
+				{
+					// Clients send their inputs for several recent frames, so that a lost packet does not lead to a misprediction
+					for (int k = 0; k < (int)packet.mInputs.size(); ++k)
+					{
+						const int64 inputFrameNumber = (int64)packet.mFrameNumber - (int64)packet.mInputs.size() + 1 + k;
+						if (inputFrameNumber < (int64)mNextFinalizedFrame)
+							continue;	// Too late, the frame got sent to the clients with the predicted input already
+
+						NetplayRollback::FrameRecord* record = rollback.findFrameRecord((uint32)inputFrameNumber);
+						if (nullptr != record)
+						{
+							rollback.confirmInput(*record, connection.mPlayerIndex, packet.mInputs[k]);
+						}
+						else if (connection.mEarlyInputs.size() < 256)
+						{
+							connection.mEarlyInputs[(uint32)inputFrameNumber] = packet.mInputs[k];
+						}
+					}
+				}
+
 				if (packet.mFrameNumber > connection.mLastReceivedFrameNumber)		// Ignore out-dated packets
 				{
 					connection.mLastReceivedFrameNumber = packet.mFrameNumber;
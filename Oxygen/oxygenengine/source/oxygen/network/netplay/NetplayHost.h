@@ -47,6 +47,7 @@ public:
 		uint32 mLastReceivedFrameNumber = 0;
 		uint16 mLastReceivedInput = 0;
 		int mCurrentLatency = 0;
+		std::map<uint32, uint16> mEarlyInputs;	// Only used with rollback: Inputs received for frames that were not simulated yet
 	};
 
 	struct InputFrame
@@ -78,6 +79,9 @@ public:
 
 private:
 	void sendPunchthroughPacket(ConnectingPlayer& player);
+	void updateFrameWithRollback(ControlsIn& controlsIn, uint32 frameNumber, const std::vector<PlayerConnection*>& activeConnections);
+	void addToInputHistory(const uint16* inputsByPlayer, uint32 frameNumber);
+	void sendInputHistory(const std::vector<PlayerConnection*>& activeConnections, uint32 lastFrameNumber, uint32 currentFrameNumber);
 
 private:
 	ConnectionManager& mConnectionManager;
@@ -89,6 +93,7 @@ private:
 	std::vector<ConnectingPlayer> mConnectingPlayers;
 	std::vector<PlayerConnection*> mPlayerConnections;
 	std::deque<InputFrame> mInputHistory;
+	uint32 mNextFinalizedFrame = 0;		// Only used with rollback: Frames before this one are sent to the clients, so their inputs must not change any more
 
 	uint32 mInputChecksum = 0;
 	uint32 mRegularInputChecksum = 0;
@@ -71,6 +71,7 @@ void NetplayManager::closeConnections()
 {
 	SAFE_DELETE(mNetplayHost);
 	SAFE_DELETE(mNetplayClient);
+	mRollback.setup(0);
 	mExternalAddressQuery.reset();
 	mUDPSocket.close();
 }
@@ -130,6 +131,22 @@ void NetplayManager::onFrameUpdate(ControlsIn& controlsIn, uint32 frameNumber)
 	}
 }
 
+void NetplayManager::onFrameCompleted(Simulation& simulation)
+{
+	if (mRollback.isEnabled())
+	{
+		mRollback.onFrameCompleted(simulation);
+	}
+}
+
+void NetplayManager::performRollback(Simulation& simulation)
+{
+	if (mRollback.isEnabled())
+	{
+		mRollback.performRollback(simulation);
+	}
+}
+
 NetConnection* NetplayManager::createNetConnection(ConnectionManager& connectionManager, const SocketAddress& senderAddress)
 {
 	if (nullptr != mNetplayHost)
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "oxygen/network/netplay/ExternalAddressQuery.h"
+#include "oxygen/network/netplay/NetplayRollback.h"
 
 #include "oxygen_netcore/network/ConnectionListener.h"
 #include "oxygen_netcore/network/ConnectionManager.h"
@@ -16,6 +17,7 @@
 class ControlsIn;
 class NetplayClient;
 class NetplayHost;
+class Simulation;
 
 
 class NetplayManager : public ConnectionListenerInterface, public SingleInstance<NetplayManager>
@@ -33,6 +35,7 @@ public:
 	inline NetplayHost* getNetplayHost() 					{ return mNetplayHost; }
 	inline NetplayClient* getNetplayClient()				{ return mNetplayClient; }
 	inline const ExternalAddressQuery& getExternalAddressQuery() const  { return mExternalAddressQuery; }
+	inline NetplayRollback& getRollback()					{ return mRollback; }
 
 	bool setupAsHost(bool registerSessionAtServer, uint16 port = DEFAULT_HOST_PORT);
 	void startJoinViaServer();
@@ -44,6 +47,8 @@ public:
 
 	bool canBeginNextFrame(uint32 frameNumber);
 	void onFrameUpdate(ControlsIn& controlsIn, uint32 frameNumber);
+	void onFrameCompleted(Simulation& simulation);
+	void performRollback(Simulation& simulation);
 
 protected:
 	virtual NetConnection* createNetConnection(ConnectionManager& connectionManager, const SocketAddress& senderAddress) override;
@@ -63,4 +68,5 @@ private:
 	NetplayHost* mNetplayHost = nullptr;
 	NetplayClient* mNetplayClient = nullptr;
 	ExternalAddressQuery mExternalAddressQuery;
+	NetplayRollback mRollback;
 };
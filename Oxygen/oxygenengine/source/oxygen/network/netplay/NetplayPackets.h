@@ -16,7 +16,7 @@ struct StartGamePacket : public highlevel::PacketBase
 {
 	HIGHLEVEL_PACKET_DEFINE_PACKET_TYPE("StartGamePacket");
 
-	static const uint8 PACKET_VERSION = 1;
+	static const uint8 PACKET_VERSION = 2;
 
 	uint8 mPacketVersion = PACKET_VERSION;
 	uint32 mGameBuildVersion = 0;
@@ -24,6 +24,8 @@ struct StartGamePacket : public highlevel::PacketBase
 	uint8 mGameMode = 0;
 	uint32 mFirstFrameNumber = 0;
 	uint64 mRNGState[4] = { 0 };
+	uint8 mPlayerIndex = 0;			// Player index of the receiving client
+	uint8 mRollbackWindow = 0;		// Number of frames that may get predicted, or 0 for lockstep
 
 	std::vector<uint8> mSerializedGameSettings;
 	// TODO: Add more, like persistent data, list of active mods incl. versions
@@ -45,6 +47,9 @@ struct StartGamePacket : public highlevel::PacketBase
 		for (int k = 0; k < 4; ++k)
 			serializer.serialize(mRNGState[k]);
 
+		serializer.serialize(mPlayerIndex);
+		serializer.serialize(mRollbackWindow);
+
 		serializer.serializeData(mSerializedGameSettings);
 	}
 };
@@ -87,7 +92,7 @@ struct PlayerInputIncrementPacket : public highlevel::PacketBase
 
 	uint32 mFrameNumber = 0;		// Most recent frame number
 	uint8 mNumFrames = 0;
-	std::vector<uint16> mInputs;	// One input per frame -- TODO: Only the last fraem is actually used at the moment
+	std::vector<uint16> mInputs;	// One input per frame -- TODO: Only the last frame is actually used without rollback
 
 	virtual void serializeContent(VectorBinarySerializer& serializer, uint8 protocolVersion) override
 	{
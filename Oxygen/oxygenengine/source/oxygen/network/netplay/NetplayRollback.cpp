@@ -0,0 +1,168 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "oxygen/pch.h"
+#include "oxygen/network/netplay/NetplayRollback.h"
+#include "oxygen/application/EngineMain.h"
+#include "oxygen/application/audio/AudioOutBase.h"
+#include "oxygen/application/input/ControlsIn.h"
+#include "oxygen/helper/HighResolutionTimer.h"
+#include "oxygen/simulation/CodeExec.h"
+#include "oxygen/simulation/Simulation.h"
+
+
+void NetplayRollback::setup(int rollbackWindow)
+{
+	clear();
+	mUnusedStateBuffers.clear();
+	mRollbackWindow = clamp(rollbackWindow, 0, MAX_ROLLBACK_WINDOW);
+	mStatistics = Statistics();
+}
+
+void NetplayRollback::clear()
+{
+	for (FrameRecord& record : mFrameRecords)
+	{
+		mUnusedStateBuffers.emplace_back().swap(record.mState);
+	}
+	mFrameRecords.clear();
+	mRollbackFrameNumber = NO_ROLLBACK;
+}
+
+uint32 NetplayRollback::getOldestFrameNumber() const
+{
+	return mFrameRecords.empty() ? 0 : mFrameRecords.front().mFrameNumber;
+}
+
+NetplayRollback::FrameRecord* NetplayRollback::findFrameRecord(uint32 frameNumber)
+{
+	if (mFrameRecords.empty() || frameNumber < mFrameRecords.front().mFrameNumber || frameNumber > mFrameRecords.back().mFrameNumber)
+		return nullptr;
+	return &mFrameRecords[frameNumber - mFrameRecords.front().mFrameNumber];
+}
+
+NetplayRollback::FrameRecord& NetplayRollback::getFrameRecord(uint32 frameNumber)
+{
+	FrameRecord* existingRecord = findFrameRecord(frameNumber);
+	if (nullptr != existingRecord)
+		return *existingRecord;
+
+	// Start all over if frame numbers are not continuous, e.g. after a reset of the simulation
+	if (!mFrameRecords.empty() && frameNumber != mFrameRecords.back().mFrameNumber + 1)
+		clear();
+
+	FrameRecord& record = mFrameRecords.emplace_back();
+	record.mFrameNumber = frameNumber;
+	if (!mUnusedStateBuffers.empty())
+	{
+		record.mState.swap(mUnusedStateBuffers.back());
+		record.mState.clear();
+		mUnusedStateBuffers.pop_back();
+	}
+
+	// Rolling back is possible for the last frames inside the window
+	while (mFrameRecords.size() > (size_t)mRollbackWindow + 1)
+	{
+		mUnusedStateBuffers.emplace_back().swap(mFrameRecords.front().mState);
+		mFrameRecords.pop_front();
+	}
+	return record;
+}
+
+void NetplayRollback::applyFrameInputs(FrameRecord& record, ControlsIn& controlsIn, bool usesPrediction)
+{
+	if (!record.mSimulated)
+	{
+		record.mSimulated = true;
+		if (usesPrediction)
+			++mStatistics.mPredictedFrames;
+	}
+	controlsIn.injectInputs(record.mInputsByPlayer, MAX_PLAYERS);
+}
+
+void NetplayRollback::confirmInput(FrameRecord& record, int playerIndex, uint16 input)
+{
+	if (playerIndex < 0 || playerIndex >= MAX_PLAYERS)
+		return;
+
+	record.mConfirmedPlayers |= (1 << playerIndex);
+	if (record.mInputsByPlayer[playerIndex] == input)
+		return;
+
+	record.mInputsByPlayer[playerIndex] = input;
+	if (record.mSimulated)
+	{
+		++mStatistics.mMispredictions;
+		mRollbackFrameNumber = std::min(mRollbackFrameNumber, record.mFrameNumber);
+	}
+}
+
+void NetplayRollback::onFrameCompleted(Simulation& simulation)
+{
+	// Save the state at the beginning of the next frame
+	//  -> During re-simulation, this replaces the states that were based on mispredicted inputs
+	FrameRecord& record = getFrameRecord(simulation.getFrameNumber());
+	record.mState.clear();
+	simulation.saveStateToMemory(record.mState);
+	ControlsIn::instance().writeCurrentState(record.mPreviousInputs, MAX_PLAYERS);
+}
+
+void NetplayRollback::performRollback(Simulation& simulation)
+{
+	if (mRollbackFrameNumber == NO_ROLLBACK || mResimulating)
+		return;
+
+	// States are only saved between frames, so wait until the current frame is done
+	if (!simulation.getCodeExec().willBeginNewFrame())
+		return;
+
+	const uint32 rollbackFrameNumber = mRollbackFrameNumber;
+	const uint32 currentFrameNumber = simulation.getFrameNumber();
+	mRollbackFrameNumber = NO_ROLLBACK;
+	if (rollbackFrameNumber >= currentFrameNumber)
+		return;
+
+	FrameRecord* record = findFrameRecord(rollbackFrameNumber);
+	if (nullptr == record || record->mState.empty())
+	{
+		++mStatistics.mFailedRollbacks;
+		return;
+	}
+
+	HighResolutionTimer timer;
+	timer.start();
+
+	// Audio of these frames was played already, and video only shows the last frame anyways
+	AudioOutBase& audioOut = EngineMain::instance().getAudioOut();
+	const bool wasSuppressed = audioOut.isPlaybackSuppressed();
+	audioOut.setPlaybackSuppressed(true);
+	mResimulating = true;
+
+	if (simulation.restoreFrameState(rollbackFrameNumber, record->mState, record->mPreviousInputs))
+	{
+		// Frame records are still in place, so each frame gets simulated with the same inputs as before, except for the corrected ones
+		while (simulation.getFrameNumber() < currentFrameNumber)
+		{
+			if (!simulation.generateFrame())
+				break;
+		}
+
+		const uint32 numFrames = currentFrameNumber - rollbackFrameNumber;
+		++mStatistics.mRollbacks;
+		mStatistics.mResimulatedFrames += numFrames;
+		mStatistics.mMaxRollbackFrames = std::max(mStatistics.mMaxRollbackFrames, numFrames);
+	}
+	else
+	{
+		++mStatistics.mFailedRollbacks;
+	}
+
+	mResimulating = false;
+	audioOut.setPlaybackSuppressed(wasSuppressed);
+	mStatistics.mLastRollbackTime = (float)(timer.getSecondsSinceStart() * 1000.0);
+}
@@ -0,0 +1,76 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+class ControlsIn;
+class Simulation;
+
+
+// Keeps the recent history of netplay frames: the inputs each frame got simulated with, and the game state at its beginning
+//  -> Frames can get simulated with predicted inputs of remote players, instead of waiting for their actual inputs
+//  -> When a prediction turns out to be wrong, the state gets restored and all frames since then get simulated again, with audio playback suppressed
+class NetplayRollback
+{
+public:
+	static const int MAX_PLAYERS = 4;
+	static const int MAX_ROLLBACK_WINDOW = 30;		// Limited by the number of frames that get sent in one packet
+
+	struct FrameRecord
+	{
+		uint32 mFrameNumber = 0;
+		uint16 mInputsByPlayer[MAX_PLAYERS] = { 0 };	// Inputs the frame got simulated with
+		uint8 mConfirmedPlayers = 0;					// Bit mask of players whose input for this frame is known, all others are only predicted
+		bool mSimulated = false;
+		std::vector<uint8> mState;						// Save state at the beginning of the frame, empty if there is none
+		uint16 mPreviousInputs[MAX_PLAYERS] = { 0 };	// Controller state at the beginning of the frame, i.e. the inputs of the frame before
+	};
+
+	struct Statistics
+	{
+		uint32 mPredictedFrames = 0;		// Frames simulated with at least one predicted input
+		uint32 mMispredictions = 0;			// Number of predicted inputs that turned out to be wrong
+		uint32 mRollbacks = 0;
+		uint32 mResimulatedFrames = 0;
+		uint32 mMaxRollbackFrames = 0;
+		uint32 mFailedRollbacks = 0;		// Rollbacks that were not possible, because there was no state for the frame
+		float mLastRollbackTime = 0.0f;		// In milliseconds, including restoring the state and re-simulation
+	};
+
+public:
+	inline bool isEnabled() const				{ return mRollbackWindow > 0; }
+	inline int getRollbackWindow() const		{ return mRollbackWindow; }
+	inline bool isResimulating() const			{ return mResimulating; }
+	inline const Statistics& getStatistics() const  { return mStatistics; }
+
+	void setup(int rollbackWindow);
+	void clear();
+
+	uint32 getOldestFrameNumber() const;
+	FrameRecord* findFrameRecord(uint32 frameNumber);
+	FrameRecord& getFrameRecord(uint32 frameNumber);
+
+	// Injects the frame's inputs, which are either all confirmed, or partially predicted
+	void applyFrameInputs(FrameRecord& record, ControlsIn& controlsIn, bool usesPrediction);
+
+	// Sets the actual input of a player, and requests a rollback if the frame was simulated with a different one
+	void confirmInput(FrameRecord& record, int playerIndex, uint16 input);
+
+	void onFrameCompleted(Simulation& simulation);
+	void performRollback(Simulation& simulation);
+
+private:
+	static const uint32 NO_ROLLBACK = 0xffffffff;
+
+	int mRollbackWindow = 0;
+	std::deque<FrameRecord> mFrameRecords;
+	std::vector<std::vector<uint8>> mUnusedStateBuffers;	// Buffers are reused, as states get saved each frame
+	uint32 mRollbackFrameNumber = NO_ROLLBACK;
+	bool mResimulating = false;
+	Statistics mStatistics;
+};
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "oxygen/rendering/parts/SpriteManager.h"
+#include "oxygen/resources/GlyphAtlas.h"
 
 
 class Geometry
@@ -20,7 +21,7 @@ public:
 		PLANE,
 		SPRITE,
 		RECT,
-		TEXTURED_RECT,
+		TEXT,
 		EFFECT_BLUR,
 		VIEWPORT
 	};
@@ -79,16 +80,24 @@ public:
 };
 
 
-class TexturedRectGeometry : public Geometry
+class TextGeometry : public Geometry
 {
 public:
-	inline TexturedRectGeometry(const Recti& rect, DrawerTexture& drawerTexture, const Color& tintColor, const Color& addedColor) : Geometry(Type::TEXTURED_RECT), mRect(rect), mDrawerTexture(drawerTexture), mTintColor(tintColor), mAddedColor(addedColor) {}
+	inline TextGeometry(DrawerTexture& atlasTexture, const std::vector<GlyphAtlas::GlyphQuad>& glyphQuads, size_t firstGlyphQuad, size_t numGlyphQuads, const Color& tintColor, const Color& addedColor) :
+		Geometry(Type::TEXT), mAtlasTexture(atlasTexture), mTintColor(tintColor), mAddedColor(addedColor), mGlyphQuads(glyphQuads), mFirstGlyphQuad(firstGlyphQuad), mNumGlyphQuads(numGlyphQuads) {}
+
+	inline const GlyphAtlas::GlyphQuad* getGlyphQuads() const  { return &mGlyphQuads[mFirstGlyphQuad]; }
+	inline size_t getNumGlyphQuads() const  { return mNumGlyphQuads; }
 
 public:
-	Recti mRect;
-	DrawerTexture& mDrawerTexture;
+	DrawerTexture& mAtlasTexture;
 	Color mTintColor;
 	Color mAddedColor;
+
+private:
+	const std::vector<GlyphAtlas::GlyphQuad>& mGlyphQuads;	// Shared buffer owned by the geometry factory
+	size_t mFirstGlyphQuad = 0;
+	size_t mNumGlyphQuads = 0;
 };
 
 
@@ -130,9 +139,10 @@ public:
 		return mRectGeometryBuffer.createObject(rect, color);
 	}
 
-	TexturedRectGeometry& createTexturedRectGeometry(const Recti& rect, DrawerTexture& drawerTexture, const Color& tintColor, const Color& addedColor)
+	TextGeometry& createTextGeometry(DrawerTexture& atlasTexture, size_t firstGlyphQuad, const Color& tintColor, const Color& addedColor)
 	{
-		return mTexturedRectGeometryBuffer.createObject(rect, drawerTexture, tintColor, addedColor);
+		// All glyph quads from the given index on belong to the new geometry
+		return mTextGeometryBuffer.createObject(atlasTexture, mGlyphQuads, firstGlyphQuad, mGlyphQuads.size() - firstGlyphQuad, tintColor, addedColor);
 	}
 
 	EffectBlurGeometry& createEffectBlurGeometry(int blurValue)
@@ -153,17 +163,21 @@ public:
 			case Geometry::Type::PLANE:			mPlaneGeometryBuffer.destroyObject(static_cast<PlaneGeometry&>(geometry));				 break;
 			case Geometry::Type::SPRITE:		mSpriteGeometryBuffer.destroyObject(static_cast<SpriteGeometry&>(geometry));			 break;
 			case Geometry::Type::RECT:			mRectGeometryBuffer.destroyObject(static_cast<RectGeometry&>(geometry));				 break;
-			case Geometry::Type::TEXTURED_RECT:	mTexturedRectGeometryBuffer.destroyObject(static_cast<TexturedRectGeometry&>(geometry)); break;
+			case Geometry::Type::TEXT:			mTextGeometryBuffer.destroyObject(static_cast<TextGeometry&>(geometry));				 break;
 			case Geometry::Type::EFFECT_BLUR:	mEffectBlurGeometryBuffer.destroyObject(static_cast<EffectBlurGeometry&>(geometry));	 break;
 			case Geometry::Type::VIEWPORT:		mViewportGeometryBuffer.destroyObject(static_cast<ViewportGeometry&>(geometry));		 break;
 		}
 	}
 
+	inline std::vector<GlyphAtlas::GlyphQuad>& getGlyphQuads()  { return mGlyphQuads; }
+	inline void clearGlyphQuads()  { mGlyphQuads.clear(); }
+
 private:
 	ObjectPool<PlaneGeometry, 16>		 mPlaneGeometryBuffer;
 	ObjectPool<SpriteGeometry, 64>		 mSpriteGeometryBuffer;
 	ObjectPool<RectGeometry, 64>		 mRectGeometryBuffer;
-	ObjectPool<TexturedRectGeometry, 64> mTexturedRectGeometryBuffer;
+	ObjectPool<TextGeometry, 64>		 mTextGeometryBuffer;
 	ObjectPool<EffectBlurGeometry, 4>	 mEffectBlurGeometryBuffer;
 	ObjectPool<ViewportGeometry, 4>		 mViewportGeometryBuffer;
+	std::vector<GlyphAtlas::GlyphQuad>	 mGlyphQuads;
 };
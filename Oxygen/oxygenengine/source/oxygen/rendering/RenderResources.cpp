@@ -8,10 +8,14 @@
 
 #include "oxygen/pch.h"
 #include "oxygen/rendering/RenderResources.h"
+#include "oxygen/application/video/VideoOut.h"
 
 
 void RenderResources::loadSprites(bool fullReload)
 {
+	if (VideoOut::hasInstance())
+		VideoOut::instance().waitUntilRenderingIdle();
+
 	if (fullReload)
 		mSpriteCollection.clear();
 	mSpriteCollection.loadAllSpriteDefinitions();
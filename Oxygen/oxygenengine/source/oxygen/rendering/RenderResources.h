@@ -9,8 +9,8 @@
 #pragma once
 
 #include <rmxmedia.h>
+#include "oxygen/resources/GlyphAtlas.h"
 #include "oxygen/resources/PaletteCollection.h"
-#include "oxygen/resources/PrintedTextCache.h"
 #include "oxygen/resources/RawDataCollection.h"
 #include "oxygen/resources/SpriteCollection.h"
 
@@ -21,8 +21,8 @@ public:
 	void loadSprites(bool fullReload = false);
 
 public:
+	GlyphAtlas mGlyphAtlas;
 	PaletteCollection mPaletteCollection;
-	PrintedTextCache mPrintedTextCache;
 	RawDataCollection mRawDataCollection;
 	SpriteCollection mSpriteCollection;
 };
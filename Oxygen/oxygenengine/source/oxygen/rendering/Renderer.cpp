@@ -35,17 +35,26 @@ bool Renderer::progressRendering()
 	++mRenderingRunningCount;
 	if ((mRenderingRunningCount % 100) == 0)
 	{
-		constexpr uint32 LIMIT_MILLISECONDS = 100;
-		const uint32 numTicks = SDL_GetTicks() - mRenderingStartTicks;
-		if (numTicks >= LIMIT_MILLISECONDS)
+		if (hasExceededRenderTimeLimit())
 		{
-			if (!mLoggedLimitWarning)
-			{
-				LogDisplay::instance().setLogDisplay("Warning: Exceeded the render time limit of "  + std::to_string(LIMIT_MILLISECONDS) + " ms, further render items will be ignored");
-				mLoggedLimitWarning = true;
-			}
+			onExceededRenderTimeLimit();
 			return false;
 		}
 	}
 	return true;
 }
+
+bool Renderer::hasExceededRenderTimeLimit() const
+{
+	const uint32 numTicks = SDL_GetTicks() - mRenderingStartTicks;
+	return (numTicks >= RENDER_TIME_LIMIT_MILLISECONDS);
+}
+
+void Renderer::onExceededRenderTimeLimit()
+{
+	if (!mLoggedLimitWarning)
+	{
+		LogDisplay::instance().setLogDisplay("Warning: Exceeded the render time limit of "  + std::to_string(RENDER_TIME_LIMIT_MILLISECONDS) + " ms, further render items will be ignored");
+		mLoggedLimitWarning = true;
+	}
+}
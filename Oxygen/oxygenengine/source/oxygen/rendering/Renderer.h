@@ -42,7 +42,13 @@ protected:
 	void startRendering();
 	bool progressRendering();
 
+	// Can be used instead of "progressRendering" when rendering on multiple threads
+	bool hasExceededRenderTimeLimit() const;
+	void onExceededRenderTimeLimit();
+
 private:
+	static constexpr uint32 RENDER_TIME_LIMIT_MILLISECONDS = 100;
+
 	uint8 mRendererType = 0;
 
 	// Limit for render time
@@ -136,7 +136,7 @@ void OpenGLRenderResources::refresh()
 			// Update pattern data in bitmap for all changed patterns
 			for (int k = currentChanges.mFirst; k <= currentChanges.mLast; ++k)
 			{
-				const uint8* src = patternCache[k].mFlipVariation[0].mPixels;
+				const uint8* src = patternCache[k].getUnflippedPixels();
 				uint8* dst = &bitmap[k * 0x40];
 				memcpy(dst, src, 0x40);
 			}
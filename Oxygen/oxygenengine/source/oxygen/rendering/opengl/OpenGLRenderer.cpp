@@ -27,6 +27,7 @@
 #include "oxygen/rendering/opengl/shaders/SimpleRectColoredShader.h"
 #include "oxygen/rendering/opengl/shaders/SimpleRectOverdrawShader.h"
 #include "oxygen/rendering/opengl/shaders/SimpleRectTexturedShader.h"
+#include "oxygen/rendering/opengl/shaders/SimpleRectTexturedUVShader.h"
 #include "oxygen/simulation/LogDisplay.h"
 
 
@@ -90,6 +91,9 @@ struct OpenGLRenderer::Internal
 	RenderPaletteSpriteShader	mRenderPaletteSpriteShader[2];		// Two variations: With or without alpha test
 	RenderComponentSpriteShader mRenderComponentSpriteShader[2];
 	DebugDrawPlaneShader		mDebugDrawPlaneShader;
+
+	opengl::VertexArrayObject	mGlyphQuadsVAO;			// Used for batched text rendering
+	std::vector<float>			mGlyphVertexData;
 };
 
 
@@ -482,25 +486,62 @@ void OpenGLRenderer::renderGeometry(const Geometry& geometry)
 			break;
 		}
 
-		case Geometry::Type::TEXTURED_RECT:
+		case Geometry::Type::TEXT:
 		{
-			const TexturedRectGeometry& tg = static_cast<const TexturedRectGeometry&>(geometry);
+			const TextGeometry& tg = static_cast<const TextGeometry&>(geometry);
 
-			OpenGLDrawerTexture* texture = tg.mDrawerTexture.getImplementation<OpenGLDrawerTexture>();
+			OpenGLDrawerTexture* texture = tg.mAtlasTexture.getImplementation<OpenGLDrawerTexture>();
 			if (nullptr == texture)
 				break;
 
-			const bool needsRefresh = (mLastRenderedGeometryType != Geometry::Type::TEXTURED_RECT);
+			const bool needsRefresh = (mLastRenderedGeometryType != Geometry::Type::TEXT);
 			if (needsRefresh)
 			{
 				glDisable(GL_DEPTH_TEST);
-				mLastRenderedGeometryType = Geometry::Type::TEXTURED_RECT;
+				mLastRenderedGeometryType = Geometry::Type::TEXT;
 			}
 			mDrawerResources.setBlendMode(BlendMode::ALPHA);
 
-			SimpleRectTexturedShader& shader = mDrawerResources.getSimpleRectTexturedShader(true, true);
-			shader.setup(tg.mRect, mGameResolution, texture->getTextureHandle(), tg.mTintColor, tg.mAddedColor);
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+			// Build a single vertex batch for all glyphs, using pixel coordinates
+			const Vec2f uvScale(1.0f / (float)tg.mAtlasTexture.getWidth(), 1.0f / (float)tg.mAtlasTexture.getHeight());
+			const GlyphAtlas::GlyphQuad* glyphQuads = tg.getGlyphQuads();
+			const size_t numGlyphQuads = tg.getNumGlyphQuads();
+			std::vector<float>& vertexData = mInternal.mGlyphVertexData;
+			vertexData.resize(numGlyphQuads * 24);
+			for (size_t k = 0; k < numGlyphQuads; ++k)
+			{
+				const GlyphAtlas::GlyphQuad& glyphQuad = glyphQuads[k];
+				const float x0 = (float)glyphQuad.mPosition.x;
+				const float y0 = (float)glyphQuad.mPosition.y;
+				const float x1 = x0 + (float)glyphQuad.mAtlasRect.width;
+				const float y1 = y0 + (float)glyphQuad.mAtlasRect.height;
+				const float u0 = (float)glyphQuad.mAtlasRect.x * uvScale.x;
+				const float v0 = (float)glyphQuad.mAtlasRect.y * uvScale.y;
+				const float u1 = (float)(glyphQuad.mAtlasRect.x + glyphQuad.mAtlasRect.width) * uvScale.x;
+				const float v1 = (float)(glyphQuad.mAtlasRect.y + glyphQuad.mAtlasRect.height) * uvScale.y;
+
+				const float quadVertexData[] =
+				{
+					x0, y0, u0, v0,		// Upper left
+					x0, y1, u0, v1,		// Lower left
+					x1, y1, u1, v1,		// Lower right
+					x1, y1, u1, v1,		// Lower right
+					x1, y0, u1, v0,		// Upper right
+					x0, y0, u0, v0		// Upper left
+				};
+				memcpy(&vertexData[k * 24], quadVertexData, sizeof(quadVertexData));
+			}
+
+			const Vec4f transform(-1.0f, -1.0f, 2.0f / (float)mGameResolution.x, 2.0f / (float)mGameResolution.y);
+			SimpleRectTexturedUVShader& shader = mDrawerResources.getSimpleRectTexturedUVShader(true, true);
+			shader.setup(texture->getTextureHandle(), transform, tg.mTintColor, tg.mAddedColor);
+
+			mInternal.mGlyphQuadsVAO.setup(opengl::VertexArrayObject::Format::P2_T2);
+			mInternal.mGlyphQuadsVAO.updateVertexData(&vertexData[0], numGlyphQuads * 6);
+			mInternal.mGlyphQuadsVAO.draw(GL_TRIANGLES);
+
+			// All other geometry types expect the simple quad vertex data to be bound
+			mDrawerResources.getSimpleQuadVAO().bind();
 			break;
 		}
 
@@ -26,12 +26,13 @@ void SimpleRectTexturedUVShader::initialize(bool supportsTintColor, const char*
 
 		if (mSupportsTintColor)
 		{
-			mLocTintColor = mShader.getUniformLocation("TintColor");
+			mLocTintColor  = mShader.getUniformLocation("TintColor");
+			mLocAddedColor = mShader.getUniformLocation("AddedColor");
 		}
 	}
 }
 
-void SimpleRectTexturedUVShader::setup(GLuint textureHandle, const Vec4f& transform, const Color& tintColor)
+void SimpleRectTexturedUVShader::setup(GLuint textureHandle, const Vec4f& transform, const Color& tintColor, const Color& addedColor)
 {
 	bindShader();
 
@@ -45,6 +46,7 @@ void SimpleRectTexturedUVShader::setup(GLuint textureHandle, const Vec4f& transf
 		if (mSupportsTintColor)
 		{
 			mShader.setParam(mLocTintColor, tintColor);
+			mShader.setParam(mLocAddedColor, addedColor);
 		}
 	}
 }
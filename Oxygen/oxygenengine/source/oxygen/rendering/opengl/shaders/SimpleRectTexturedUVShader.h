@@ -17,7 +17,7 @@ class SimpleRectTexturedUVShader : public OpenGLShader
 {
 public:
 	void initialize(bool supportsTintColor, const char* techname);
-	void setup(GLuint textureHandle, const Vec4f& transform, const Color& tintColor = Color::WHITE);
+	void setup(GLuint textureHandle, const Vec4f& transform, const Color& tintColor = Color::WHITE, const Color& addedColor = Color::TRANSPARENT);
 
 private:
 	bool mSupportsTintColor = false;
@@ -25,6 +25,7 @@ private:
 	GLuint mLocTransform = 0;
 	GLuint mLocTexture = 0;
 	GLuint mLocTintColor = 0;
+	GLuint mLocAddedColor = 0;
 };
 
 #endif
@@ -15,6 +15,7 @@
 void PatternManager::refresh()
 {
 	mChangeBits.clearAllBits();
+	++mRefreshCounter;
 
 	// Update pattern cache content
 	const BitArray<0x800>& changeBits = EmulatorInterface::instance().getVRamChangeBits();
@@ -39,6 +40,10 @@ void PatternManager::refresh()
 
 					if (changed)
 					{
+					#if defined(USE_COMPACT_PATTERN_CACHE)
+						// Flip variations are not stored, they get applied when reading the pattern
+						RenderUtils::expandPatternDataFromVRAM(cacheItem.mPixels, src);
+					#else
 						// Fill main pattern
 						CacheItem::Pattern* patterns = cacheItem.mFlipVariation;
 						RenderUtils::expandPatternDataFromVRAM(patterns[0].mPixels, src);
@@ -58,7 +63,7 @@ void PatternManager::refresh()
 							memcpy(v2, v0, 8);
 							memcpy(v3, v1, 8);
 						}
-
+					#endif
 						memcpy(cacheItem.mOriginalDataBackup, src, 0x20);
 						mChangeBits.setBit(patternIndex);
 					}
@@ -71,6 +76,28 @@ void PatternManager::refresh()
 	EmulatorInterface::instance().getVRamChangeBits().clearAllBits();
 }
 
+void PatternManager::copyForRendering(const PatternManager& other)
+{
+	// Copy only the patterns that differ, which is usually just a small part of them
+	//  -> Comparing the original VRAM data is enough, as the rest of a cache item is derived from it
+	for (int patternIndex = 0; patternIndex < 0x800; ++patternIndex)
+	{
+		CacheItem& cacheItem = mPatternCache[patternIndex];
+		const CacheItem& otherItem = other.mPatternCache[patternIndex];
+		if (memcmp(cacheItem.mOriginalDataBackup, otherItem.mOriginalDataBackup, 0x20) != 0)
+		{
+		#if defined(USE_COMPACT_PATTERN_CACHE)
+			memcpy(cacheItem.mPixels, otherItem.mPixels, sizeof(cacheItem.mPixels));
+		#else
+			memcpy(cacheItem.mFlipVariation, otherItem.mFlipVariation, sizeof(cacheItem.mFlipVariation));
+		#endif
+			memcpy(cacheItem.mOriginalDataBackup, otherItem.mOriginalDataBackup, 0x20);
+		}
+	}
+	mChangeBits = other.mChangeBits;
+	mRefreshCounter = other.mRefreshCounter;
+}
+
 uint8 PatternManager::getLastUsedAtex(uint16 patternIndex) const
 {
 	return mPatternCache[patternIndex & 0x07ff].mLastUsedAtex;
@@ -89,7 +116,7 @@ void PatternManager::dumpAsPaletteBitmap(PaletteBitmap& output) const
 		for (int x = 0; x < 512; ++x)
 		{
 			const int patternIndex = (x/8) + (y/8) * 64;
-			output[x+y*512] = mPatternCache[patternIndex].mFlipVariation[0].mPixels[(x%8) + (y%8) * 8] + getLastUsedAtex((uint16)patternIndex);
+			output[x+y*512] = mPatternCache[patternIndex].getUnflippedPixels()[(x%8) + (y%8) * 8] + getLastUsedAtex((uint16)patternIndex);
 		}
 	}
 }
@@ -10,33 +10,77 @@
 
 #include <rmxbase.h>
 
+// Pattern cache layout, see "oxygen_pattern_cache_benchmark" for a comparison
+//  -> By default, all four flip variations of each pattern are stored, so that fetches don't need to apply any flipping
+//  -> With "USE_COMPACT_PATTERN_CACHE", only the unflipped pattern is stored: the cache gets 3x smaller and refreshes get faster, but fetches get slower
+
 
 class PatternManager
 {
 public:
 	struct CacheItem
 	{
+	#if defined(USE_COMPACT_PATTERN_CACHE)
+		uint8 mPixels[64] = { 0 };			// Unflipped pattern, flipped access goes through "getPatternLine" and "getPatternPixel"
+	#else
 		struct Pattern
 		{
 			uint8 mPixels[64] = { 0 };
 		};
-		Pattern mFlipVariation[4];
-		uint8 mOriginalDataBackup[32];
+		Pattern mFlipVariation[4];			// Indexed by the pattern index's flip bits
+	#endif
+		uint8 mOriginalDataBackup[32] = { 0 };
 		mutable uint8 mLastUsedAtex = 0;	// Only for debug output
+
+	#if defined(USE_COMPACT_PATTERN_CACHE)
+		inline const uint8* getUnflippedPixels() const  { return mPixels; }
+	#else
+		inline const uint8* getUnflippedPixels() const  { return mFlipVariation[0].mPixels; }
+	#endif
 	};
 
+public:
+	// Returns the 8 pixels of a pattern line, with flip bits of the pattern index applied (bit 11 = horizontal, bit 12 = vertical)
+	static FORCE_INLINE uint64 getPatternLine(const CacheItem* patternCache, uint16 patternIndex, int line)
+	{
+		uint64 pixels;
+	#if defined(USE_COMPACT_PATTERN_CACHE)
+		memcpy(&pixels, &patternCache[patternIndex & 0x07ff].mPixels[((patternIndex & 0x1000) ? (7 - line) : line) * 8], 8);
+		return (patternIndex & 0x0800) ? swapBytes64(pixels) : pixels;
+	#else
+		memcpy(&pixels, &patternCache[patternIndex & 0x07ff].mFlipVariation[(patternIndex >> 11) & 3].mPixels[line * 8], 8);
+		return pixels;
+	#endif
+	}
+
+	static FORCE_INLINE uint8 getPatternPixel(const CacheItem* patternCache, uint16 patternIndex, int x, int y)
+	{
+	#if defined(USE_COMPACT_PATTERN_CACHE)
+		if (patternIndex & 0x0800)
+			x = 7 - x;
+		if (patternIndex & 0x1000)
+			y = 7 - y;
+		return patternCache[patternIndex & 0x07ff].mPixels[x + y * 8];
+	#else
+		return patternCache[patternIndex & 0x07ff].mFlipVariation[(patternIndex >> 11) & 3].mPixels[x + y * 8];
+	#endif
+	}
+
 public:
 	void refresh();
+	void copyForRendering(const PatternManager& other);
 
 	uint8 getLastUsedAtex(uint16 patternIndex) const;
 	void setLastUsedAtex(uint16 patternIndex, uint8 atex);
 
 	inline const CacheItem* getPatternCache() const  { return mPatternCache; }
 	const BitArray<0x800>& getChangeBits() const  { return mChangeBits; }
+	inline uint32 getRefreshCounter() const  { return mRefreshCounter; }
 
 	void dumpAsPaletteBitmap(PaletteBitmap& output) const;
 
 private:
 	CacheItem mPatternCache[0x800];
 	BitArray<0x800> mChangeBits;	// One bit for each pattern, so we know which ones were changed in the last "refresh" call
+	uint32 mRefreshCounter = 0;		// Incremented with each "refresh" call, so users of the change bits can tell if they missed one
 };
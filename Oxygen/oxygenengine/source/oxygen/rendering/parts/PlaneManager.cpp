@@ -133,6 +133,30 @@ void PlaneManager::refresh()
 	}
 }
 
+void PlaneManager::copyForRendering(const PlaneManager& other)
+{
+	mNameTableBaseA = other.mNameTableBaseA;
+	mNameTableBaseB = other.mNameTableBaseB;
+	mNameTableBaseW = other.mNameTableBaseW;
+	mPlayfieldSize = other.mPlayfieldSize;
+
+	mIsPlaneWRightOfSplitX = other.mIsPlaneWRightOfSplitX;
+	mIsPlaneWBelowSplitY = other.mIsPlaneWBelowSplitY;
+	mPlaneAWSplitX = other.mPlaneAWSplitX;
+	mPlaneAWSplitY = other.mPlaneAWSplitY;
+	mRenderPlaneABehindW = other.mRenderPlaneABehindW;
+
+	for (int i = 0; i < 4; ++i)
+		mDisabledDefaultPlane[i] = other.mDisabledDefaultPlane[i];
+	mCustomPlanes = other.mCustomPlanes;
+
+	// Of the plane patterns buffers, the software renderer only needs the debug plane's one, the others are for the OpenGL renderer
+	memcpy(mPlanePatternsBuffer[PLANE_DEBUG], other.mPlanePatternsBuffer[PLANE_DEBUG], sizeof(mPlanePatternsBuffer[PLANE_DEBUG]));
+
+	const uint8* vram = other.getVRam();
+	mVRamCopy.assign(vram, vram + 0x10000);
+}
+
 void PlaneManager::resetCustomPlanes()
 {
 	for (int i = 0; i < 4; ++i)
@@ -219,7 +243,7 @@ uint16 PlaneManager::getPlaneBaseVRAMAddress(int planeIndex) const
 
 const uint16* PlaneManager::getPlaneDataInVRAM(int planeIndex) const
 {
-	return (const uint16*)(EmulatorInterface::instance().getVRam() + getPlaneBaseVRAMAddress(planeIndex));
+	return (const uint16*)(getVRam() + getPlaneBaseVRAMAddress(planeIndex));
 }
 
 size_t PlaneManager::getPlaneSizeInVRAM(int planeIndex) const
@@ -247,9 +271,14 @@ void PlaneManager::setPatternAtIndex(int planeIndex, uint16 patternIndex, uint16
 	EmulatorInterface::instance().writeVRam16(getPatternVRAMAddress(planeIndex, patternIndex), value);
 }
 
+const uint8* PlaneManager::getVRam() const
+{
+	return mVRamCopy.empty() ? EmulatorInterface::instance().getVRam() : mVRamCopy.data();
+}
+
 const uint16* PlaneManager::getPlaneContent(int planeIndex, uint16 patternIndex) const
 {
-	return (uint16*)(EmulatorInterface::instance().getVRam() + getPatternVRAMAddress(planeIndex, patternIndex));
+	return (const uint16*)(getVRam() + getPatternVRAMAddress(planeIndex, patternIndex));
 }
 
 void PlaneManager::setWindowPlaneSplitX(bool rightSideWindow, uint16 splitX)
@@ -397,8 +426,8 @@ void PlaneManager::dumpAsPaletteBitmap(PaletteBitmap& output, int planeIndex, bo
 		for (int x = 0; x < bitmapSize.x; x += 8, dest += 8)
 		{
 			const uint16 patternIndex = getPatternAtIndex(planeIndex, (x / 8) + (y / 8) * numPatternsPerLine);
-			const PatternManager::CacheItem::Pattern& pattern = patternCache[patternIndex & 0x07ff].mFlipVariation[(patternIndex >> 11) & 3];
-			const uint8* srcPatternPixels = &pattern.mPixels[(x & 0x07) + (y & 0x07) * 8];
+			const uint64 patternLine = PatternManager::getPatternLine(patternCache, patternIndex, y & 0x07);
+			const uint8* srcPatternPixels = (const uint8*)&patternLine;
 			const uint8 atex = ((planeIndex != PLANE_DEBUG) ? (patternIndex >> 9) : mPatternManager.getLastUsedAtex(patternIndex)) & 0x30;
 
 			for (int k = 0; k < 8; ++k)
@@ -43,6 +43,7 @@ public:
 
 	void reset();
 	void refresh();
+	void copyForRendering(const PlaneManager& other);
 
 	void resetCustomPlanes();
 	bool isPlaneUsed(int index) const;
@@ -88,6 +89,7 @@ public:
 	void serializeSaveState(VectorBinarySerializer& serializer, uint8 formatVersion);
 
 private:
+	const uint8* getVRam() const;
 	const uint16* getPlaneContent(int planeIndex, uint16 patternIndex = 0) const;
 
 private:
@@ -108,4 +110,6 @@ private:
 
 	bool mDisabledDefaultPlane[4];
 	std::vector<CustomPlane> mCustomPlanes;
+
+	std::vector<uint8> mVRamCopy;	// Only used by render snapshots, which must not read the emulator's VRAM while it gets changed
 };
@@ -165,6 +165,23 @@ RenderItem& PoolOfRenderItems::create(RenderItem::Type type)
 	}
 }
 
+RenderItem& PoolOfRenderItems::createCopy(const RenderItem& original)
+{
+	switch (original.getType())
+	{
+		case RenderItem::Type::VDP_SPRITE:		 return mVdpSprites.createObject(static_cast<const renderitems::VdpSpriteInfo&>(original));
+		case RenderItem::Type::PALETTE_SPRITE:	 return mPaletteSprites.createObject(static_cast<const renderitems::PaletteSpriteInfo&>(original));
+		case RenderItem::Type::COMPONENT_SPRITE: return mComponentSprites.createObject(static_cast<const renderitems::ComponentSpriteInfo&>(original));
+		case RenderItem::Type::SPRITE_MASK:		 return mSpriteMasks.createObject(static_cast<const renderitems::SpriteMaskInfo&>(original));
+		case RenderItem::Type::RECTANGLE:		 return mRectangles.createObject(static_cast<const renderitems::Rectangle&>(original));
+		case RenderItem::Type::TEXT:			 return mTexts.createObject(static_cast<const renderitems::Text&>(original));
+		case RenderItem::Type::VIEWPORT:		 return mViewports.createObject(static_cast<const renderitems::Viewport&>(original));
+		default:
+			RMX_ASSERT(false, "Trying to copy unsupported render item type");
+			return mVdpSprites.createObject();
+	}
+}
+
 void PoolOfRenderItems::destroy(RenderItem& renderItem)
 {
 	switch (renderItem.getType())
@@ -167,6 +167,7 @@ namespace renderitems
 struct PoolOfRenderItems
 {
 	RenderItem& create(RenderItem::Type type);
+	RenderItem& createCopy(const RenderItem& original);
 	void destroy(RenderItem& renderItem);
 
 	ObjectPool<renderitems::VdpSpriteInfo>		 mVdpSprites;
@@ -11,7 +11,18 @@
 #include "oxygen/simulation/EmulatorInterface.h"
 
 
+RenderParts* RenderParts::createSnapshotInstance()
+{
+	return new RenderParts(false);
+}
+
 RenderParts::RenderParts() :
+	RenderParts(true)
+{
+}
+
+RenderParts::RenderParts(bool registerInstance) :
+	SingleInstance<RenderParts>(registerInstance),
 	mPlaneManager(mPatternManager),
 	mScrollOffsetsManager(mPlaneManager),
 	mSpriteManager(mPatternManager, mSpacesManager)
@@ -55,6 +66,20 @@ void RenderParts::refresh(const RefreshParameters& refreshParameters)
 	}
 }
 
+void RenderParts::copyForRendering(const RenderParts& other)
+{
+	for (int i = 0; i < 8; ++i)
+		mLayerRendering[i] = other.mLayerRendering[i];
+	mActiveDisplay = other.mActiveDisplay;
+
+	mPaletteManager = other.mPaletteManager;
+	mPatternManager.copyForRendering(other.mPatternManager);
+	mPlaneManager.copyForRendering(other.mPlaneManager);
+	mScrollOffsetsManager.copyForRendering(other.mScrollOffsetsManager);
+	mSpacesManager = other.mSpacesManager;
+	mSpriteManager.copyForRendering(other.mSpriteManager);
+}
+
 void RenderParts::dumpPatternsContent()
 {
 	PaletteBitmap bmp;
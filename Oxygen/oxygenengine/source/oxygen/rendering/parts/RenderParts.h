@@ -21,6 +21,9 @@ class RenderParts : public SingleInstance<RenderParts>
 public:
 	RenderParts();
 
+	// Creates an instance that does not get registered as the single instance, for use as a snapshot that gets rendered on another thread
+	static RenderParts* createSnapshotInstance();
+
 	inline PaletteManager&		 getPaletteManager()		{ return mPaletteManager; }
 	inline PatternManager&		 getPatternManager()		{ return mPatternManager; }
 	inline PlaneManager&		 getPlaneManager()			{ return mPlaneManager; }
@@ -36,12 +39,18 @@ public:
 	void postFrameUpdate();
 	void refresh(const RefreshParameters& refreshParameters);
 
+	// Copies everything that rendering needs, so that the original render parts can get changed while this copy gets rendered
+	void copyForRendering(const RenderParts& other);
+
 	void dumpPatternsContent();
 	void dumpPlaneContent(int planeIndex);
 
 public:
 	bool mLayerRendering[8];
 
+private:
+	explicit RenderParts(bool registerInstance);
+
 private:
 	PaletteManager		 mPaletteManager;
 	PatternManager		 mPatternManager;
@@ -180,6 +180,21 @@ void ScrollOffsetsManager::postFrameUpdate()
 {
 }
 
+void ScrollOffsetsManager::copyForRendering(const ScrollOffsetsManager& other)
+{
+	mVerticalScrolling = other.mVerticalScrolling;
+	mHorizontalScrollMask = other.mHorizontalScrollMask;
+	mHorizontalScrollTableBase = other.mHorizontalScrollTableBase;
+	mScrollOffsetW = other.mScrollOffsetW;
+	mVerticalScrollOffsetBias = other.mVerticalScrollOffsetBias;
+
+	for (int index = 0; index < 4; ++index)
+	{
+		mSets[index] = other.mSets[index];
+		mInterpolatedSets[index] = other.mInterpolatedSets[index];
+	}
+}
+
 void ScrollOffsetsManager::resetOverwriteFlags()
 {
 	for (int index = 0; index < 4; ++index)
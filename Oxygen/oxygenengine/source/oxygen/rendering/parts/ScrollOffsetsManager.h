@@ -22,6 +22,7 @@ public:
 	void refresh(const RefreshParameters& refreshParameters);
 	void preFrameUpdate();
 	void postFrameUpdate();
+	void copyForRendering(const ScrollOffsetsManager& other);
 
 	void resetOverwriteFlags();
 
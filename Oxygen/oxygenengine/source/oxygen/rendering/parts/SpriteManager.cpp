@@ -89,6 +89,20 @@ void SpriteManager::postRefreshDebugging()
 	grabAddedItems();
 }
 
+void SpriteManager::copyForRendering(const SpriteManager& other)
+{
+	clearAllLifetimeContexts();
+	for (int contextIndex = 0; contextIndex < RenderItem::NUM_LIFETIME_CONTEXTS; ++contextIndex)
+	{
+		std::vector<RenderItem*>& items = mLifetimeContexts[contextIndex].mItems;
+		items.reserve(other.mLifetimeContexts[contextIndex].mItems.size());
+		for (const RenderItem* renderItem : other.mLifetimeContexts[contextIndex].mItems)
+		{
+			items.push_back(&mPoolOfRenderItems.createCopy(*renderItem));
+		}
+	}
+}
+
 void SpriteManager::setCurrentLifetimeContext(RenderItem::LifetimeContext lifetimeContext)
 {
 	mCurrentLifetimeContext = lifetimeContext;
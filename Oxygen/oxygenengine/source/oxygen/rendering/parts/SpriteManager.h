@@ -56,6 +56,9 @@ public:
 	void postFrameUpdate();
 	void postRefreshDebugging();
 
+	// Replaces the render items with copies of the other sprite manager's ones
+	void copyForRendering(const SpriteManager& other);
+
 	inline void setResetRenderItems(uint8 bitmask)  { mResetRenderItemsBitmask |= bitmask; }
 	void setCurrentLifetimeContext(RenderItem::LifetimeContext lifetimeContext);
 
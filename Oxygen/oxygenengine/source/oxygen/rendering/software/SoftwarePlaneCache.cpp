@@ -0,0 +1,98 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "oxygen/pch.h"
+#include "oxygen/rendering/software/SoftwarePlaneCache.h"
+#include "oxygen/rendering/parts/RenderParts.h"
+
+
+namespace
+{
+	FORCE_INLINE void rasterizePattern(uint8* dst, int stride, const PatternManager::CacheItem* patternCache, uint16 patternIndex)
+	{
+		// Atex and priority bit are the same for all pixels of the pattern
+		const uint8 bits = ((patternIndex >> 9) & 0x30) | ((patternIndex >> 8) & 0x80);
+		const uint64 mask = (uint64)bits * 0x0101010101010101ull;
+
+		for (int y = 0; y < 8; ++y)
+		{
+			const uint64 pixels = PatternManager::getPatternLine(patternCache, patternIndex, y) | mask;
+			memcpy(dst, &pixels, 8);
+			dst += stride;
+		}
+	}
+}
+
+
+void SoftwarePlaneCache::invalidate()
+{
+	for (CachedPlane& cachedPlane : mCachedPlanes)
+	{
+		cachedPlane.mValid = false;
+	}
+	mDebugPlane.mValid = false;
+}
+
+void SoftwarePlaneCache::update(RenderParts& renderParts, int planeIndex)
+{
+	RMX_CHECK(planeIndex >= 0 && planeIndex <= PlaneManager::PLANE_DEBUG, "Invalid plane index " << planeIndex, return);
+
+	// The debug plane is not part of VRAM and has no change tracking, so it gets fully rasterized each time
+	const bool isDebugPlane = (planeIndex == PlaneManager::PLANE_DEBUG);
+	CachedPlane& cachedPlane = isDebugPlane ? mDebugPlane : mCachedPlanes[planeIndex];
+
+	const PlaneManager& planeManager = renderParts.getPlaneManager();
+	const PatternManager& patternManager = renderParts.getPatternManager();
+
+	const Vec2i sizeInPatterns = planeManager.getPlayfieldSizeInPatterns();
+	const int patternsPerLine = (planeIndex <= PlaneManager::PLANE_A) ? sizeInPatterns.x : 64;
+	bool fullUpdate = !cachedPlane.mValid || isDebugPlane;
+	if (sizeInPatterns != cachedPlane.mSizeInPatterns || patternsPerLine != cachedPlane.mPatternsPerLine)
+	{
+		cachedPlane.mSizeInPatterns = sizeInPatterns;
+		cachedPlane.mPatternsPerLine = patternsPerLine;
+		cachedPlane.mNameTable.resize((size_t)(sizeInPatterns.x * sizeInPatterns.y));
+		cachedPlane.mPlane.mSizeInPixels = planeManager.getPlayfieldSizeInPixels();
+		cachedPlane.mPlane.mPixels.resize((size_t)(cachedPlane.mPlane.mSizeInPixels.x * cachedPlane.mPlane.mSizeInPixels.y));
+		fullUpdate = true;
+	}
+
+	// Changed patterns are known only for the last pattern manager refresh, so anything older requires a full update
+	const uint32 refreshCounter = patternManager.getRefreshCounter();
+	const bool checkPatternChanges = (refreshCounter == cachedPlane.mPatternRefreshCounter + 1);
+	if (refreshCounter != cachedPlane.mPatternRefreshCounter && !checkPatternChanges)
+		fullUpdate = true;
+
+	const BitArray<0x800>& patternChangeBits = patternManager.getChangeBits();
+	const PatternManager::CacheItem* patternCache = patternManager.getPatternCache();
+	const uint16* planeData = isDebugPlane ? planeManager.getPlanePatternsBuffer(PlaneManager::PLANE_DEBUG) : planeManager.getPlaneDataInVRAM(planeIndex);
+	const int numReadablePatterns = isDebugPlane ? 0x1000 : (0x10000 - (int)planeManager.getPlaneBaseVRAMAddress(planeIndex)) / 2;
+	const int stride = cachedPlane.mPlane.mSizeInPixels.x;
+
+	// Re-rasterize only the patterns whose name table entry or pattern content changed
+	uint16* cachedEntry = &cachedPlane.mNameTable[0];
+	for (int py = 0; py < sizeInPatterns.y; ++py)
+	{
+		uint8* dst = &cachedPlane.mPlane.mPixels[(size_t)(py * 8 * stride)];
+		for (int px = 0; px < sizeInPatterns.x; ++px)
+		{
+			const int index = px + py * patternsPerLine;
+			const uint16 patternIndex = (index < numReadablePatterns) ? planeData[index] : 0;
+			if (fullUpdate || patternIndex != *cachedEntry || (checkPatternChanges && patternChangeBits.isBitSet(patternIndex & 0x07ff)))
+			{
+				*cachedEntry = patternIndex;
+				rasterizePattern(dst, stride, patternCache, patternIndex);
+			}
+			++cachedEntry;
+			dst += 8;
+		}
+	}
+
+	cachedPlane.mValid = true;
+	cachedPlane.mPatternRefreshCounter = refreshCounter;
+}
@@ -0,0 +1,48 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+#include <rmxbase.h>
+
+class RenderParts;
+
+
+// Persistent rasterized playfields of the planes, updated per pattern where the name table or pattern content changed
+class SoftwarePlaneCache
+{
+public:
+	struct Plane
+	{
+		Vec2i mSizeInPixels;
+		std::vector<uint8> mPixels;		// One byte per pixel: pattern pixel in bits 0-3, atex in bits 4-5, priority flag in bit 7
+
+		inline const uint8* getLine(int y) const  { return &mPixels[(size_t)(y * mSizeInPixels.x)]; }
+	};
+
+public:
+	void invalidate();
+	void update(RenderParts& renderParts, int planeIndex);
+
+	inline const Plane& getPlane(int planeIndex) const  { return (planeIndex >= 0 && planeIndex < 3) ? mCachedPlanes[planeIndex].mPlane : mDebugPlane.mPlane; }
+
+private:
+	struct CachedPlane
+	{
+		Plane mPlane;
+		bool mValid = false;
+		Vec2i mSizeInPatterns;
+		int mPatternsPerLine = 0;
+		std::vector<uint16> mNameTable;			// Copy of the name table entries the cached pixels were rasterized from
+		uint32 mPatternRefreshCounter = 0;		// Pattern manager refresh counter at the time of the last update
+	};
+
+private:
+	CachedPlane mCachedPlanes[3];		// Planes B, A and W
+	CachedPlane mDebugPlane;			// Only used by custom planes, gets rasterized from scratch on each update
+};
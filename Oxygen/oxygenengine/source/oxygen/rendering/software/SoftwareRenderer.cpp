@@ -17,109 +17,29 @@
 #include "oxygen/drawing/DrawerTexture.h"
 #include "oxygen/drawing/software/BlitterHelper.h"
 
-#if defined(PLATFORM_VITA)
-	#include <psp2/kernel/clib.h>
-#endif
 
+SoftwareRenderer::SoftwareRenderer(RenderParts& renderParts, DrawerTexture& outputTexture) :
+	Renderer(RENDERER_TYPE_ID, renderParts, outputTexture)
+{
+	mRenderBands.resize(1);
+}
 
-namespace detail
+void SoftwareRenderer::prepareLazySpriteData(const std::vector<Geometry*>& geometries)
 {
-	class PixelBlockWriter
+	for (const Geometry* geometry : geometries)
 	{
-	public:
-		PixelBlockWriter(SoftwareRenderer::BufferedPlaneData& data, const PatternManager::CacheItem* patternCache) :
-			mBufferedPlaneData(&data),
-			mContent(&data.mContent[0]),
-			mPatternCache(patternCache)
-		{}
-
-		void newLine(int lineNumber, int position, int paletteIndex)
+		if (geometry->getType() == Geometry::Type::SPRITE && geometry->as<SpriteGeometry>().mSpriteInfo.getType() == RenderItem::Type::PALETTE_SPRITE)
 		{
-			mLineNumber = lineNumber;
-			mPosition = position;
-			mPaletteIndex = paletteIndex;
-			mLastPatternBits = 0xffff;
+			const renderitems::PaletteSpriteInfo& spriteInfo = static_cast<const renderitems::PaletteSpriteInfo&>(geometry->as<SpriteGeometry>().mSpriteInfo);
+			if (spriteInfo.mUseUpscaledSprite && nullptr != spriteInfo.mCacheItem)
+				static_cast<PaletteSprite*>(spriteInfo.mCacheItem->mSprite)->getUpscaledBitmap();
 		}
-
-		FORCE_INLINE void addPixels(int x, uint16 patternIndex, int pixels)
-		{
-			const PatternManager::CacheItem::Pattern& pattern = mPatternCache[patternIndex & 0x07ff].mFlipVariation[(patternIndex >> 11) & 3];
-			uint8* dst = &mContent[mPosition + x];
-			const uint8* srcPatternPixels = &pattern.mPixels[mPatternPixelOffset];
-			memcpy(dst, srcPatternPixels, pixels);
-
-			const uint16 patternBits = (patternIndex & 0xe000);		// Includes priority bit and atex
-			if (mLastPatternBits != patternBits)
-			{
-				mLastPatternBits = patternBits;
-
-				mCurrentPixelBlock = &vectorAdd((patternBits & 0x8000) ? mBufferedPlaneData->mPrioBlocks : mBufferedPlaneData->mNonPrioBlocks);
-				mCurrentPixelBlock->mStartCoords.set(x, mLineNumber);
-				mCurrentPixelBlock->mLinearPosition = mPosition + x;
-				mCurrentPixelBlock->mNumPixels = pixels;
-				mCurrentPixelBlock->mAtex = (patternIndex >> 9) & 0x30;
-				mCurrentPixelBlock->mPaletteIndex = mPaletteIndex;
-			}
-			else
-			{
-				mCurrentPixelBlock->mNumPixels += pixels;
-			}
-		}
-
-		FORCE_INLINE void addPixels8(int x, uint16 patternIndex)
-		{
-			// Same as above, but with hardcoded "pixels == 8"
-			const PatternManager::CacheItem::Pattern& pattern = mPatternCache[patternIndex & 0x07ff].mFlipVariation[(patternIndex >> 11) & 3];
-			uint64* dst = (uint64*)&mContent[mPosition + x];
-			const uint64* srcPatternPixels = (uint64*)&pattern.mPixels[mPatternPixelOffset];
-
-		#if !defined(PLATFORM_VITA)
-			*dst = *srcPatternPixels;
-		#else
-			// This fixes a crash
-			sceClibMemcpy(dst, srcPatternPixels, sizeof(*dst));
-		#endif
-
-			const uint16 patternBits = (patternIndex & 0xe000);		// Includes priority bit and atex
-			if (mLastPatternBits != patternBits)
-			{
-				mLastPatternBits = patternBits;
-
-				mCurrentPixelBlock = &vectorAdd((patternBits & 0x8000) ? mBufferedPlaneData->mPrioBlocks : mBufferedPlaneData->mNonPrioBlocks);
-				mCurrentPixelBlock->mStartCoords.set(x, mLineNumber);
-				mCurrentPixelBlock->mLinearPosition = mPosition + x;
-				mCurrentPixelBlock->mNumPixels = 8;
-				mCurrentPixelBlock->mAtex = (patternIndex >> 9) & 0x30;
-				mCurrentPixelBlock->mPaletteIndex = mPaletteIndex;
-			}
-			else
-			{
-				mCurrentPixelBlock->mNumPixels += 8;
-			}
-		}
-
-	public:
-		int mPatternPixelOffset = 0;
-
-	private:
-		SoftwareRenderer::BufferedPlaneData* mBufferedPlaneData = nullptr;
-		uint8* mContent = nullptr;
-		const PatternManager::CacheItem* mPatternCache = nullptr;
-
-		int mLineNumber = 0;
-		int mPosition = 0;
-		int mDepthPosition = 0;
-		int mPaletteIndex = 0;
-
-		SoftwareRenderer::BufferedPlaneData::PixelBlock* mCurrentPixelBlock = nullptr;
-		uint16 mLastPatternBits = 0xffff;
-	};
+	}
 }
 
-
-SoftwareRenderer::SoftwareRenderer(RenderParts& renderParts, DrawerTexture& outputTexture) :
-	Renderer(RENDERER_TYPE_ID, renderParts, outputTexture)
+SoftwareRenderer::~SoftwareRenderer()
 {
+	mWorkerThreads.setNumThreads(0);
 }
 
 void SoftwareRenderer::initialize()
@@ -131,6 +51,7 @@ void SoftwareRenderer::initialize()
 void SoftwareRenderer::reset()
 {
 	clearGameScreen();
+	mPlaneCache.invalidate();
 }
 
 void SoftwareRenderer::setGameResolution(const Vec2i& gameResolution)
@@ -149,6 +70,12 @@ void SoftwareRenderer::clearGameScreen()
 }
 
 void SoftwareRenderer::renderGameScreen(const std::vector<Geometry*>& geometries)
+{
+	renderGameScreenToBitmap(geometries);
+	mGameScreenTexture.bitmapUpdated();
+}
+
+void SoftwareRenderer::renderGameScreenToBitmap(const std::vector<Geometry*>& geometries)
 {
 	startRendering();
 	Bitmap& gameScreenBitmap = mGameScreenTexture.accessBitmap();
@@ -156,50 +83,59 @@ void SoftwareRenderer::renderGameScreen(const std::vector<Geometry*>& geometries
 	// Clear the screen
 	gameScreenBitmap.clear(mRenderParts.getPaletteManager().getBackdropColor());
 	memset(mDepthBuffer, 0, sizeof(mDepthBuffer));
-	mEmptyDepthBuffer = true;
-
-	mCurrentViewport.set(0, 0, mGameResolution.x, mGameResolution.y);
-	mFullViewport = true;
-
-	for (int i = 0; i < MAX_BUFFER_PLANE_DATA; ++i)
-	{
-		mBufferedPlaneData[i].mValid = false;
-	}
 
 	// Check if sprite masking needed
 	const bool usingSpriteMask = isUsingSpriteMask(geometries);
+	if (usingSpriteMask)
+	{
+		// Each render band copies its own part of the planes in there
+		mGameScreenCopy.create(gameScreenBitmap.getSize());
+	}
 
-	// Render geometries
+	// Bring the cached planes up to date, before render bands read from them in parallel
 	{
-		uint16 lastRenderQueue = 0xffff;
-		for (size_t i = 0; i < geometries.size(); ++i)
+		bool planeUpdated[4] = { false, false, false, false };
+		for (const Geometry* geometry : geometries)
 		{
-			if (!progressRendering())
-				break;
-
-			const uint16 renderQueue = geometries[i]->mRenderQueue;
-			if (usingSpriteMask && lastRenderQueue < 0x8000 && renderQueue >= 0x8000)
+			if (geometry->getType() == Geometry::Type::PLANE)
 			{
-				// Copy planes (needed for sprite masking)
-				mGameScreenCopy = gameScreenBitmap;
-			}
+				// Custom planes can use the debug plane as well
+				const int planeIndex = geometry->as<PlaneGeometry>().mPlaneIndex;
+				if (planeIndex < 0 || planeIndex > PlaneManager::PLANE_DEBUG)
+					continue;
 
-			renderGeometry(*geometries[i]);
-			lastRenderQueue = renderQueue;
+				if (!planeUpdated[planeIndex])
+				{
+					mPlaneCache.update(mRenderParts, planeIndex);
+					planeUpdated[planeIndex] = true;
+				}
+			}
 		}
 	}
 
-	// Set alpha channel to 0xff to make sure nothing gets lost due to alpha test
+	// Render geometries, optionally split into horizontal bands that get rendered in parallel
+	const int numBands = getNumRenderBands(geometries);
+	setupRenderBands(numBands);
+	if (numBands <= 1)
 	{
-		uint64* RESTRICT ptr = (uint64*)gameScreenBitmap.getData();
-		uint64* RESTRICT end = ptr + gameScreenBitmap.getPixelCount() / 2;
-		for (; ptr < end; ++ptr)
+		renderBand(mRenderBands[0], geometries, usingSpriteMask);
+	}
+	else
+	{
+		// Make sure lazily created sprite data is there before using multiple threads
+		prepareLazySpriteData(geometries);
+
+		mWorkerThreads.runJobs((size_t)numBands, [&](size_t index) { renderBand(mRenderBands[index], geometries, usingSpriteMask); });
+	}
+
+	for (int index = 0; index < numBands; ++index)
+	{
+		if (mRenderBands[index].mExceededTimeLimit)
 		{
-			*ptr |= 0xff000000ff000000ull;
+			onExceededRenderTimeLimit();
+			break;
 		}
 	}
-
-	mGameScreenTexture.bitmapUpdated();
 }
 
 void SoftwareRenderer::renderDebugDraw(int debugDrawMode, const Recti& rect)
@@ -242,9 +178,6 @@ void SoftwareRenderer::renderDebugDraw(int debugDrawMode, const Recti& rect)
 	}
 	mGameScreenTexture.bitmapUpdated();
 
-	mCurrentViewport.set(0, 0, bitmapSize.x, bitmapSize.y);
-	mFullViewport = true;
-
 	drawer.setWindowRenderTarget(FTX::screenRect());
 	drawer.setBlendMode(BlendMode::OPAQUE);
 	drawer.drawUpscaledRect(RenderUtils::getLetterBoxRect(rect, (float)bitmapSize.x / (float)bitmapSize.y), mGameScreenTexture);
@@ -254,7 +187,94 @@ void SoftwareRenderer::renderDebugDraw(int debugDrawMode, const Recti& rect)
 	gameScreenBitmap.create(oldSize);
 }
 
-void SoftwareRenderer::renderGeometry(const Geometry& geometry)
+int SoftwareRenderer::getNumRenderBands(const std::vector<Geometry*>& geometries)
+{
+	// Number of threads including the calling thread, with a negative config value meaning automatic selection
+	const int MAX_THREADS = 8;
+	const int configThreads = Configuration::instance().mSoftwareRendererThreads;
+	const int numThreads = (configThreads < 0) ? std::min((int)WorkerThreads::getDefaultNumThreads() + 1, MAX_THREADS) : clamp(configThreads, 1, MAX_THREADS);
+	mWorkerThreads.setNumThreads((size_t)(numThreads - 1));
+	if (mWorkerThreads.getNumThreads() == 0)
+		return 1;
+
+	// Blur effects work on the whole screen at once
+	for (const Geometry* geometry : geometries)
+	{
+		if (geometry->getType() == Geometry::Type::EFFECT_BLUR)
+			return 1;
+	}
+
+	// Use more bands than threads for a better balancing, as sprites are usually not evenly distributed over the screen
+	//  -> But bands should not get too small, as each of them has to go through all the geometries
+	const int MIN_BAND_HEIGHT = 16;
+	return clamp(numThreads * 2, 1, std::max(mGameResolution.y / MIN_BAND_HEIGHT, 1));
+}
+
+void SoftwareRenderer::setupRenderBands(int numBands)
+{
+	if ((int)mRenderBands.size() < numBands)
+		mRenderBands.resize((size_t)numBands);
+
+	for (int index = 0; index < numBands; ++index)
+	{
+		RenderBand& band = mRenderBands[index];
+		const int minY = mGameResolution.y * index / numBands;
+		const int maxY = mGameResolution.y * (index + 1) / numBands;
+		band.mRect.set(0, minY, mGameResolution.x, maxY - minY);
+		band.mCurrentViewport = band.mRect;
+		band.mFullViewport = true;
+		band.mEmptyDepthBuffer = true;
+		band.mExceededTimeLimit = false;
+
+		for (int i = 0; i < MAX_BUFFER_PLANE_DATA; ++i)
+		{
+			band.mBufferedPlaneData[i].mValid = false;
+		}
+	}
+}
+
+void SoftwareRenderer::renderBand(RenderBand& band, const std::vector<Geometry*>& geometries, bool usingSpriteMask)
+{
+	Bitmap& gameScreenBitmap = mGameScreenTexture.accessBitmap();
+	const int firstPixel = band.mRect.y * gameScreenBitmap.getWidth();
+	const int numPixels = band.mRect.height * gameScreenBitmap.getWidth();
+
+	// Render geometries
+	{
+		uint16 lastRenderQueue = 0xffff;
+		for (size_t i = 0; i < geometries.size(); ++i)
+		{
+			// Check if rendering is taking too long
+			if ((i % 100) == 99 && hasExceededRenderTimeLimit())
+			{
+				band.mExceededTimeLimit = true;
+				break;
+			}
+
+			const uint16 renderQueue = geometries[i]->mRenderQueue;
+			if (usingSpriteMask && lastRenderQueue < 0x8000 && renderQueue >= 0x8000)
+			{
+				// Copy planes (needed for sprite masking)
+				memcpy(&mGameScreenCopy[firstPixel], &gameScreenBitmap[firstPixel], numPixels * sizeof(uint32));
+			}
+
+			renderGeometry(band, *geometries[i]);
+			lastRenderQueue = renderQueue;
+		}
+	}
+
+	// Set alpha channel to 0xff to make sure nothing gets lost due to alpha test
+	{
+		uint32* RESTRICT ptr = &gameScreenBitmap[firstPixel];
+		uint32* RESTRICT end = ptr + numPixels;
+		for (; ptr < end; ++ptr)
+		{
+			*ptr |= 0xff000000;
+		}
+	}
+}
+
+void SoftwareRenderer::renderGeometry(RenderBand& band, const Geometry& geometry)
 {
 	switch (geometry.getType())
 	{
@@ -263,35 +283,41 @@ void SoftwareRenderer::renderGeometry(const Geometry& geometry)
 
 		case Geometry::Type::PLANE:
 		{
-			renderPlane(static_cast<const PlaneGeometry&>(geometry));
+			renderPlane(band, static_cast<const PlaneGeometry&>(geometry));
 			break;
 		}
 
 		case Geometry::Type::SPRITE:
 		{
-			renderSprite(static_cast<const SpriteGeometry&>(geometry));
+			renderSprite(band, static_cast<const SpriteGeometry&>(geometry));
 			break;
 		}
 
 		case Geometry::Type::RECT:
 		{
 			const RectGeometry& rg = static_cast<const RectGeometry&>(geometry);
-			const Recti rect = Recti::getIntersection(rg.mRect, mCurrentViewport);
-			mBlitter.blitColor(Blitter::OutputWrapper(mGameScreenTexture.accessBitmap(), rect), rg.mColor, BlendMode::ALPHA);
+			const Recti rect = Recti::getIntersection(rg.mRect, band.mCurrentViewport);
+			band.mBlitter.blitColor(Blitter::OutputWrapper(mGameScreenTexture.accessBitmap(), rect), rg.mColor, BlendMode::ALPHA);
 			break;
 		}
 
-		case Geometry::Type::TEXTURED_RECT:
+		case Geometry::Type::TEXT:
 		{
-			const TexturedRectGeometry& tg = static_cast<const TexturedRectGeometry&>(geometry);
-			Bitmap& gameScreenBitmap = mGameScreenTexture.accessBitmap();
+			const TextGeometry& tg = static_cast<const TextGeometry&>(geometry);
+			const Bitmap& atlasBitmap = tg.mAtlasTexture.getBitmap();
 
 			Blitter::Options blitterOptions;
 			blitterOptions.mBlendMode = BlendMode::ALPHA;
 			blitterOptions.mTintColor = &tg.mTintColor;
 			blitterOptions.mAddedColor = &tg.mAddedColor;
 
-			mBlitter.blitSprite(Blitter::OutputWrapper(mGameScreenTexture.accessBitmap(), mCurrentViewport), Blitter::SpriteWrapper(tg.mDrawerTexture.accessBitmap(), Vec2i()), tg.mRect.getPos(), blitterOptions);
+			const Blitter::OutputWrapper outputWrapper(mGameScreenTexture.accessBitmap(), band.mCurrentViewport);
+			const GlyphAtlas::GlyphQuad* glyphQuads = tg.getGlyphQuads();
+			for (size_t k = 0; k < tg.getNumGlyphQuads(); ++k)
+			{
+				const GlyphAtlas::GlyphQuad& glyphQuad = glyphQuads[k];
+				band.mBlitter.blitSprite(outputWrapper, Blitter::SpriteWrapper(atlasBitmap, glyphQuad.mAtlasRect.getPos(), glyphQuad.mAtlasRect), glyphQuad.mPosition, blitterOptions);
+			}
 			break;
 		}
 
@@ -311,21 +337,22 @@ void SoftwareRenderer::renderGeometry(const Geometry& geometry)
 		{
 			const ViewportGeometry& vg = static_cast<const ViewportGeometry&>(geometry);
 			const Recti fullViewport(0, 0, mGameResolution.x, mGameResolution.y);
-			mCurrentViewport = fullViewport;
-			mCurrentViewport.intersect(vg.mRect);
-			mFullViewport = (mCurrentViewport == fullViewport);
+			band.mCurrentViewport = fullViewport;
+			band.mCurrentViewport.intersect(vg.mRect);
+			band.mFullViewport = (band.mCurrentViewport == fullViewport);
+			band.mCurrentViewport.intersect(band.mRect);
 			break;
 		}
 	}
 }
 
-void SoftwareRenderer::renderPlane(const PlaneGeometry& geometry)
+void SoftwareRenderer::renderPlane(RenderBand& band, const PlaneGeometry& geometry)
 {
 	Bitmap& gameScreenBitmap = mGameScreenTexture.accessBitmap();
 
 	Recti rect(0, 0, mGameResolution.x, mGameResolution.y);
 	rect.intersect(geometry.mActiveRect);
-	rect.intersect(mCurrentViewport);
+	rect.intersect(band.mCurrentViewport);
 	const int minX = rect.x;
 	const int maxX = rect.x + rect.width;
 	const int minY = rect.y;
@@ -339,7 +366,7 @@ void SoftwareRenderer::renderPlane(const PlaneGeometry& geometry)
 	int foundFittingBufferedPlaneDataIndex = -1;
 	for (int i = 0; i < MAX_BUFFER_PLANE_DATA; ++i)
 	{
-		const BufferedPlaneData& bufferedPlaneData = mBufferedPlaneData[i];
+		const BufferedPlaneData& bufferedPlaneData = band.mBufferedPlaneData[i];
 		if (bufferedPlaneData.mValid &&
 			bufferedPlaneData.mPlaneIndex == geometry.mPlaneIndex &&
 			bufferedPlaneData.mScrollOffsets == geometry.mScrollOffsets &&
@@ -355,7 +382,7 @@ void SoftwareRenderer::renderPlane(const PlaneGeometry& geometry)
 		// Find a free index
 		for (int i = 0; i < MAX_BUFFER_PLANE_DATA; ++i)
 		{
-			if (!mBufferedPlaneData[i].mValid)
+			if (!band.mBufferedPlaneData[i].mValid)
 			{
 				foundFittingBufferedPlaneDataIndex = i;
 				break;
@@ -363,27 +390,25 @@ void SoftwareRenderer::renderPlane(const PlaneGeometry& geometry)
 		}
 		RMX_CHECK(foundFittingBufferedPlaneDataIndex != -1, "No free buffered plane data structure found", return);
 
-		BufferedPlaneData& bufferedPlaneData = mBufferedPlaneData[foundFittingBufferedPlaneDataIndex];
+		BufferedPlaneData& bufferedPlaneData = band.mBufferedPlaneData[foundFittingBufferedPlaneDataIndex];
 		bufferedPlaneData.mPlaneIndex = geometry.mPlaneIndex;
 		bufferedPlaneData.mScrollOffsets = geometry.mScrollOffsets;
 		bufferedPlaneData.mActiveRect = geometry.mActiveRect;
+		bufferedPlaneData.mMinY = minY;
+		bufferedPlaneData.mMaxY = maxY;
 		bufferedPlaneData.mContent.resize(gameScreenBitmap.getPixelCount());
-		bufferedPlaneData.mPrioBlocks.clear();
-		bufferedPlaneData.mPrioBlocks.reserve(0x800);
-		bufferedPlaneData.mNonPrioBlocks.clear();
-		bufferedPlaneData.mNonPrioBlocks.reserve(0x800);
+		bufferedPlaneData.mLineSpans.resize(gameScreenBitmap.getHeight());
 
-		const uint16* planeData = planeManager.getPlaneDataInVRAM(geometry.mPlaneIndex);
-		const uint16 numPatternsPerLine = (geometry.mPlaneIndex <= PlaneManager::PLANE_A) ? planeManager.getPlayfieldSizeInPatterns().x : 64;
+		const SoftwarePlaneCache::Plane& cachedPlane = mPlaneCache.getPlane(geometry.mPlaneIndex);
 		const uint16* scrollOffsetsH = nullptr;
 		const uint16* scrollOffsetsV = nullptr;
 		uint16 scrollMaskH = 0xff;
 		uint16 scrollMaskV = 0;
 		bool scrollNoRepeat = false;
+		uint16 wScrollOffsetX = 0;
 
 		if (geometry.mPlaneIndex == PlaneManager::PLANE_W)
 		{
-			static uint16 wScrollOffsetX;
 			wScrollOffsetX = (uint16)scrollOffsetsManager.getPlaneWScrollOffset().x;
 			scrollOffsetsH = &wScrollOffsetX;
 			scrollMaskH = 0;
@@ -399,12 +424,11 @@ void SoftwareRenderer::renderPlane(const PlaneGeometry& geometry)
 		const uint16 positionMaskV = planeManager.getPlayfieldSizeInPixels().y - 1;
 		const int16 verticalScrollOffsetBias = scrollOffsetsManager.getVerticalScrollOffsetBias();
 
-		detail::PixelBlockWriter pixelBlockWriter(bufferedPlaneData, mRenderParts.getPatternManager().getPatternCache());
-
+		const int lineWidth = gameScreenBitmap.getWidth();
 		for (int y = minY; y < maxY; ++y)
 		{
-			const int position = y * gameScreenBitmap.getWidth();
-			pixelBlockWriter.newLine(y, position, (y < paletteManager.mSplitPositionY) ? 0 : 1);
+			Vec2i& lineSpan = bufferedPlaneData.mLineSpans[y];
+			lineSpan.set(0, 0);
 
 			int vx = minX;
 			if (nullptr != scrollOffsetsH)
@@ -426,60 +450,26 @@ void SoftwareRenderer::renderPlane(const PlaneGeometry& geometry)
 				if (startX >= endX)
 					continue;
 			}
+			lineSpan.set(startX, endX);
 
+			uint8* dst = &bufferedPlaneData.mContent[y * lineWidth];
 			if (scrollMaskV == 0)
 			{
-				// Optimized version of the code below in the else-block
+				// Just a windowed copy from one line of the cached plane, wrapping around horizontally
 				const int vy = ((nullptr == scrollOffsetsV) ? y : (y + scrollOffsetsV[0])) & positionMaskV;
-				const uint16* planeDataForThisLine = &planeData[(vy / 8) * numPatternsPerLine];
-				const int patternPixelBaseOffset = (vy & 0x07) * 8;
-
-				// First few pixels until vx gets divisible by 8
-				int x = startX;
+				const uint8* src = cachedPlane.getLine(vy);
+				for (int x = startX; x < endX; )
 				{
 					vx &= positionMaskH;
-					const uint16 patternIndex = planeDataForThisLine[vx / 8];
-					const int vxMod8 = vx & 0x07;
-					const int pixels = std::min(8 - vxMod8, endX - x);
-					pixelBlockWriter.mPatternPixelOffset = patternPixelBaseOffset + vxMod8;
-					pixelBlockWriter.addPixels(x, patternIndex, pixels);
+					const int pixels = std::min(positionMaskH + 1 - vx, endX - x);
+					memcpy(&dst[x], &src[vx], pixels);
 					x += pixels;
 					vx += pixels;
 				}
-
-				// Full blocks of 8 pixels
-				pixelBlockWriter.mPatternPixelOffset = patternPixelBaseOffset;
-				while (true)
-				{
-					vx &= positionMaskH;
-					const int remainingVx = (positionMaskH - vx + 1);
-					const int numPixels = std::min(remainingVx, endX - x) / 8 * 8;
-					if (numPixels < 8)
-						break;
-
-					const uint16* planeDataPointer = &planeDataForThisLine[vx / 8];
-					const int localEndX = x + numPixels;
-					while (x < localEndX)
-					{
-						const uint16 patternIndex = *planeDataPointer;
-						pixelBlockWriter.addPixels8(x, patternIndex);
-						x += 8;
-						++planeDataPointer;
-					}
-					vx += numPixels;
-				}
-
-				// Remaining pixels on the right
-				if (x < endX)
-				{
-					vx &= positionMaskH;
-					const uint16 patternIndex = planeDataForThisLine[vx / 8];
-					const int pixels = endX - x;
-					pixelBlockWriter.addPixels(x, patternIndex, pixels);
-				}
 			}
 			else
 			{
+				// Vertical scroll offsets can differ for each column, so copy pattern-wise
 				for (int x = startX; x < endX; )
 				{
 					vx &= positionMaskH;
@@ -487,20 +477,16 @@ void SoftwareRenderer::renderPlane(const PlaneGeometry& geometry)
 					int vy;
 					if (nullptr == scrollOffsetsV)
 					{
-						vy = y;
+						vy = y & positionMaskV;
 					}
 					else
 					{
-						const int verticalScrollOffset = (scrollMaskV == 0) ? scrollOffsetsV[0] : scrollOffsetsV[((x - verticalScrollOffsetBias) >> 4) & scrollMaskV];
+						const int verticalScrollOffset = scrollOffsetsV[((x - verticalScrollOffsetBias) >> 4) & scrollMaskV];
 						vy = (y + verticalScrollOffset) & positionMaskV;
 					}
 
-					const uint16 patternIndex = planeData[(vx / 8) + (vy / 8) * numPatternsPerLine];
-					const int vxMod8 = vx & 0x07;
-					const int pixels = std::min(8 - vxMod8, endX - x);
-
-					pixelBlockWriter.mPatternPixelOffset = vxMod8 + (vy & 0x07) * 8;
-					pixelBlockWriter.addPixels(x, patternIndex, pixels);
+					const int pixels = std::min(8 - (vx & 0x07), endX - x);
+					memcpy(&dst[x], &cachedPlane.getLine(vy)[vx], pixels);
 					x += pixels;
 					vx += pixels;
 				}
@@ -512,47 +498,51 @@ void SoftwareRenderer::renderPlane(const PlaneGeometry& geometry)
 
 	// Write plane data to output
 	{
-		BufferedPlaneData& bufferedPlaneData = mBufferedPlaneData[foundFittingBufferedPlaneDataIndex];
+		const BufferedPlaneData& bufferedPlaneData = band.mBufferedPlaneData[foundFittingBufferedPlaneDataIndex];
 
 		const uint32* palettes[2] = { paletteManager.getMainPalette(0).getRawColors(), paletteManager.getMainPalette(1).getRawColors() };
+		const int lineWidth = gameScreenBitmap.getWidth();
+		bool anyPrioPixelWritten = false;
 
-		const std::vector<BufferedPlaneData::PixelBlock>& blocks = geometry.mPriorityFlag ? bufferedPlaneData.mPrioBlocks : bufferedPlaneData.mNonPrioBlocks;
-		for (const BufferedPlaneData::PixelBlock& block : blocks)
+		for (int y = bufferedPlaneData.mMinY; y < bufferedPlaneData.mMaxY; ++y)
 		{
-			const uint8* RESTRICT src = &bufferedPlaneData.mContent[block.mLinearPosition];
-			uint32* RESTRICT dstRGBA = &gameScreenBitmap.getData()[block.mLinearPosition];
-			const uint32* RESTRICT paletteWithAtex = &palettes[block.mPaletteIndex][block.mAtex];
+			const Vec2i& lineSpan = bufferedPlaneData.mLineSpans[y];
+			const uint8* RESTRICT src = &bufferedPlaneData.mContent[y * lineWidth];
+			uint32* RESTRICT dstRGBA = &gameScreenBitmap.getData()[y * lineWidth];
+			const uint32* RESTRICT palette = palettes[(y < paletteManager.mSplitPositionY) ? 0 : 1];
 
+			// Lower 6 bits of the content are the palette index (including atex), bit 7 is the priority flag
 			if (geometry.mPriorityFlag)
 			{
-				uint8* RESTRICT dstDepth = &mDepthBuffer[block.mStartCoords.x + block.mStartCoords.y * 0x200];
-				for (int i = 0; i < block.mNumPixels; ++i)
+				uint8* RESTRICT dstDepth = &mDepthBuffer[y * 0x200];
+				for (int x = lineSpan.x; x < lineSpan.y; ++x)
 				{
-					if (src[i] & 0x0f)
+					if ((src[x] & 0x8f) > 0x80)
 					{
-						dstRGBA[i] = paletteWithAtex[src[i]];
-						dstDepth[i] = 0x80;
+						dstRGBA[x] = palette[src[x] & 0x3f];
+						dstDepth[x] = 0x80;
+						anyPrioPixelWritten = true;
 					}
 				}
 			}
 			else
 			{
-				for (int i = 0; i < block.mNumPixels; ++i)
+				for (int x = lineSpan.x; x < lineSpan.y; ++x)
 				{
-					if (src[i] & 0x0f)
+					if ((src[x] & 0x80) == 0 && (src[x] & 0x0f) != 0)
 					{
-						dstRGBA[i] = paletteWithAtex[src[i]];
+						dstRGBA[x] = palette[src[x] & 0x3f];
 					}
 				}
 			}
 		}
 
-		if (!blocks.empty() && geometry.mPriorityFlag)
-			mEmptyDepthBuffer = false;
+		if (anyPrioPixelWritten)
+			band.mEmptyDepthBuffer = false;
 	}
 }
 
-void SoftwareRenderer::renderSprite(const SpriteGeometry& geometry)
+void SoftwareRenderer::renderSprite(RenderBand& band, const SpriteGeometry& geometry)
 {
 	Bitmap& gameScreenBitmap = mGameScreenTexture.accessBitmap();
 
@@ -570,7 +560,7 @@ void SoftwareRenderer::renderSprite(const SpriteGeometry& geometry)
 			const bool useTintColor = (sprite.mTintColor != Color::WHITE || sprite.mAddedColor != Color::TRANSPARENT);
 
 			Recti rect(sprite.mInterpolatedPosition.x, sprite.mInterpolatedPosition.y, sprite.mSize.x * 8, sprite.mSize.y * 8);
-			rect = Recti::getIntersection(rect, mCurrentViewport);
+			rect = Recti::getIntersection(rect, band.mCurrentViewport);
 
 			const int minX = rect.x;
 			const int maxX = rect.x + rect.width;
@@ -598,9 +588,7 @@ void SoftwareRenderer::renderSprite(const SpriteGeometry& geometry)
 						patternY = sprite.mSize.y - patternY - 1;
 
 					const uint16 patternIndex = sprite.mFirstPattern + patternY + patternX * sprite.mSize.y;
-					const PatternManager::CacheItem::Pattern& pattern = patternCache[patternIndex & 0x07ff].mFlipVariation[(patternIndex >> 11) & 3];
-
-					uint8 colorIndex = pattern.mPixels[(vx%8) + (vy%8) * 8];
+					uint8 colorIndex = PatternManager::getPatternPixel(patternCache, patternIndex, vx%8, vy%8);
 					colorIndex += (patternIndex >> 9) & 0x30;
 					if (colorIndex & 0x0f)
 					{
@@ -655,7 +643,7 @@ void SoftwareRenderer::renderSprite(const SpriteGeometry& geometry)
 				blitterOptions.mBlendMode = spriteBase.mBlendMode;
 				blitterOptions.mTintColor = (tintColor != Color::WHITE) ? &tintColor : nullptr;
 				blitterOptions.mAddedColor = (addedColor != Color::TRANSPARENT) ? &addedColor : nullptr;
-				blitterOptions.mDepthBuffer = (mEmptyDepthBuffer && !spriteBase.mPriorityFlag) ? nullptr : &depthBufferView;
+				blitterOptions.mDepthBuffer = (band.mEmptyDepthBuffer && !spriteBase.mPriorityFlag) ? nullptr : &depthBufferView;
 				blitterOptions.mDepthTestValue = (spriteBase.mPriorityFlag) ? 0x80 : 0;
 			}
 
@@ -678,15 +666,15 @@ void SoftwareRenderer::renderSprite(const SpriteGeometry& geometry)
 					const PaletteBase& secondaryPalette = (nullptr == spriteInfo.mSecondaryPalette) ? paletteManager.getMainPalette(1) : *spriteInfo.mSecondaryPalette;
 					const Blitter::PaletteWrapper paletteWrapper2(secondaryPalette.getRawColors() + spriteInfo.mAtex, secondaryPalette.getSize() - spriteInfo.mAtex);
 
-					Recti targetRect = Recti::getIntersection(mCurrentViewport, Recti(0, 0, mGameResolution.x, splitY));
-					mBlitter.blitIndexed(Blitter::OutputWrapper(gameScreenBitmap, targetRect), spriteWrapper, paletteWrapper, spriteInfo.mInterpolatedPosition, blitterOptions);
+					Recti targetRect = Recti::getIntersection(band.mCurrentViewport, Recti(0, 0, mGameResolution.x, splitY));
+					band.mBlitter.blitIndexed(Blitter::OutputWrapper(gameScreenBitmap, targetRect), spriteWrapper, paletteWrapper, spriteInfo.mInterpolatedPosition, blitterOptions);
 
-					targetRect = Recti::getIntersection(mCurrentViewport, Recti(0, splitY, mGameResolution.x, mGameResolution.y - splitY));
-					mBlitter.blitIndexed(Blitter::OutputWrapper(gameScreenBitmap, targetRect), spriteWrapper, paletteWrapper2, spriteInfo.mInterpolatedPosition, blitterOptions);
+					targetRect = Recti::getIntersection(band.mCurrentViewport, Recti(0, splitY, mGameResolution.x, mGameResolution.y - splitY));
+					band.mBlitter.blitIndexed(Blitter::OutputWrapper(gameScreenBitmap, targetRect), spriteWrapper, paletteWrapper2, spriteInfo.mInterpolatedPosition, blitterOptions);
 				}
 				else
 				{
-					mBlitter.blitIndexed(Blitter::OutputWrapper(gameScreenBitmap, mCurrentViewport), spriteWrapper, paletteWrapper, spriteInfo.mInterpolatedPosition, blitterOptions);
+					band.mBlitter.blitIndexed(Blitter::OutputWrapper(gameScreenBitmap, band.mCurrentViewport), spriteWrapper, paletteWrapper, spriteInfo.mInterpolatedPosition, blitterOptions);
 				}
 			}
 			else
@@ -697,11 +685,11 @@ void SoftwareRenderer::renderSprite(const SpriteGeometry& geometry)
 				const ComponentSprite& componentSprite = *static_cast<ComponentSprite*>(spriteInfo.mCacheItem->mSprite);
 				const Blitter::SpriteWrapper spriteWrapper(componentSprite.getBitmap(), -componentSprite.mOffset);
 
-				mBlitter.blitSprite(Blitter::OutputWrapper(gameScreenBitmap, mCurrentViewport), spriteWrapper, spriteInfo.mInterpolatedPosition, blitterOptions);
+				band.mBlitter.blitSprite(Blitter::OutputWrapper(gameScreenBitmap, band.mCurrentViewport), spriteWrapper, spriteInfo.mInterpolatedPosition, blitterOptions);
 			}
 
 			if (spriteBase.mPriorityFlag)
-				mEmptyDepthBuffer = false;
+				band.mEmptyDepthBuffer = false;
 			break;
 		}
 
@@ -716,8 +704,8 @@ void SoftwareRenderer::renderSprite(const SpriteGeometry& geometry)
 				const int bytes = (maxX - minX) * 4;
 				if (bytes > 0)
 				{
-					const int minY = clamp(mask.mInterpolatedPosition.y, 0, gameScreenBitmap.getHeight());
-					const int maxY = clamp(mask.mInterpolatedPosition.y + mask.mSize.y, 0, gameScreenBitmap.getHeight());
+					const int minY = clamp(mask.mInterpolatedPosition.y, band.mRect.y, band.mRect.y + band.mRect.height);
+					const int maxY = clamp(mask.mInterpolatedPosition.y + mask.mSize.y, band.mRect.y, band.mRect.y + band.mRect.height);
 
 					for (int line = minY; line < maxY; ++line)
 					{
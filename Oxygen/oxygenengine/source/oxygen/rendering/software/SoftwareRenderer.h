@@ -9,25 +9,26 @@
 #pragma once
 
 #include "oxygen/rendering/Renderer.h"
+#include "oxygen/rendering/software/SoftwarePlaneCache.h"
 #include "oxygen/drawing/software/Blitter.h"
+#include "oxygen/helper/WorkerThreads.h"
 
 class PlaneGeometry;
 class SpriteGeometry;
-namespace detail
-{
-	class PixelBlockWriter;
-}
 
 
 class SoftwareRenderer : public Renderer
 {
-friend class detail::PixelBlockWriter;
-
 public:
 	static constexpr int8 RENDERER_TYPE_ID = 0x10;
 
+public:
+	// Creates sprite data that gets created lazily otherwise, which is needed before rendering on another thread
+	static void prepareLazySpriteData(const std::vector<Geometry*>& geometries);
+
 public:
 	SoftwareRenderer(RenderParts& renderParts, DrawerTexture& outputTexture);
+	~SoftwareRenderer();
 
 	virtual void initialize() override;
 	virtual void reset() override;
@@ -36,43 +37,51 @@ public:
 	virtual void renderGameScreen(const std::vector<Geometry*>& geometries) override;
 	virtual void renderDebugDraw(int debugDrawMode, const Recti& rect) override;
 
-private:
-	void renderGeometry(const Geometry& geometry);
-	void renderPlane(const PlaneGeometry& geometry);
-	void renderSprite(const SpriteGeometry& geometry);
+	// Same as "renderGameScreen", but without updating the output texture, so this can be called on a thread other than the main thread
+	void renderGameScreenToBitmap(const std::vector<Geometry*>& geometries);
 
 private:
-	Vec2i mGameResolution;
-	Bitmap mGameScreenCopy;
-
-	uint8 mDepthBuffer[0x20000] = { 0 };	// 512x256 pixels
-	bool mEmptyDepthBuffer = true;			// Stays true until first non-zero depth value was written
-
-	Recti mCurrentViewport;
-	bool mFullViewport = true;
-
 	struct BufferedPlaneData
 	{
-		struct PixelBlock
-		{
-			Vec2i mStartCoords;
-			int mLinearPosition = 0;	// Linear position on screen / in content
-			int mNumPixels = 0;			// Pixels of horizontal line
-			uint8 mAtex = 0;
-			uint8 mPaletteIndex = 0;
-		};
-
 		bool mValid = false;
 		int mPlaneIndex = 0;
 		int mScrollOffsets = 0;
 		Recti mActiveRect;
+		int mMinY = 0;
+		int mMaxY = 0;
 
-		std::vector<uint8> mContent;
-		std::vector<PixelBlock> mPrioBlocks;
-		std::vector<PixelBlock> mNonPrioBlocks;
+		std::vector<uint8> mContent;		// Scrolled plane content on screen, in the same format as the plane cache
+		std::vector<Vec2i> mLineSpans;		// Start and end x of the written content, for each line
 	};
 	static const constexpr int MAX_BUFFER_PLANE_DATA = 8;
-	BufferedPlaneData mBufferedPlaneData[MAX_BUFFER_PLANE_DATA];
 
-	Blitter mBlitter;
+	// Horizontal band of the game screen, with everything needed to render it independently of the other bands
+	struct RenderBand
+	{
+		Recti mRect;
+		Recti mCurrentViewport;
+		bool mFullViewport = true;
+		bool mEmptyDepthBuffer = true;			// Stays true until first non-zero depth value was written in this band
+		bool mExceededTimeLimit = false;
+		BufferedPlaneData mBufferedPlaneData[MAX_BUFFER_PLANE_DATA];
+		Blitter mBlitter;
+	};
+
+private:
+	int getNumRenderBands(const std::vector<Geometry*>& geometries);
+	void setupRenderBands(int numBands);
+	void renderBand(RenderBand& band, const std::vector<Geometry*>& geometries, bool usingSpriteMask);
+	void renderGeometry(RenderBand& band, const Geometry& geometry);
+	void renderPlane(RenderBand& band, const PlaneGeometry& geometry);
+	void renderSprite(RenderBand& band, const SpriteGeometry& geometry);
+
+private:
+	Vec2i mGameResolution;
+	Bitmap mGameScreenCopy;
+	SoftwarePlaneCache mPlaneCache;
+
+	uint8 mDepthBuffer[0x20000] = { 0 };	// 512x256 pixels, each render band uses only its own lines
+
+	std::vector<RenderBand> mRenderBands;	// Contains at least one band, the first one is used alone for single-threaded rendering
+	WorkerThreads mWorkerThreads;
 };
@@ -9,6 +9,7 @@
 #include "oxygen/pch.h"
 #include "oxygen/resources/FontCollection.h"
 #include "oxygen/application/modding/ModManager.h"
+#include "oxygen/application/video/VideoOut.h"
 #include "oxygen/rendering/RenderResources.h"
 
 #include "lemon/compiler/parser/Parser.h"
@@ -217,6 +218,9 @@ bool FontCollection::registerManagedFont(Font& font, std::string_view key)
 
 void FontCollection::clear()
 {
+	if (VideoOut::hasInstance())
+		VideoOut::instance().waitUntilRenderingIdle();
+
 	for (auto& [key, collectedFont] : mCollectedFonts)
 	{
 		for (Font* font : collectedFont.mManagedFonts)
@@ -334,6 +338,10 @@ void FontCollection::loadDefinitionsFromPath(std::wstring_view path, const Mod*
 
 void FontCollection::updateLoadedFonts()
 {
+	// Font sources and glyph atlas pages may get deleted here
+	if (VideoOut::hasInstance())
+		VideoOut::instance().waitUntilRenderingIdle();
+
 	std::vector<uint64> keysToRemove;
 	for (auto& [key, collectedFont] : mCollectedFonts)
 	{
@@ -386,6 +394,6 @@ void FontCollection::updateLoadedFonts()
 		mFontsByKeyHash.erase(key);
 	}
 
-	// Invalidate cached printed texts
-	RenderResources::instance().mPrintedTextCache.clear();
+	// Invalidate glyph atlases
+	RenderResources::instance().mGlyphAtlas.clear();
 }
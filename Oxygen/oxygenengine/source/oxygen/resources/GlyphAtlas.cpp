@@ -0,0 +1,136 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "oxygen/pch.h"
+#include "oxygen/resources/GlyphAtlas.h"
+
+
+namespace
+{
+	static const int ATLAS_WIDTH = 512;
+	static const int ATLAS_MIN_HEIGHT = 64;
+	static const int GLYPH_PADDING = 1;		// Keep an empty pixel between glyphs, so that texture sampling never picks up a neighbor
+}
+
+
+GlyphAtlas::GlyphAtlas()
+{
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+}
+
+void GlyphAtlas::clear()
+{
+	mFontAtlases.clear();
+}
+
+DrawerTexture* GlyphAtlas::buildGlyphQuads(std::vector<GlyphQuad>& outGlyphQuads, uint64 fontKeyHash, Font& font, const std::string& textString, int spacing, Vec2i position, int alignment)
+{
+	mTypeInfos.clear();
+	font.getTypeInfos(mTypeInfos, Vec2i(), textString, spacing);
+	if (mTypeInfos.empty())
+		return nullptr;
+
+	FontAtlas& fontAtlas = mFontAtlases[fontKeyHash];
+	if (fontAtlas.mLastFontChangeCounter != font.getChangeCounter())
+	{
+		// Cached glyphs are only valid if the underlying font did not change in the meantime
+		resetFontAtlas(fontAtlas, font.getChangeCounter());
+	}
+
+	// Same placement as a printed text bitmap would get, see "Font::printBitmap"
+	const Vec2i origin = Font::applyAlignment(Recti(position, Vec2i(0, 0)), Recti(Vec2i(0, 0), font.getTextBoxSize(textString)), alignment);
+
+	const size_t numGlyphsBefore = fontAtlas.mGlyphs.size();
+	for (const Font::TypeInfo& typeInfo : mTypeInfos)
+	{
+		if (nullptr == typeInfo.mBitmap)
+			continue;
+
+		const Glyph* glyph = mapFind(fontAtlas.mGlyphs, typeInfo.mUnicode);
+		if (nullptr == glyph)
+		{
+			glyph = addGlyph(fontAtlas, font, typeInfo);
+		}
+		if (glyph->mAtlasRect.isEmpty())
+			continue;
+
+		GlyphQuad& glyphQuad = vectorAdd(outGlyphQuads);
+		glyphQuad.mPosition = origin + typeInfo.mPosition + glyph->mOffset;
+		glyphQuad.mAtlasRect = glyph->mAtlasRect;
+	}
+
+	if (fontAtlas.mGlyphs.size() != numGlyphsBefore)
+	{
+		// Upload the atlas once for all glyphs added by this text
+		fontAtlas.mTexture.bitmapUpdated();
+	}
+	return &fontAtlas.mTexture;
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::addGlyph(FontAtlas& fontAtlas, Font& font, const Font::TypeInfo& typeInfo)
+{
+	Glyph& glyph = fontAtlas.mGlyphs[typeInfo.mUnicode];
+
+	const Font::CharacterInfo& characterInfo = font.applyEffects(typeInfo);
+	const Bitmap& glyphBitmap = characterInfo.mCachedBitmap;
+	glyph.mOffset.set(-characterInfo.mBorderLeft, -characterInfo.mBorderTop);
+	if (glyphBitmap.empty())
+		return &glyph;
+
+	const Vec2i size = glyphBitmap.getSize();
+	if (size.x + GLYPH_PADDING > ATLAS_WIDTH)
+	{
+		RMX_ERROR("Glyph of size " << size.x << " x " << size.y << " does not fit into the glyph atlas", );
+		return &glyph;
+	}
+
+	// Simple shelf packing: fill rows from left to right, and start a new row below when the current one is full
+	if (fontAtlas.mShelfPosition.x + size.x + GLYPH_PADDING > ATLAS_WIDTH)
+	{
+		fontAtlas.mShelfPosition.x = 0;
+		fontAtlas.mShelfPosition.y += fontAtlas.mShelfHeight;
+		fontAtlas.mShelfHeight = 0;
+	}
+
+	// Grow the atlas texture if needed, keeping all existing glyphs at their position
+	Bitmap& atlasBitmap = fontAtlas.mTexture.accessBitmap();
+	const int requiredHeight = fontAtlas.mShelfPosition.y + size.y + GLYPH_PADDING;
+	if (requiredHeight > atlasBitmap.getHeight())
+	{
+		int newHeight = std::max(atlasBitmap.getHeight(), ATLAS_MIN_HEIGHT);
+		while (newHeight < requiredHeight)
+			newHeight *= 2;
+
+		Bitmap newBitmap;
+		newBitmap.create(ATLAS_WIDTH, newHeight, 0);
+		if (!atlasBitmap.empty())
+		{
+			newBitmap.insert(0, 0, atlasBitmap);
+		}
+		atlasBitmap.swap(newBitmap);
+	}
+
+	glyph.mAtlasRect.set(fontAtlas.mShelfPosition, size);
+	atlasBitmap.insert(glyph.mAtlasRect.x, glyph.mAtlasRect.y, glyphBitmap);
+
+	fontAtlas.mShelfPosition.x += size.x + GLYPH_PADDING;
+	fontAtlas.mShelfHeight = std::max(fontAtlas.mShelfHeight, size.y + GLYPH_PADDING);
+	return &glyph;
+}
+
+void GlyphAtlas::resetFontAtlas(FontAtlas& fontAtlas, uint32 fontChangeCounter)
+{
+	fontAtlas.mGlyphs.clear();
+	fontAtlas.mTexture.accessBitmap().clear();
+	fontAtlas.mLastFontChangeCounter = fontChangeCounter;
+	fontAtlas.mShelfPosition.set(0, 0);
+	fontAtlas.mShelfHeight = 0;
+}
@@ -0,0 +1,56 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+#include <rmxmedia.h>
+#include "oxygen/drawing/DrawerTexture.h"
+
+
+class GlyphAtlas : public SingleInstance<GlyphAtlas>
+{
+public:
+	struct GlyphQuad
+	{
+		Vec2i mPosition;		// Target position in game screen pixels
+		Recti mAtlasRect;		// Source rect inside the atlas texture
+	};
+
+public:
+	GlyphAtlas();
+	~GlyphAtlas();
+
+	void clear();
+
+	// Appends one quad per visible character to the output, and returns the atlas texture they refer to (or nullptr if there's nothing to draw)
+	DrawerTexture* buildGlyphQuads(std::vector<GlyphQuad>& outGlyphQuads, uint64 fontKeyHash, Font& font, const std::string& textString, int spacing, Vec2i position, int alignment);
+
+private:
+	struct Glyph
+	{
+		Recti mAtlasRect;
+		Vec2i mOffset;			// Offset relative to the character's type info position, covering borders added by font effects
+	};
+
+	struct FontAtlas
+	{
+		DrawerTexture mTexture;
+		std::unordered_map<uint32, Glyph> mGlyphs;
+		uint32 mLastFontChangeCounter = 0;
+		Vec2i mShelfPosition;
+		int mShelfHeight = 0;
+	};
+
+private:
+	const Glyph* addGlyph(FontAtlas& fontAtlas, Font& font, const Font::TypeInfo& typeInfo);
+	void resetFontAtlas(FontAtlas& fontAtlas, uint32 fontChangeCounter);
+
+private:
+	std::unordered_map<uint64, FontAtlas> mFontAtlases;
+	std::vector<Font::TypeInfo> mTypeInfos;		// Only used as temporary buffer
+};
@@ -11,8 +11,8 @@
 #include "oxygen/application/Configuration.h"
 #include "oxygen/application/EngineMain.h"
 #include "oxygen/application/modding/ModManager.h"
-#include "oxygen/helper/FileHelper.h"
 #include "oxygen/helper/JsonHelper.h"
+#include "oxygen/helper/WorkerThreads.h"
 #include "oxygen/rendering/sprite/SpriteDump.h"
 #include "oxygen/rendering/utils/Kosinski.h"
 #include "oxygen/simulation/EmulatorInterface.h"
@@ -174,6 +174,169 @@ namespace
 		createPaletteSpriteFromROM(emulatorInterface, paletteSprite, patternsBaseAddress, patternAddress, mappingAddress, encoding, indexOffset);
 	}
 
+	// A single sprite definition read from a JSON file
+	struct SpriteDefinition
+	{
+		std::string mIdentifier;
+		std::wstring mFilename;
+		Vec2i mCenter;
+		Recti mRect;
+		size_t mImageIndex = 0;
+	};
+
+	struct SpriteDefinitionFile
+	{
+		std::wstring mFilename;
+		std::vector<uint8> mContent;
+		std::string mErrors;
+		std::vector<SpriteDefinition> mDefinitions;
+	};
+
+	// An image file referenced by sprite definitions, which gets loaded only once even if multiple sprites use it
+	struct SpriteImage
+	{
+		std::wstring mFullPath;
+		bool mIsComponentImage = false;		// PNGs get loaded as RGBA bitmaps, everything else as palette bitmaps
+		size_t mRemainingUses = 0;
+		rmx::FileView mFileView;
+		std::vector<uint8> mContent;
+		bool mFileFound = false;
+		bool mSuccess = false;
+		bool mFromCache = false;
+		uint64 mContentHash = 0;			// Only for component images, as key for the sprite cache
+		PaletteBitmap mPaletteBitmap;
+		std::vector<uint32> mPalette;
+		Bitmap mBitmap;
+	};
+
+	static const uint32 SPRITE_CACHE_FORMAT_VERSION = 1;
+
+	void parseSpriteDefinitionFile(SpriteDefinitionFile& definitionFile)
+	{
+		// Silently ignore empty JSON files
+		if (definitionFile.mContent.empty())
+			return;
+
+		const Json::Value spritesJson = JsonHelper::loadFromMemory(definitionFile.mContent, &definitionFile.mErrors);
+		if (!definitionFile.mErrors.empty())
+			return;
+
+		for (auto iterator = spritesJson.begin(); iterator != spritesJson.end(); ++iterator)
+		{
+			SpriteDefinition definition;
+			definition.mIdentifier = iterator.key().asString();
+
+			for (auto it = iterator->begin(); it != iterator->end(); ++it)
+			{
+				Json::String keyString = it.key().asString();
+				if (keyString == "File")
+				{
+					JsonHelper::parseWString(definition.mFilename, it);
+				}
+				else if (keyString == "Center")
+				{
+					JsonHelper::parseVec2i(definition.mCenter, it);
+				}
+				else if (keyString == "Rect")
+				{
+					JsonHelper::parseRecti(definition.mRect, it);
+				}
+			}
+
+			if (!definition.mFilename.empty())
+			{
+				definitionFile.mDefinitions.emplace_back(std::move(definition));
+			}
+		}
+	}
+
+	void decodeSpriteImage(SpriteImage& image, const std::unordered_map<uint64, Bitmap>& cachedBitmaps)
+	{
+		if (!image.mFileFound)
+			return;
+
+		if (image.mIsComponentImage)
+		{
+			// Use the already decoded bitmap from the sprite cache if possible
+			image.mContentHash = rmx::getMurmur2_64(image.mFileView.mData, image.mFileView.mSize);
+			const Bitmap* cachedBitmap = mapFind(cachedBitmaps, image.mContentHash);
+			if (nullptr != cachedBitmap)
+			{
+				image.mBitmap = *cachedBitmap;
+				image.mSuccess = true;
+				image.mFromCache = true;
+			}
+			else
+			{
+				MemInputStream stream(image.mFileView.mData, image.mFileView.mSize);
+				Bitmap::LoadResult loadResult;
+				image.mSuccess = image.mBitmap.decode(stream, loadResult, "png");
+			}
+		}
+		else
+		{
+			image.mSuccess = image.mPaletteBitmap.loadBMP(image.mContent, &image.mPalette);
+		}
+
+		// File content is not needed any more
+		image.mFileView = rmx::FileView();
+		std::vector<uint8>().swap(image.mContent);
+	}
+
+	void loadSpriteCache(const std::wstring& cacheFilename, std::unordered_map<uint64, Bitmap>& outCachedBitmaps)
+	{
+		std::vector<uint8> buffer;
+		if (!FTX::FileSystem->readFile(cacheFilename, buffer))
+			return;
+
+		VectorBinarySerializer serializer(true, buffer);
+		if (serializer.read<uint32>() != SPRITE_CACHE_FORMAT_VERSION)
+			return;		// Cache file is outdated, so just ignore it
+
+		const uint32 numBitmaps = serializer.read<uint32>();
+		for (uint32 k = 0; k < numBitmaps; ++k)
+		{
+			const uint64 contentHash = serializer.read<uint64>();
+			const int width = serializer.read<int32>();
+			const int height = serializer.read<int32>();
+			const size_t bytes = (size_t)width * (size_t)height * 4;
+			if (width <= 0 || height <= 0 || serializer.hasError() || bytes > serializer.getRemaining())
+			{
+				// Cache file is broken
+				outCachedBitmaps.clear();
+				return;
+			}
+
+			Bitmap& bitmap = outCachedBitmaps[contentHash];
+			bitmap.create(width, height);
+			serializer.read(bitmap.getData(), bytes);
+		}
+	}
+
+	void saveSpriteCache(const std::wstring& cacheFilename, const std::vector<SpriteImage>& images)
+	{
+		std::vector<const SpriteImage*> cachedImages;
+		std::unordered_set<uint64> contentHashes;
+		for (const SpriteImage& image : images)
+		{
+			if (image.mIsComponentImage && image.mSuccess && contentHashes.insert(image.mContentHash).second)
+				cachedImages.push_back(&image);
+		}
+
+		std::vector<uint8> buffer;
+		VectorBinarySerializer serializer(false, buffer);
+		serializer.write(SPRITE_CACHE_FORMAT_VERSION);
+		serializer.write((uint32)cachedImages.size());
+		for (const SpriteImage* image : cachedImages)
+		{
+			const Bitmap& bitmap = image->mBitmap;
+			serializer.write(image->mContentHash);
+			serializer.write((int32)bitmap.getWidth());
+			serializer.write((int32)bitmap.getHeight());
+			serializer.write(bitmap.getData(), (size_t)bitmap.getPixelCount() * 4);
+		}
+		FTX::FileSystem->saveFile(cacheFilename, buffer);
+	}
 }
 
 
@@ -224,11 +387,15 @@ void SpriteCollection::clear()
 
 void SpriteCollection::loadAllSpriteDefinitions()
 {
+	// Worker threads for JSON parsing and image decoding, shared by all sprite folders
+	WorkerThreads workerThreads;
+	workerThreads.setNumThreads(WorkerThreads::getDefaultNumThreads());
+
 	// Load or reload from all mods
-	loadSpriteDefinitions(L"data/sprites", nullptr);
+	loadSpriteDefinitions(L"data/sprites", nullptr, workerThreads);
 	for (const Mod* mod : ModManager::instance().getActiveMods())
 	{
-		loadSpriteDefinitions(mod->mFullPath + L"sprites", mod);
+		loadSpriteDefinitions(mod->mFullPath + L"sprites", mod, workerThreads);
 	}
 }
 
@@ -384,161 +551,196 @@ SpriteCollection::Item& SpriteCollection::createItem(uint64 key)
 	return item;
 }
 
-void SpriteCollection::loadSpriteDefinitions(const std::wstring& path, const Mod* mod)
+void SpriteCollection::loadSpriteDefinitions(const std::wstring& path, const Mod* mod, WorkerThreads& workerThreads)
 {
-	struct PaletteSpriteSheet
-	{
-		PaletteBitmap mBitmap;
-		uint64 mFirstSpritePaletteKey = 0;
-	};
-	struct SheetCache
-	{
-		std::map<uint64, PaletteSpriteSheet> mPaletteSpriteSheets;
-		std::map<uint64, Bitmap> mComponentSpriteSheets;
-	};
-	SheetCache sheetCache;
-
 	std::vector<rmx::FileIO::FileEntry> fileEntries;
 	fileEntries.reserve(8);
 	FTX::FileSystem->listFilesByMask(path + L"/*.json", true, fileEntries);
 	if (fileEntries.empty())
 		return;
 
+	// Read all files here, as the file system must only be accessed from this thread, and do the parsing and decoding on the worker threads
+	std::vector<SpriteDefinitionFile> definitionFiles(fileEntries.size());
+	for (size_t k = 0; k < fileEntries.size(); ++k)
+	{
+		definitionFiles[k].mFilename = fileEntries[k].mPath + fileEntries[k].mFilename;
+		FTX::FileSystem->readFile(definitionFiles[k].mFilename, definitionFiles[k].mContent);
+	}
+	workerThreads.runJobs(definitionFiles.size(), [&](size_t index) { parseSpriteDefinitionFile(definitionFiles[index]); });
+
+	// Collect the referenced image files
+	std::vector<SpriteImage> images;
+	std::unordered_map<uint64, size_t> imageIndexByPath;
+	for (size_t k = 0; k < definitionFiles.size(); ++k)
+	{
+		SpriteDefinitionFile& definitionFile = definitionFiles[k];
+		if (!definitionFile.mErrors.empty())
+		{
+			RMX_ERROR("Error parsing JSON file '" << *WString(definitionFile.mFilename).toString() << "':\n" << definitionFile.mErrors, );
+			continue;
+		}
+
+		for (SpriteDefinition& definition : definitionFile.mDefinitions)
+		{
+			const std::wstring fullpath = fileEntries[k].mPath + definition.mFilename;
+			const auto pair = imageIndexByPath.emplace(rmx::getMurmur2_64(fullpath), images.size());
+			if (pair.second)
+			{
+				SpriteImage& image = vectorAdd(images);
+				image.mFullPath = fullpath;
+				image.mIsComponentImage = WString(definition.mFilename).endsWith(L".png");
+			}
+			definition.mImageIndex = pair.first->second;
+			++images[definition.mImageIndex].mRemainingUses;
+		}
+	}
+
+	for (SpriteImage& image : images)
+	{
+		if (image.mIsComponentImage)
+			image.mFileFound = FTX::FileSystem->readFileView(image.mFullPath, image.mFileView, image.mContent);
+		else
+			image.mFileFound = FTX::FileSystem->readFile(image.mFullPath, image.mContent);
+	}
+
+	// Decoded PNGs are cached by content hash, so that they don't need to be decoded again on the next start
+	std::wstring cacheFilename;
+	std::unordered_map<uint64, Bitmap> cachedBitmaps;
+	if (!Configuration::instance().mSpriteCacheDir.empty())
+	{
+		cacheFilename = Configuration::instance().mSpriteCacheDir + String(rmx::hexString(rmx::getMurmur2_64(path), 16, "")).toStdWString() + L".bin";
+		loadSpriteCache(cacheFilename, cachedBitmaps);
+	}
+
+	workerThreads.runJobs(images.size(), [&](size_t index) { decodeSpriteImage(images[index], cachedBitmaps); });
+
+	bool cacheOutdated = false;
+	size_t numCachedBitmapsUsed = 0;
+	for (const SpriteImage& image : images)
+	{
+		if (!image.mFileFound)
+		{
+			RMX_ERROR("Failed to load image file '" << *WString(image.mFullPath).toString() << "': File not found", );
+		}
+		else if (!image.mSuccess)
+		{
+			RMX_ERROR("Failed to load image file '" << *WString(image.mFullPath).toString() << "': Format not supported", );
+		}
+		else if (image.mIsComponentImage)
+		{
+			if (image.mFromCache)
+				++numCachedBitmapsUsed;
+			else
+				cacheOutdated = true;
+		}
+	}
+
+	if (!cacheFilename.empty())
+	{
+		// Rewrite the cache file if there's anything new, or if it contains entries not needed any more
+		if (cacheOutdated || numCachedBitmapsUsed < cachedBitmaps.size())
+		{
+			saveSpriteCache(cacheFilename, images);
+		}
+		cachedBitmaps.clear();
+	}
+
+	// Create the sprites, in the same order as defined
 	std::vector<uint32> palette;
+	std::unordered_map<size_t, uint64> firstSheetPaletteKeys;	// Palette key of the first sprite for each palette sprite sheet, by image index
 
 	++mGlobalChangeCounter;
-	for (const rmx::FileIO::FileEntry& fileEntry : fileEntries)
+	for (const SpriteDefinitionFile& definitionFile : definitionFiles)
 	{
-		const Json::Value spritesJson = JsonHelper::loadFile(fileEntry.mPath + fileEntry.mFilename);
-		for (auto iterator = spritesJson.begin(); iterator != spritesJson.end(); ++iterator)
+		for (const SpriteDefinition& definition : definitionFile.mDefinitions)
 		{
-			const String identifier(iterator.key().asString());
-			const uint64 spriteKey = getSpriteKey(identifier);
-
-			std::wstring filename;
-			Vec2i center;
-			Recti rect;
+			const uint64 spriteKey = getSpriteKey(definition.mIdentifier);
 
-			for (auto it = iterator->begin(); it != iterator->end(); ++it)
+			// Check for overloading
 			{
-				Json::String keyString = it.key().asString();
-				if (keyString == "File")
-				{
-					JsonHelper::parseWString(filename, it);
-				}
-				else if (keyString == "Center")
-				{
-					JsonHelper::parseVec2i(center, it);
-				}
-				else if (keyString == "Rect")
+				Item* existingItem = mapFind(mSpriteItems, spriteKey);
+				if (nullptr != existingItem)
 				{
-					JsonHelper::parseRecti(rect, it);
+					// This sprite got overloaded e.g. by a mod -- remove the old version
+					SAFE_DELETE(existingItem->mSprite);
 				}
 			}
 
-			if (!filename.empty())
-			{
-				// Check for overloading
-				{
-					Item* existingItem = mapFind(mSpriteItems, spriteKey);
-					if (nullptr != existingItem)
-					{
-						// This sprite got overloaded e.g. by a mod -- remove the old version
-						SAFE_DELETE(existingItem->mSprite);
-					}
-				}
+			Item& item = createItem(spriteKey);
+			item.mSourceInfo.mType = SourceInfo::Type::SPRITE_FILE;
+			item.mSourceInfo.mSourceIdentifier = definition.mIdentifier;
+			item.mSourceInfo.mMod = mod;
 
-				Item& item = createItem(spriteKey);
-				item.mSourceInfo.mType = SourceInfo::Type::SPRITE_FILE;
-				item.mSourceInfo.mSourceIdentifier = *identifier;
-				item.mSourceInfo.mMod = mod;
+			// Palette or RGBA?
+			SpriteImage& image = images[definition.mImageIndex];
+			item.mUsesComponentSprite = image.mIsComponentImage;
 
-				const std::wstring fullpath = fileEntry.mPath + filename;
+			// An image not needed by any further sprite can be moved instead of copied
+			const bool isLastUse = (--image.mRemainingUses == 0);
 
-				// Palette or RGBA?
-				item.mUsesComponentSprite = WString(filename).endsWith(L".png");
+			// Is this part of a sprite sheet?
+			const bool isSpriteSheet = (definition.mRect.width != 0);
 
-				// If this is part of a sprite sheet, we set the sheet key
-				uint64 sheetKey = 0;
-				if (rect.width != 0)
-					sheetKey = rmx::getMurmur2_64(fullpath);
+			if (!item.mUsesComponentSprite)
+			{
+				// Create palette sprite (= 8-bit palette sprite)
+				PaletteSprite* sprite = new PaletteSprite();
+				item.mSprite = sprite;
 
-				bool success = false;
-				if (!item.mUsesComponentSprite)
+				const uint64 paletteKey = spriteKey;
+				if (image.mSuccess)
 				{
-					// Load palette sprite (= 8-bit palette sprite)
-					PaletteSprite* sprite = new PaletteSprite();
-					item.mSprite = sprite;
-
-					const uint64 paletteKey = spriteKey;
-
-					if (sheetKey != 0)
+					if (isSpriteSheet)
 					{
-						// Part of a sprite sheet
-						PaletteSpriteSheet& sheet = sheetCache.mPaletteSpriteSheets[sheetKey];
-						if (sheet.mBitmap.empty())
+						// All sprites of the sheet share the palette of the first one
+						const uint64* firstSpritePaletteKey = mapFind(firstSheetPaletteKeys, definition.mImageIndex);
+						if (nullptr == firstSpritePaletteKey)
 						{
-							success = FileHelper::loadPaletteBitmap(sheet.mBitmap, fullpath, &palette);
-							if (success)
-							{
-								sheet.mFirstSpritePaletteKey = paletteKey;
-								addSpritePalette(paletteKey, item, palette);
-							}
+							firstSheetPaletteKeys[definition.mImageIndex] = paletteKey;
+							palette = image.mPalette;
+							addSpritePalette(paletteKey, item, palette);
 						}
 						else
 						{
-							success = true;
-							mPaletteRedirections[paletteKey] = sheet.mFirstSpritePaletteKey;
-						}
-
-						if (success)
-						{
-							sprite->createFromBitmap(sheet.mBitmap, rect, -center);
+							mPaletteRedirections[paletteKey] = *firstSpritePaletteKey;
 						}
+						sprite->createFromBitmap(image.mPaletteBitmap, definition.mRect, -definition.mCenter);
 					}
 					else
 					{
 						// The sprite is the whole bitmap
-						PaletteBitmap bitmap;
-						success = FileHelper::loadPaletteBitmap(bitmap, fullpath, &palette);
-						if (success)
-						{
-							sprite->createFromBitmap(std::move(bitmap), -center);
-							addSpritePalette(paletteKey, item, palette);
-						}
+						if (isLastUse)
+							sprite->createFromBitmap(std::move(image.mPaletteBitmap), -definition.mCenter);
+						else
+							sprite->createFromBitmap(image.mPaletteBitmap, -definition.mCenter);
+						palette = image.mPalette;
+						addSpritePalette(paletteKey, item, palette);
 					}
 				}
-				else
-				{
-					// Load component sprite (= 32-bit RGBA sprite)
-					ComponentSprite* sprite = new ComponentSprite();
-					item.mSprite = sprite;
+			}
+			else
+			{
+				// Create component sprite (= 32-bit RGBA sprite)
+				ComponentSprite* sprite = new ComponentSprite();
+				item.mSprite = sprite;
 
-					if (sheetKey != 0)
+				if (image.mSuccess)
+				{
+					if (isSpriteSheet)
 					{
-						// Part of a sprite sheet
-						Bitmap& bitmap = sheetCache.mComponentSpriteSheets[sheetKey];
-						if (bitmap.empty())
-						{
-							success = FileHelper::loadBitmap(bitmap, fullpath);
-						}
-						else
-						{
-							success = true;
-						}
-
-						if (success)
-						{
-							sprite->accessBitmap().copy(bitmap, rect);
-						}
+						sprite->accessBitmap().copy(image.mBitmap, definition.mRect);
 					}
-					else
+					else if (isLastUse)
 					{
 						// The sprite is the whole bitmap
-						success = FileHelper::loadBitmap(static_cast<ComponentSprite*>(item.mSprite)->accessBitmap(), fullpath);
+						sprite->accessBitmap().swap(image.mBitmap);
+					}
+					else
+					{
+						sprite->accessBitmap() = image.mBitmap;
 					}
-					item.mSprite->mOffset = -center;
 				}
+				item.mSprite->mOffset = -definition.mCenter;
 			}
 		}
 	}
@@ -15,6 +15,7 @@
 class EmulatorInterface;
 class Mod;
 class SpriteDump;
+class WorkerThreads;
 
 
 class SpriteCollection : public SingleInstance<SpriteCollection>
@@ -102,7 +103,7 @@ private:
 
 private:
 	Item& createItem(uint64 key);
-	void loadSpriteDefinitions(const std::wstring& path, const Mod* mod);
+	void loadSpriteDefinitions(const std::wstring& path, const Mod* mod, WorkerThreads& workerThreads);
 	void addSpritePalette(uint64 paletteKey, const Item& item, std::vector<uint32>& palette);
 
 private:
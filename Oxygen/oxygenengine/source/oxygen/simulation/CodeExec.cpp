@@ -528,6 +528,13 @@ bool CodeExec::performFrameUpdate()
 			runScript(true, &mMainCallFrameTracking);
 		}
 		mAccumulatedStepsOfCurrentFrame = 0;
+
+		// Between frames is a safe point to free runtime strings that are not in use any more
+		lemon::Runtime& runtime = mLemonScriptRuntime.getInternalLemonRuntime();
+		if (runtime.needsStringGarbageCollection())
+		{
+			runtime.collectStringGarbage();
+		}
 	}
 
 	// Return whether the frame was completed in any way (halted counts as completed)
@@ -601,6 +608,9 @@ void CodeExec::setupCallFrame(std::string_view functionName, std::string_view la
 {
 	mCallFramesToAdd.emplace_back(functionName, labelName);
 	mHasCallFramesToAdd = true;
+
+	// Leave the runtime's fast calls mode, so that the next return gets handled by the connector
+	mLemonScriptRuntime.getInternalLemonRuntime().triggerStopSignal();
 }
 
 void CodeExec::processCallFrames()
@@ -750,6 +760,7 @@ bool CodeExec::executeRuntimeSteps(size_t& stepsExecuted, size_t minimumCallStac
 {
 	lemon::Runtime& runtime = mLemonScriptRuntime.getInternalLemonRuntime();
 	RuntimeExecuteConnector connector(*this);
+	connector.mUseFastCalls = !mHasCallFramesToAdd;		// Without call frame tracking, calls and returns only need handling if call frames are waiting to be added
 	runtime.executeSteps(connector, 5000, minimumCallStackSize);
 
 	stepsExecuted = connector.mStepsExecuted;
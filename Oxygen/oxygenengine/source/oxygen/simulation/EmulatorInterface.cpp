@@ -17,11 +17,114 @@
 namespace emulatorinterface
 {
 
+	// Lookup of the watches affected by a memory write
+	//  -> A bitmap of 256-byte pages rejects most writes right away
+	//  -> Hits are resolved with an interval tree, stored implicitly as a balanced binary tree over the watches sorted by start address
+	class WatchIndex
+	{
+	public:
+		void build(const std::vector<EmulatorInterface::Watch>& watches)
+		{
+			memset(mPageBits, 0, sizeof(mPageBits));
+			mNodes.clear();
+			for (size_t index = 0; index < watches.size(); ++index)
+			{
+				const EmulatorInterface::Watch& watch = watches[index];
+				if (watch.mBytes == 0)
+					continue;
+
+				Node& node = vectorAdd(mNodes);
+				node.mStart = watch.mAddress;
+				node.mEnd = watch.mAddress + watch.mBytes;
+				node.mWatchIndex = (uint32)index;
+
+				const uint32 lastPage = std::min((node.mEnd - 1) >> PAGE_SHIFT, NUM_PAGES - 1);
+				for (uint32 page = std::min(node.mStart >> PAGE_SHIFT, NUM_PAGES - 1); page <= lastPage; ++page)
+				{
+					mPageBits[page / 64] |= (1ull << (page % 64));
+				}
+			}
+
+			std::sort(mNodes.begin(), mNodes.end(), [](const Node& a, const Node& b) { return a.mStart < b.mStart; });
+			if (!mNodes.empty())
+				buildSubtree(0, mNodes.size());
+		}
+
+		FORCE_INLINE bool mayOverlap(uint32 address, uint32 bytes) const
+		{
+			const uint32 lastPage = std::min((address + bytes - 1) >> PAGE_SHIFT, NUM_PAGES - 1);
+			for (uint32 page = address >> PAGE_SHIFT; page <= lastPage; ++page)
+			{
+				if (mPageBits[page / 64] & (1ull << (page % 64)))
+					return true;
+			}
+			return false;
+		}
+
+		void collectOverlaps(std::vector<uint32>& outWatchIndices, uint32 start, uint32 end) const
+		{
+			if (!mNodes.empty())
+				collectOverlaps(outWatchIndices, start, end, 0, mNodes.size());
+		}
+
+	private:
+		struct Node
+		{
+			uint32 mStart = 0;
+			uint32 mEnd = 0;
+			uint32 mSubtreeMaxEnd = 0;	// Maximum end address of all nodes in the subtree with this node as root
+			uint32 mWatchIndex = 0;
+		};
+
+		// The subtree for the node range [first, last) has the middle node as root
+		uint32 buildSubtree(size_t first, size_t last)
+		{
+			const size_t middle = (first + last) / 2;
+			uint32 maxEnd = mNodes[middle].mEnd;
+			if (first < middle)
+				maxEnd = std::max(maxEnd, buildSubtree(first, middle));
+			if (middle + 1 < last)
+				maxEnd = std::max(maxEnd, buildSubtree(middle + 1, last));
+			mNodes[middle].mSubtreeMaxEnd = maxEnd;
+			return maxEnd;
+		}
+
+		void collectOverlaps(std::vector<uint32>& outWatchIndices, uint32 start, uint32 end, size_t first, size_t last) const
+		{
+			const size_t middle = (first + last) / 2;
+			const Node& node = mNodes[middle];
+			if (node.mSubtreeMaxEnd <= start)
+				return;
+
+			if (first < middle)
+				collectOverlaps(outWatchIndices, start, end, first, middle);
+
+			// Nodes on the right side all start at or after this one
+			if (node.mStart < end)
+			{
+				if (node.mEnd > start)
+					outWatchIndices.push_back(node.mWatchIndex);
+				if (middle + 1 < last)
+					collectOverlaps(outWatchIndices, start, end, middle + 1, last);
+			}
+		}
+
+	private:
+		static const uint32 PAGE_SHIFT = 8;
+		static const uint32 NUM_PAGES = 0x1000000 >> PAGE_SHIFT;
+
+		uint64 mPageBits[NUM_PAGES / 64] = { 0 };
+		std::vector<Node> mNodes;
+	};
+
+
 	struct Internal : public RuntimeMemory
 	{
 	public:
 		// Debugging
 		std::vector<EmulatorInterface::Watch> mWatches;
+		WatchIndex mWatchIndex;
+		std::vector<uint32> mWatchHitIndices;	// Only used as temporary buffer
 		DebugNotificationInterface* mDebugNotificationInterface = nullptr;
 
 	public:
@@ -101,13 +204,17 @@ namespace emulatorinterface
 			if (nullptr != mDebugNotificationInterface)
 			{
 				address &= 0x00ffffff;
-				for (size_t i = 0; i < mWatches.size(); ++i)
+				if (bytes == 0 || !mWatchIndex.mayOverlap(address, bytes))
+					return;
+
+				mWatchHitIndices.clear();
+				mWatchIndex.collectOverlaps(mWatchHitIndices, address, address + bytes);
+
+				// Notify in order of the watches, the same as a linear check would do
+				std::sort(mWatchHitIndices.begin(), mWatchHitIndices.end());
+				for (uint32 watchIndex : mWatchHitIndices)
 				{
-					const EmulatorInterface::Watch& watch = mWatches[i];
-					if (address + bytes > watch.mAddress && address < watch.mAddress + watch.mBytes)
-					{
-						mDebugNotificationInterface->onWatchTriggered(i, address, bytes);
-					}
+					mDebugNotificationInterface->onWatchTriggered(watchIndex, address, bytes);
 				}
 			}
 		}
@@ -381,11 +488,32 @@ uint16* EmulatorInterface::getVSRam()
 	return mInternal.mVSRam;
 }
 
-std::vector<EmulatorInterface::Watch>& EmulatorInterface::getWatches()
+const std::vector<EmulatorInterface::Watch>& EmulatorInterface::getWatches() const
 {
 	return mInternal.mWatches;
 }
 
+void EmulatorInterface::addWatch(uint32 address, uint16 bytes)
+{
+	EmulatorInterface::Watch& watch = vectorAdd(mInternal.mWatches);
+	watch.mAddress = address & 0x00ffffff;
+	watch.mBytes = bytes;
+	mInternal.mWatchIndex.build(mInternal.mWatches);
+}
+
+void EmulatorInterface::removeWatch(size_t index)
+{
+	RMX_CHECK(index < mInternal.mWatches.size(), "Invalid watch index " << index, return);
+	mInternal.mWatches.erase(mInternal.mWatches.begin() + index);
+	mInternal.mWatchIndex.build(mInternal.mWatches);
+}
+
+void EmulatorInterface::clearWatches()
+{
+	mInternal.mWatches.clear();
+	mInternal.mWatchIndex.build(mInternal.mWatches);
+}
+
 void EmulatorInterface::getDirectAccessSpecialization(SpecializationResult& outResult, uint64 address, size_t size, bool writeAccess)
 {
 	outResult.mSwapBytes = true;
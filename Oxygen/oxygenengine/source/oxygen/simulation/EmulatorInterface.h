@@ -115,7 +115,10 @@ public:
 	uint16* getVSRam();
 
 	// RAM watches
-	std::vector<Watch>& getWatches();
+	const std::vector<Watch>& getWatches() const;
+	void addWatch(uint32 address, uint16 bytes);
+	void removeWatch(size_t index);
+	void clearWatches();
 
 public:
 	// MemoryAccessHandler interface implementation
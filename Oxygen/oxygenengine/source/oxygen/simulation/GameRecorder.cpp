@@ -13,6 +13,103 @@
 #include "oxygen/helper/FileHelper.h"
 
 
+namespace
+{
+	// Full keyframes get stored at least this often, all keyframes in between are stored as differences to the last full keyframe
+	static const uint32 FULL_KEYFRAME_INTERVAL = 900;
+
+	void writeVarInt(std::vector<uint8>& output, size_t value)
+	{
+		while (value >= 0x80)
+		{
+			output.push_back((uint8)(value | 0x80));
+			value >>= 7;
+		}
+		output.push_back((uint8)value);
+	}
+
+	size_t readVarInt(const uint8*& input, const uint8* end)
+	{
+		size_t value = 0;
+		for (int shift = 0; input < end; shift += 7)
+		{
+			const uint8 byte = *input;
+			++input;
+			value |= (size_t)(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+				break;
+		}
+		return value;
+	}
+
+	void encodeDifferential(std::vector<uint8>& output, const std::vector<uint8>& data, const std::vector<uint8>& baseData)
+	{
+		// Output format:
+		//  - Data size as var-int
+		//  - Then pairs of var-ints for the number of unchanged bytes and the number of changed bytes, followed by the changed bytes XOR'ed with the base data
+		//  - Base data beyond its size is treated as zeroes
+		const size_t MIN_UNCHANGED_RUN = 4;		// Shorter runs of unchanged bytes are simply included in the changed bytes
+		const size_t size = data.size();
+		const size_t baseSize = std::min(baseData.size(), size);
+		const auto getBaseByte = [&](size_t position) { return (position < baseSize) ? baseData[position] : 0; };
+
+		output.clear();
+		writeVarInt(output, size);
+
+		size_t position = 0;
+		while (position < size)
+		{
+			const size_t unchangedStart = position;
+			while (position < size && data[position] == getBaseByte(position))
+				++position;
+			if (position >= size)
+				break;
+
+			const size_t changedStart = position;
+			size_t unchangedCount = 0;
+			while (position < size && unchangedCount < MIN_UNCHANGED_RUN)
+			{
+				unchangedCount = (data[position] == getBaseByte(position)) ? (unchangedCount + 1) : 0;
+				++position;
+			}
+			position -= unchangedCount;
+
+			writeVarInt(output, changedStart - unchangedStart);
+			writeVarInt(output, position - changedStart);
+			for (size_t k = changedStart; k < position; ++k)
+				output.push_back(data[k] ^ getBaseByte(k));
+		}
+	}
+
+	bool decodeDifferential(std::vector<uint8>& output, const std::vector<uint8>& delta, const std::vector<uint8>& baseData)
+	{
+		const uint8* input = delta.data();
+		const uint8* end = input + delta.size();
+		const size_t size = readVarInt(input, end);
+
+		output.resize(size);
+		const size_t baseSize = std::min(baseData.size(), size);
+		memcpy(output.data(), baseData.data(), baseSize);
+		memset(output.data() + baseSize, 0, size - baseSize);
+
+		size_t position = 0;
+		while (input < end)
+		{
+			position += readVarInt(input, end);
+			const size_t changedCount = readVarInt(input, end);
+			if (position + changedCount > size || input + changedCount > end)
+				return false;
+
+			for (size_t k = 0; k < changedCount; ++k)
+				output[position + k] ^= input[k];
+			input += changedCount;
+			position += changedCount;
+		}
+		return true;
+	}
+}
+
+
 GameRecorder::GameRecorder()
 {
 	updateFromConfig();
@@ -68,9 +165,25 @@ void GameRecorder::addFrame(uint32 frameNumber, const InputData& input)
 void GameRecorder::addKeyFrame(uint32 frameNumber, const InputData& input, const std::vector<uint8>& data)
 {
 	RMX_ASSERT(frameNumber >= mRangeStart && frameNumber <= mRangeEnd, "Invalid frame number");
-	Frame& frame = addFrameInternal(frameNumber, input, Frame::Type::KEYFRAME);
-	frame.mType = Frame::Type::KEYFRAME;
-	frame.mData = data;
+
+	// Store only the difference to the last full keyframe, if there's one that is recent enough
+	const Frame* baseFrame = findBaseKeyframe(frameNumber);
+	const std::vector<uint8>* baseData = (nullptr == baseFrame) ? nullptr : getKeyframeData(*baseFrame, mDecodedBaseData, mDecodedBaseData);
+	if (nullptr != baseData)
+	{
+		encodeDifferential(mDecodedData, data, *baseData);
+
+		const uint32 baseFrameNumber = baseFrame->mNumber;
+		Frame& frame = addFrameInternal(frameNumber, input, Frame::Type::DIFFERENTIAL);
+		frame.mBaseFrameNumber = baseFrameNumber;
+		frame.mData.assign(mDecodedData.begin(), mDecodedData.end());
+		frame.mData.shrink_to_fit();
+	}
+	else
+	{
+		Frame& frame = addFrameInternal(frameNumber, input, Frame::Type::KEYFRAME);
+		frame.mData = data;
+	}
 }
 
 void GameRecorder::discardOldFrames(uint32 minKeepNumber)
@@ -88,10 +201,16 @@ void GameRecorder::discardOldFrames(uint32 minKeepNumber)
 	// Go back to the last keyframe, as we can't keep dependent frames whose keyframes get discarded
 	for (; firstIndexToKeep > 0; --firstIndexToKeep)
 	{
-		if (mFrames[firstIndexToKeep]->mType == Frame::Type::KEYFRAME)
+		if (mFrames[firstIndexToKeep]->mType != Frame::Type::INPUT_ONLY)
 			break;
 	}
 
+	// A differential keyframe also requires its base keyframe, and that one is always the oldest one referenced by any later frame
+	if (mFrames.size() > firstIndexToKeep && mFrames[firstIndexToKeep]->mType == Frame::Type::DIFFERENTIAL && mFrames[firstIndexToKeep]->mBaseFrameNumber >= mRangeStart)
+	{
+		firstIndexToKeep = std::min<size_t>(firstIndexToKeep, mFrames[firstIndexToKeep]->mBaseFrameNumber - mRangeStart);
+	}
+
 	if (firstIndexToKeep > 0)
 	{
 		for (size_t index = 0; index < firstIndexToKeep; ++index)
@@ -114,14 +233,20 @@ void GameRecorder::discardFramesAfter(uint32 frameNumber)
 	if (frameNumber < mRangeStart || frameNumber + 1 >= mRangeEnd)
 		return;
 
+	// Return the discarded frames to their pools, so that the frames recorded again after a rollback can reuse them
+	const size_t firstIndexToDiscard = (size_t)(frameNumber + 1 - mRangeStart);
+	for (size_t index = firstIndexToDiscard; index < mFrames.size(); ++index)
+	{
+		destroyFrame(*mFrames[index]);
+	}
+	mFrames.erase(mFrames.begin() + firstIndexToDiscard, mFrames.end());
 	mRangeEnd = frameNumber + 1;
-	mFrames.erase(mFrames.begin() + (mRangeEnd - mRangeStart), mFrames.end());
 }
 
 bool GameRecorder::isKeyframe(uint32 frameNumber) const
 {
 	const Frame* frame = getFrameInternal(frameNumber);
-	return (nullptr != frame && frame->mType == Frame::Type::KEYFRAME);
+	return (nullptr != frame && frame->mType != Frame::Type::INPUT_ONLY);
 }
 
 bool GameRecorder::getFrameData(uint32 frameNumber, PlaybackResult& outResult)
@@ -132,10 +257,10 @@ bool GameRecorder::getFrameData(uint32 frameNumber, PlaybackResult& outResult)
 
 	outResult.mInput = &frame->mInput;
 
-	if (frame->mType == Frame::Type::KEYFRAME)
+	if (frame->mType != Frame::Type::INPUT_ONLY)
 	{
-		// TODO: Handle "frame.mCompressedData == true" (not needed for pure playback after loading from file)
-		outResult.mData = &frame->mData;
+		// Note that the returned data may be stored in a temporary buffer, so it's only valid until the next call
+		outResult.mData = getKeyframeData(*frame, mDecodedData, mDecodedBaseData);
 	}
 	return true;
 }
@@ -198,6 +323,59 @@ const GameRecorder::Frame* GameRecorder::getFrameInternal(uint32 frameNumber) co
 	return hasFrameNumber(frameNumber) ? mFrames[frameNumber - mRangeStart] : nullptr;
 }
 
+const GameRecorder::Frame* GameRecorder::findBaseKeyframe(uint32 frameNumber) const
+{
+	// Search for the most recent full keyframe before the given frame number, within the full keyframe interval
+	const uint32 minFrameNumber = (frameNumber >= FULL_KEYFRAME_INTERVAL) ? std::max(frameNumber - FULL_KEYFRAME_INTERVAL + 1, mRangeStart) : mRangeStart;
+	for (uint32 number = std::min(frameNumber, mRangeEnd); number > minFrameNumber; --number)
+	{
+		const Frame& frame = *mFrames[number - 1 - mRangeStart];
+		if (frame.mType == Frame::Type::KEYFRAME)
+		{
+			return &frame;
+		}
+		else if (frame.mType == Frame::Type::DIFFERENTIAL)
+		{
+			// Differential keyframes always refer to the most recent full keyframe before them
+			return (frame.mBaseFrameNumber >= minFrameNumber) ? getFrameInternal(frame.mBaseFrameNumber) : nullptr;
+		}
+	}
+	return nullptr;
+}
+
+const std::vector<uint8>* GameRecorder::getKeyframeData(const Frame& frame, std::vector<uint8>& buffer, std::vector<uint8>& baseBuffer) const
+{
+	switch (frame.mType)
+	{
+		case Frame::Type::KEYFRAME:
+		{
+			if (!frame.mCompressedData)
+				return &frame.mData;
+
+			// Data got compressed when saving the recording
+			buffer.clear();
+			if (!ZlibDeflate::decode(buffer, frame.mData.data(), frame.mData.size()))
+				return nullptr;
+			return &buffer;
+		}
+
+		case Frame::Type::DIFFERENTIAL:
+		{
+			const Frame* baseFrame = getFrameInternal(frame.mBaseFrameNumber);
+			if (nullptr == baseFrame || baseFrame->mType != Frame::Type::KEYFRAME)
+				return nullptr;
+
+			const std::vector<uint8>* baseData = getKeyframeData(*baseFrame, baseBuffer, baseBuffer);
+			if (nullptr == baseData || !decodeDifferential(buffer, frame.mData, *baseData))
+				return nullptr;
+			return &buffer;
+		}
+
+		default:
+			return nullptr;
+	}
+}
+
 GameRecorder::Frame& GameRecorder::addFrameInternal(uint32 frameNumber, const InputData& input, Frame::Type frameType)
 {
 	Frame& frame = createFrameInternal(frameType, frameNumber);
@@ -221,12 +399,17 @@ bool GameRecorder::serializeRecording(VectorBinarySerializer& serializer, uint32
 	std::vector<uint8> buffer;
 
 	// Signature and format version
-	int formatVersion = 2;
+	//  -> Version 3 added differential keyframes
+	int formatVersion = 3;
 	if (serializer.isReading())
 	{
 		char signature[4];
 		serializer.read(signature, 4);
-		if (memcmp(signature, "GRC2", 4) == 0)
+		if (memcmp(signature, "GRC3", 4) == 0)
+		{
+			formatVersion = 3;
+		}
+		else if (memcmp(signature, "GRC2", 4) == 0)
 		{
 			formatVersion = 2;
 		}
@@ -245,7 +428,7 @@ bool GameRecorder::serializeRecording(VectorBinarySerializer& serializer, uint32
 	}
 	else
 	{
-		const char SIGNATURE[] = "GRC2";
+		const char SIGNATURE[] = "GRC3";
 		serializer.write(SIGNATURE, 4);
 	}
 
@@ -307,6 +490,8 @@ bool GameRecorder::serializeRecording(VectorBinarySerializer& serializer, uint32
 	serializer.serialize(frameCount);
 
 	size_t lastKeyframeIndex = 0;
+	const Frame* lastSavedFullKeyframe = nullptr;
+	const std::vector<uint8>* reconstructedData = nullptr;
 	for (uint32 index = 0; index < frameCount; ++index)
 	{
 		Frame* frame = nullptr;
@@ -316,6 +501,8 @@ bool GameRecorder::serializeRecording(VectorBinarySerializer& serializer, uint32
 		if (serializer.isReading())
 		{
 			serializer.serializeAs<uint8>(frameType);
+			if (frameType > Frame::Type::DIFFERENTIAL || (frameType == Frame::Type::DIFFERENTIAL && formatVersion < 3))
+				return false;
 			frame = &createFrameInternal(frameType, index);
 			mFrames.push_back(frame);
 		}
@@ -323,12 +510,24 @@ bool GameRecorder::serializeRecording(VectorBinarySerializer& serializer, uint32
 		{
 			frame = mFrames[index];
 			frameType = frame->mType;
-			if (frameType == Frame::Type::KEYFRAME)
+			reconstructedData = nullptr;
+			if (frameType != Frame::Type::INPUT_ONLY)
 			{
 				if (index == 0 || index - lastKeyframeIndex >= minDistanceBetweenKeyframes)
 				{
 					// Save as keyframe
 					lastKeyframeIndex = index;
+
+					// Differential keyframes have to be saved as full keyframes if their base keyframe does not get saved
+					if (frameType == Frame::Type::DIFFERENTIAL && (nullptr == lastSavedFullKeyframe || lastSavedFullKeyframe->mNumber != frame->mBaseFrameNumber))
+					{
+						reconstructedData = getKeyframeData(*frame, mDecodedData, mDecodedBaseData);
+						frameType = (nullptr == reconstructedData) ? Frame::Type::INPUT_ONLY : Frame::Type::KEYFRAME;
+					}
+					else if (frameType == Frame::Type::KEYFRAME)
+					{
+						lastSavedFullKeyframe = frame;
+					}
 				}
 				else
 				{
@@ -380,6 +579,16 @@ bool GameRecorder::serializeRecording(VectorBinarySerializer& serializer, uint32
 					}
 				}
 			}
+			else if (nullptr != reconstructedData)
+			{
+				// Full keyframe reconstructed from a differential keyframe
+				buffer.clear();
+				ZlibDeflate::encode(buffer, reconstructedData->data(), reconstructedData->size());
+
+				const uint32 dataSize = (uint32)buffer.size();
+				serializer.write(dataSize);
+				serializer.write(buffer.data(), dataSize);
+			}
 			else
 			{
 				if (!frame->mCompressedData)
@@ -397,6 +606,31 @@ bool GameRecorder::serializeRecording(VectorBinarySerializer& serializer, uint32
 				serializer.write(&frame->mData[0], dataSize);
 			}
 		}
+		else if (frameType == Frame::Type::DIFFERENTIAL)
+		{
+			// Differential keyframe data, with the distance to the base keyframe
+			if (serializer.isReading())
+			{
+				const uint32 baseDistance = serializer.read<uint32>();
+				if (baseDistance == 0 || baseDistance > index)
+					return false;
+				frame->mBaseFrameNumber = index - baseDistance;
+
+				const uint32 dataSize = serializer.read<uint32>();
+				ZlibDeflate::decode(frame->mData, serializer.peek(), dataSize);
+				serializer.skip(dataSize);
+			}
+			else
+			{
+				serializer.write<uint32>(frame->mNumber - frame->mBaseFrameNumber);
+
+				buffer.clear();
+				ZlibDeflate::encode(buffer, frame->mData.data(), frame->mData.size());
+				const uint32 dataSize = (uint32)buffer.size();
+				serializer.write(dataSize);
+				serializer.write(buffer.data(), dataSize);
+			}
+		}
 	}
 
 	if (serializer.isReading())
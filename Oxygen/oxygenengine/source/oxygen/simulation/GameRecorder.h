@@ -64,14 +64,15 @@ private:
 		{
 			INPUT_ONLY,
 			KEYFRAME,
-			//DIFFERENTIAL	// Difference to last keyframe; not implemented yet
+			DIFFERENTIAL	// Difference to a previous full keyframe, see "mBaseFrameNumber"
 		};
 
 		Type mType = Type::INPUT_ONLY;
 		uint32 mNumber = 0;
 		InputData mInput;
 		bool mCompressedData = false;
-		std::vector<uint8> mData;
+		std::vector<uint8> mData;	// For differential keyframes, this is the run-length encoded XOR delta to the base keyframe's data
+		uint32 mBaseFrameNumber = 0;
 	};
 
 private:
@@ -80,6 +81,8 @@ private:
 	Frame* getFrameInternal(uint32 frameNumber);
 	const Frame* getFrameInternal(uint32 frameNumber) const;
 	Frame& addFrameInternal(uint32 frameNumber, const InputData& input, Frame::Type frameType);
+	const Frame* findBaseKeyframe(uint32 frameNumber) const;
+	const std::vector<uint8>* getKeyframeData(const Frame& frame, std::vector<uint8>& buffer, std::vector<uint8>& baseBuffer) const;
 
 	bool serializeRecording(VectorBinarySerializer& serializer, uint32 minDistanceBetweenKeyframes);
 
@@ -94,4 +97,7 @@ private:
 	uint32 mRangeStart = 0;			// Frame number of first frame stored in mFrames
 	uint32 mRangeEnd = 0;			// Frame number of last frame stored in mFrames plus one (!)
 	bool mIgnoreKeys = false;
+
+	std::vector<uint8> mDecodedData;		// Keyframe data returned by "getFrameData", if it needed to be decompressed or reconstructed
+	std::vector<uint8> mDecodedBaseData;
 };
@@ -10,6 +10,7 @@
 #include "oxygen/simulation/LemonScriptProgram.h"
 #include "oxygen/simulation/EmulatorInterface.h"
 #include "oxygen/simulation/LogDisplay.h"
+#include "oxygen/simulation/ModScriptNativization.h"
 #include "oxygen/application/modding/ModManager.h"
 #include "oxygen/helper/Utils.h"
 #include "oxygen/platform/PlatformFunctions.h"
@@ -21,6 +22,7 @@
 #include <lemon/program/Module.h>
 #include <lemon/program/Program.h>
 #include <lemon/runtime/StandardLibrary.h>
+#include <lemon/runtime/provider/NativizedOpcodeProvider.h>
 #include <lemon/utility/PragmaSplitter.h>
 
 
@@ -32,6 +34,60 @@ struct ModuleAppendedInfo : public lemon::Module::AppendedInfo
 };
 
 
+namespace
+{
+	uint64 buildScriptSourcesHash(const std::wstring& scriptsPath)
+	{
+		// Hash all script files in the given directory, including sub-directories
+		//  -> This can include files that are not actually used, but it's way simpler than tracking the includes (especially the wildcard includes)
+		std::vector<rmx::FileIO::FileEntry> fileEntries;
+		FTX::FileSystem->listFilesByMask(scriptsPath + L"*.lemon", true, fileEntries);
+
+		std::vector<std::wstring> filePaths;
+		filePaths.reserve(fileEntries.size());
+		for (const rmx::FileIO::FileEntry& fileEntry : fileEntries)
+		{
+			filePaths.emplace_back(fileEntry.mPath + fileEntry.mFilename);
+		}
+		std::sort(filePaths.begin(), filePaths.end());
+
+		uint64 hash = rmx::startFNV1a_64();
+		std::vector<uint8> content;
+		for (const std::wstring& filePath : filePaths)
+		{
+			if (!FTX::FileSystem->readFile(filePath, content))
+				continue;
+
+			// Use paths relative to the scripts directory, so that moving the whole mod does not change the hash
+			const uint64 pathHash = rmx::getMurmur2_64(rmx::startsWith(filePath, scriptsPath) ? std::wstring_view(filePath).substr(scriptsPath.length()) : std::wstring_view(filePath));
+			const uint64 contentHash = rmx::getMurmur2_64(content.data(), content.size());
+			hash = rmx::addToFNV1a_64(hash, (const uint8*)&pathHash, sizeof(pathHash));
+			hash = rmx::addToFNV1a_64(hash, (const uint8*)&contentHash, sizeof(contentHash));
+		}
+		return hash;
+	}
+
+	uint64 buildModModuleCacheKey(uint64 previousCacheKey, uint64 scriptSourcesHash, uint32 dependencyHash, uint32 appVersion)
+	{
+		// Needs to be increased when cache files written before need to be ignored, e.g. because they lack the compiler warnings
+		const uint32 CACHE_FORMAT_VERSION = 2;
+
+		uint64 hash = rmx::startFNV1a_64();
+		hash = rmx::addToFNV1a_64(hash, (const uint8*)&CACHE_FORMAT_VERSION, sizeof(CACHE_FORMAT_VERSION));
+		hash = rmx::addToFNV1a_64(hash, (const uint8*)&previousCacheKey, sizeof(previousCacheKey));
+		hash = rmx::addToFNV1a_64(hash, (const uint8*)&scriptSourcesHash, sizeof(scriptSourcesHash));
+		hash = rmx::addToFNV1a_64(hash, (const uint8*)&dependencyHash, sizeof(dependencyHash));
+		hash = rmx::addToFNV1a_64(hash, (const uint8*)&appVersion, sizeof(appVersion));
+		return hash;
+	}
+
+	std::wstring getModModuleCacheFilePrefix(const Mod& mod)
+	{
+		return Configuration::instance().mScriptCacheDir + String(rmx::hexString(rmx::getMurmur2_64(mod.mUniqueID), 16, "")).toStdWString() + L"_";
+	}
+}
+
+
 struct LemonScriptProgram::Internal
 {
 	lemon::Module mLemonCoreModule;
@@ -42,10 +98,14 @@ struct LemonScriptProgram::Internal
 	lemon::Program mProgram;
 	LemonScriptBindings	mLemonScriptBindings;
 	lemon::GlobalsLookup mGlobalsLookupCoreOnly;
+	uint64 mScriptModuleContentHash = 0;	// Identifies the state of the base script module, as a starting point for the mod module cache keys
+	lemon::NativizedOpcodeProvider* mGameNativizedOpcodeProvider = nullptr;	// Game-specific nativized code, as registered by the engine delegate
+	lemon::NativizedOpcodeProvider mModNativizedOpcodeProvider;			// Game-specific nativized code plus nativized mod scripts
 
 	Hook mPreUpdateHook;
 	Hook mPostUpdateHook;
 	LinearLookupTable<Hook, 0x400000, 6, 1024> mAddressHooks;
+	std::vector<const Hook*> mAddressHookList;		// All address hooks in order of creation
 
 	inline Internal() :
 		mLemonCoreModule("LemonCore"),
@@ -60,6 +120,7 @@ LemonScriptProgram::LemonScriptProgram() :
 {
 	// Register game-specific nativized code
 	EngineMain::getDelegate().registerNativizedCode(mInternal.mProgram);
+	mInternal.mGameNativizedOpcodeProvider = mInternal.mProgram.mNativizedOpcodeProvider;
 
 	Configuration& config = Configuration::instance();
 	mInternal.mLemonCoreModule.clear();
@@ -188,6 +249,21 @@ LemonScriptProgram::LoadScriptsResult LemonScriptProgram::loadScripts(std::wstri
 		config.mRunScriptNativization = 2;		// Mark as done
 	}
 
+	// Optional load-time nativization of mod scripts
+	mInternal.mProgram.mNativizedOpcodeProvider = mInternal.mGameNativizedOpcodeProvider;
+	if (config.mModScriptNativization.mEnabled && ModScriptNativization::isSupported() && mInternal.mProgram.getOptimizationLevel() >= 2 && !mInternal.mModModules.empty())
+	{
+		lemon::NativizedOpcodeProvider& provider = mInternal.mModNativizedOpcodeProvider;
+		provider = (nullptr != mInternal.mGameNativizedOpcodeProvider) ? *mInternal.mGameNativizedOpcodeProvider : lemon::NativizedOpcodeProvider();
+		for (const lemon::Module* module : mInternal.mModModules)
+		{
+			ModScriptNativization::addNativizedModule(provider, *module, mInternal.mProgram, loadOptions.mAppVersion);
+		}
+
+		if (provider.isValid())
+			mInternal.mProgram.mNativizedOpcodeProvider = &provider;
+	}
+
 	// Scan for function pragmas defining hooks
 	collectHooksFromFunctions();
 
@@ -223,6 +299,11 @@ size_t LemonScriptProgram::getNumAddressHooks() const
 	return mInternal.mAddressHooks.size();
 }
 
+const std::vector<const LemonScriptProgram::Hook*>& LemonScriptProgram::getAddressHooks() const
+{
+	return mInternal.mAddressHookList;
+}
+
 std::string_view LemonScriptProgram::getFunctionNameByHash(uint64 hash) const
 {
 	const auto& list = mInternal.mProgram.getFunctionsByName(hash);
@@ -294,6 +375,7 @@ LemonScriptProgram::LoadingResult LemonScriptProgram::loadAllScriptModules(const
 	if (!baseScriptFilename.empty())
 	{
 		mInternal.mScriptModule.clear();
+		mInternal.mScriptModuleContentHash = 0;
 		const uint32 coreModuleDependencyHash = mInternal.mLemonCoreModule.buildDependencyHash() + mInternal.mOxygenCoreModule.buildDependencyHash();
 
 		// Load scripts
@@ -376,6 +458,15 @@ LemonScriptProgram::LoadingResult LemonScriptProgram::loadAllScriptModules(const
 
 		if (!modsToLoad.empty())
 		{
+			// Cache keys are chained, so that each mod module's key depends on everything loaded before it as well
+			uint64 cacheKey = mInternal.mScriptModuleContentHash;
+			for (const auto& pair : config.mPreprocessorDefinitions.getDefinitions())
+			{
+				cacheKey = rmx::addToFNV1a_64(cacheKey, (const uint8*)&pair.first, sizeof(pair.first));
+				cacheKey = rmx::addToFNV1a_64(cacheKey, (const uint8*)&pair.second.mValue, sizeof(pair.second.mValue));
+			}
+			uint32 dependencyHash = mInternal.mLemonCoreModule.buildDependencyHash() + mInternal.mOxygenCoreModule.buildDependencyHash() + mInternal.mScriptModule.buildDependencyHash();
+
 			lemon::Module* previousModule = &mInternal.mScriptModule;
 			for (const Mod* mod : modsToLoad)
 			{
@@ -385,14 +476,32 @@ LemonScriptProgram::LoadingResult LemonScriptProgram::loadAllScriptModules(const
 					previousModule = nullptr;
 				}
 
-				// Create and compile module
+				// Create module and load it from the cache, or compile it if there were any changes
 				lemon::Module* module = new lemon::Module(mod->mUniqueID, new ModuleAppendedInfo(mod));
-				const std::wstring mainScriptFilename = mod->mFullPath + L"scripts/main.lemon";
-				loadingResult = loadScriptModule(*module, globalsLookup, mainScriptFilename);
+				const std::wstring scriptsPath = mod->mFullPath + L"scripts/";
+				cacheKey = buildModModuleCacheKey(cacheKey, buildScriptSourcesHash(scriptsPath), dependencyHash, loadOptions.mAppVersion);
+				const std::wstring cacheFilename = getModModuleCacheFilePrefix(*mod) + String(rmx::hexString(cacheKey, 16, "")).toStdWString() + L".bin";
+
+				const bool useCache = !config.mScriptCacheDir.empty();
+				if (useCache && !config.mForceCompileScripts && loadModModuleFromCache(*module, globalsLookup, cacheFilename, dependencyHash, loadOptions))
+				{
+					module->setScriptBasePath(scriptsPath);
+					loadingResult = LoadingResult::SUCCESS;
+				}
+				else
+				{
+					loadingResult = loadScriptModule(*module, globalsLookup, scriptsPath + L"main.lemon");
+					if (loadingResult == LoadingResult::SUCCESS && useCache)
+					{
+						saveModModuleToCache(*module, globalsLookup, cacheFilename, dependencyHash, loadOptions);
+					}
+				}
+
 				if (loadingResult == LoadingResult::SUCCESS)
 				{
 					mInternal.mModModules.push_back(module);
 					previousModule = module;
+					dependencyHash += module->buildDependencyHash();
 				}
 				else
 				{
@@ -421,6 +530,7 @@ bool LemonScriptProgram::loadBaseScriptFromSource(lemon::GlobalsLookup& globalsL
 		mInternal.mScriptModule.clear();
 		return false;
 	}
+	mInternal.mScriptModuleContentHash = buildScriptSourcesHash(mInternal.mScriptModule.getScriptBasePath());
 
 	Configuration& config = Configuration::instance();
 	if (!config.mCompiledScriptSavePath.empty())
@@ -453,6 +563,7 @@ bool LemonScriptProgram::loadBaseScriptFromBinary(lemon::GlobalsLookup& globalsL
 	VectorBinarySerializer serializer(true, buffer);
 	loaded = mInternal.mScriptModule.serialize(serializer, globalsLookup, coreModuleDependencyHash, loadOptions.mAppVersion);
 	RMX_CHECK(loaded, "Failed to load 'scripts.bin'", );
+	mInternal.mScriptModuleContentHash = rmx::getMurmur2_64(buffer.data(), buffer.size());
 	return loaded;
 }
 
@@ -466,9 +577,49 @@ bool LemonScriptProgram::loadBaseScriptFromCache(lemon::GlobalsLookup& globalsLo
 	VectorBinarySerializer serializer(true, buffer);
 	const bool scriptsLoaded = mInternal.mScriptModule.serialize(serializer, globalsLookup, coreModuleDependencyHash, loadOptions.mAppVersion);
 	RMX_CHECK(scriptsLoaded, "Failed to deserialize scripts, possibly because the compiled script file '" << WString(config.mCompiledScriptSavePath).toStdString() << "' is using an older format", );
+	mInternal.mScriptModuleContentHash = rmx::getMurmur2_64(buffer.data(), buffer.size());
 	return scriptsLoaded;
 }
 
+bool LemonScriptProgram::loadModModuleFromCache(lemon::Module& module, lemon::GlobalsLookup& globalsLookup, const std::wstring& cacheFilename, uint32 dependencyHash, const LoadOptions& loadOptions)
+{
+	std::vector<uint8> buffer;
+	if (!FTX::FileSystem->readFile(cacheFilename, buffer))
+		return false;
+
+	VectorBinarySerializer serializer(true, buffer);
+	if (!module.serialize(serializer, globalsLookup, dependencyHash, loadOptions.mAppVersion))
+	{
+		// Cache file is outdated, e.g. using an older format, so just ignore it
+		module.clear();
+		return false;
+	}
+	return true;
+}
+
+void LemonScriptProgram::saveModModuleToCache(lemon::Module& module, lemon::GlobalsLookup& globalsLookup, const std::wstring& cacheFilename, uint32 dependencyHash, const LoadOptions& loadOptions)
+{
+	std::vector<uint8> buffer;
+	VectorBinarySerializer serializer(false, buffer);
+	if (!module.serialize(serializer, globalsLookup, dependencyHash, loadOptions.mAppVersion))
+		return;
+
+	// Remove outdated cache files for the same mod
+	//  -> The cache file name consists of a prefix identifying the mod, and the cache key
+	const size_t separatorPosition = cacheFilename.find_last_of(L'_');
+	if (separatorPosition != std::wstring::npos)
+	{
+		std::vector<rmx::FileIO::FileEntry> fileEntries;
+		FTX::FileSystem->listFilesByMask(cacheFilename.substr(0, separatorPosition + 1) + L"*.bin", false, fileEntries);
+		for (const rmx::FileIO::FileEntry& fileEntry : fileEntries)
+		{
+			FTX::FileSystem->removeFile(fileEntry.mPath + fileEntry.mFilename);
+		}
+	}
+
+	FTX::FileSystem->saveFile(cacheFilename, buffer);
+}
+
 LemonScriptProgram::LoadingResult LemonScriptProgram::loadScriptModule(lemon::Module& module, lemon::GlobalsLookup& globalsLookup, std::wstring_view filename)
 {
 	// Compile script source
@@ -565,6 +716,7 @@ LemonScriptProgram::LoadingResult LemonScriptProgram::loadScriptModule(lemon::Mo
 void LemonScriptProgram::collectHooksFromFunctions()
 {
 	mInternal.mAddressHooks.clear();
+	mInternal.mAddressHookList.clear();
 
 	// Go through all functions
 	for (const lemon::ScriptFunction* function : mInternal.mProgram.getScriptFunctions())
@@ -668,6 +820,7 @@ LemonScriptProgram::Hook& LemonScriptProgram::addHook(Hook::Type type, uint32 ad
 			return dummy;
 		}
 		hook->mIndex = (uint32)mInternal.mAddressHooks.size();
+		mInternal.mAddressHookList.push_back(hook);
 	}
 	else
 	{
@@ -94,6 +94,7 @@ public:
 	const Hook* checkForUpdateHook(bool post);
 	const Hook* checkForAddressHook(uint32 address);
 	size_t getNumAddressHooks() const;
+	const std::vector<const Hook*>& getAddressHooks() const;		// If there are multiple hooks for the same address, the last one is the one that counts
 
 	std::string_view getFunctionNameByHash(uint64 hash) const;
 	lemon::Variable* getGlobalVariableByHash(uint64 hash) const;
@@ -122,6 +123,9 @@ private:
 	bool loadBaseScriptFromBinary(lemon::GlobalsLookup& globalsLookup, std::wstring_view filename, uint32 coreModuleDependencyHash, const LoadOptions& loadOptions);
 	bool loadBaseScriptFromCache(lemon::GlobalsLookup& globalsLookup, uint32 coreModuleDependencyHash, const LoadOptions& loadOptions);
 
+	bool loadModModuleFromCache(lemon::Module& module, lemon::GlobalsLookup& globalsLookup, const std::wstring& cacheFilename, uint32 dependencyHash, const LoadOptions& loadOptions);
+	void saveModModuleToCache(lemon::Module& module, lemon::GlobalsLookup& globalsLookup, const std::wstring& cacheFilename, uint32 dependencyHash, const LoadOptions& loadOptions);
+
 	LoadingResult loadScriptModule(lemon::Module& module, lemon::GlobalsLookup& globalsLookup, std::wstring_view filename);
 
 	void collectHooksFromFunctions();
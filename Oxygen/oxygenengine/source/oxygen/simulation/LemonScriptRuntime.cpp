@@ -54,9 +54,40 @@ namespace
 
 struct LemonScriptRuntime::Internal
 {
+	struct AddressHookEntry
+	{
+		const LemonScriptProgram::Hook* mHook = nullptr;
+		const lemon::RuntimeFunction* mRuntimeFunction = nullptr;
+	};
+
 	lemon::Runtime mRuntime;
 	RuntimeDetailHandler mRuntimeDetailHandler;
-	LinearLookupTable<const lemon::RuntimeFunction*, 0x400000, 6, 1024> mAddressHookLookup;
+	PageTableLookup<uint16, 0x400000, 8> mAddressHookTable;		// Index into "mAddressHookEntries" for each ROM address, with 0 meaning there's no hook
+	std::vector<AddressHookEntry> mAddressHookEntries;
+
+	void buildAddressHookTable(const LemonScriptProgram& program)
+	{
+		mAddressHookTable.clear();
+		mAddressHookEntries.clear();
+		vectorAdd(mAddressHookEntries);		// Index 0 is reserved for "no hook"
+
+		for (const LemonScriptProgram::Hook* hook : program.getAddressHooks())
+		{
+			RMX_CHECK(mAddressHookEntries.size() < 0x10000, "Too many address hooks", break);
+			RMX_ASSERT(nullptr != hook->mFunction, "Invalid address hook function");
+
+			AddressHookEntry& entry = vectorAdd(mAddressHookEntries);
+			entry.mHook = hook;
+			if (nullptr == hook->mLabel)
+			{
+				entry.mRuntimeFunction = mRuntime.getRuntimeFunction(*hook->mFunction);
+				RMX_ASSERT(nullptr != entry.mRuntimeFunction, "Unable to get runtime function for address hook at " << rmx::hexString(hook->mAddress, 8));
+			}
+
+			// Later hooks for the same address replace earlier ones
+			mAddressHookTable.set(hook->mAddress, (uint16)(mAddressHookEntries.size() - 1));
+		}
+	}
 };
 
 
@@ -140,11 +171,11 @@ void LemonScriptRuntime::onProgramUpdated()
 	// Assign lemon script program to runtime, implicitly resetting the runtime as well
 	mInternal.mRuntime.setProgram(mProgram.getInternalLemonProgram());
 
-	// Reset the lookup table for address hook runtime functions
-	mInternal.mAddressHookLookup.clear();
-
 	// Build all runtime functions right away
 	mInternal.mRuntime.buildAllRuntimeFunctions();
+
+	// Build the lookup table for address hooks, so that hook checks don't need to consult the program at all
+	mInternal.buildAddressHookTable(mProgram);
 }
 
 bool LemonScriptRuntime::serializeRuntime(VectorBinarySerializer& serializer)
@@ -171,38 +202,22 @@ bool LemonScriptRuntime::callAddressHook(uint32 address)
 		case 0:
 		{
 			// Address hook
-			const lemon::RuntimeFunction** runtimeFunctionPtr = mInternal.mAddressHookLookup.find(address);
-			if (nullptr != runtimeFunctionPtr)
+			const uint16 entryIndex = mInternal.mAddressHookTable.get(address);
+			if (entryIndex == 0)
+				return false;
+
+			const Internal::AddressHookEntry& entry = mInternal.mAddressHookEntries[entryIndex];
+			if (nullptr != entry.mRuntimeFunction)
+			{
+				mInternal.mRuntime.callRuntimeFunction(*entry.mRuntimeFunction);
+			}
+			else if (nullptr != entry.mHook->mLabel)
 			{
-				mInternal.mRuntime.callRuntimeFunction(**runtimeFunctionPtr);
+				mInternal.mRuntime.callFunctionAtLabel(*entry.mHook->mFunction, *entry.mHook->mLabel);
 			}
 			else
 			{
-				// Get the hook from the program first
-				const LemonScriptProgram::Hook* hook = mProgram.checkForAddressHook(address);
-				if (nullptr == hook)
-					return false;
-
-				if (nullptr != hook->mLabel)
-				{
-					mInternal.mRuntime.callFunctionAtLabel(*hook->mFunction, *hook->mLabel);
-				}
-				else
-				{
-					// Try to get the respective runtime function
-					RMX_ASSERT(nullptr != hook->mFunction, "Invalid address hook function");
-					const lemon::RuntimeFunction* runtimeFunction = mInternal.mRuntime.getRuntimeFunction(*hook->mFunction);
-					if (nullptr != runtimeFunction)
-					{
-						mInternal.mAddressHookLookup.add(address, runtimeFunction);
-						mInternal.mRuntime.callRuntimeFunction(*runtimeFunction);
-					}
-					else
-					{
-						RMX_ASSERT(false, "Unable to get runtime function for address hook at " << rmx::hexString(hook->mAddress, 8));
-						mInternal.mRuntime.callFunction(*hook->mFunction);
-					}
-				}
+				mInternal.mRuntime.callFunction(*entry.mHook->mFunction);
 			}
 			return true;
 		}
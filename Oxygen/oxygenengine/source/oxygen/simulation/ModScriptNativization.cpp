@@ -0,0 +1,222 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "oxygen/pch.h"
+#include "oxygen/simulation/ModScriptNativization.h"
+#include "oxygen/simulation/EmulatorInterface.h"
+#include "oxygen/application/Configuration.h"
+
+#include <lemon/program/Module.h>
+#include <lemon/program/Program.h>
+#include <lemon/runtime/provider/NativizedOpcodeProvider.h>
+
+#if defined(PLATFORM_LINUX)
+	#include <dlfcn.h>
+	#include <unistd.h>
+#endif
+
+
+namespace
+{
+#if defined(PLATFORM_LINUX)
+	// Source file that gets compiled into the shared library consists of these parts around the output of the nativizer
+	//  -> The nativized code goes into an anonymous namespace, so it can't collide with the game's own nativized code exported by the application
+	const char* WRAPPER_SOURCE_BEGIN =
+		"#include \"lemon/pch.h\"\n"
+		"#include \"lemon/program/Program.h\"\n"
+		"#include \"lemon/runtime/provider/NativizedOpcodeProvider.h\"\n"
+		"#include \"lemon/runtime/OpcodeExecUtils.h\"\n"
+		"#include \"lemon/runtime/RuntimeOpcodeContext.h\"\n"
+		"\n"
+		"namespace lemon\n"
+		"{\n"
+		"\tnamespace\n"
+		"\t{\n";
+
+	const char* WRAPPER_SOURCE_END =
+		"\n"
+		"\t}\n"
+		"}\n"
+		"\n"
+		"extern \"C\" void lemonCreateNativizedCodeLookup(lemon::Nativizer::LookupDictionary& dict)\n"
+		"{\n"
+		"\tlemon::createNativizedCodeLookup(dict);\n"
+		"}\n";
+
+	const char* LOOKUP_FUNCTION_NAME = "lemonCreateNativizedCodeLookup";
+
+	// Version of the binary interface between nativized code and the application
+	//  -> Increase this whenever a change in lemonscript or rmxbase makes code compiled against the previous headers incompatible
+	const uint32 NATIVIZATION_ABI_VERSION = 1;
+
+	// Loaded shared libraries stay loaded until the application exits, as runtime opcodes may still point to their code
+	static std::map<uint64, void*> loadedLibraries;
+
+	uint64 buildCacheKey(const std::vector<uint8>& nativizedCode, uint32 appVersion)
+	{
+		// Only depends on what actually goes into the shared library, so the same code always results in the same key
+		uint64 hash = rmx::startFNV1a_64();
+		hash = rmx::addToFNV1a_64(hash, nativizedCode.data(), nativizedCode.size());
+		hash = rmx::addToFNV1a_64(hash, (const uint8*)WRAPPER_SOURCE_BEGIN, strlen(WRAPPER_SOURCE_BEGIN));
+		hash = rmx::addToFNV1a_64(hash, (const uint8*)WRAPPER_SOURCE_END, strlen(WRAPPER_SOURCE_END));
+		hash = rmx::addToFNV1a_64(hash, (const uint8*)&NATIVIZATION_ABI_VERSION, sizeof(NATIVIZATION_ABI_VERSION));
+		hash = rmx::addToFNV1a_64(hash, (const uint8*)&appVersion, sizeof(appVersion));
+		return hash;
+	}
+
+	std::string getExecutableDirectory()
+	{
+		char buffer[4096];
+		const ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+		if (length <= 0)
+			return std::string();
+
+		const std::string path(buffer, (size_t)length);
+		return path.substr(0, path.find_last_of('/') + 1);
+	}
+
+	bool collectIncludePaths(std::vector<std::string>& outIncludePaths)
+	{
+		// Relative include paths are meant relative to the executable's directory, independent of the working directory
+		const std::string executableDirectory = getExecutableDirectory();
+		bool foundLemonscriptHeaders = false;
+		for (const std::string& includePath : Configuration::instance().mModScriptNativization.mIncludePaths)
+		{
+			const std::string path = (includePath.empty() || includePath[0] == '/') ? includePath : (executableDirectory + includePath);
+			if (!FTX::FileSystem->isDirectory(rmx::convertFromUTF8(path)))
+				continue;
+
+			outIncludePaths.push_back(path);
+			foundLemonscriptHeaders = foundLemonscriptHeaders || FTX::FileSystem->exists(rmx::convertFromUTF8(path + "/lemon/pch.h"));
+		}
+		return foundLemonscriptHeaders;
+	}
+
+	bool buildSharedLibrary(const lemon::Module& module, const std::vector<uint8>& nativizedCode, const std::wstring& basePath, const std::wstring& libraryFilename)
+	{
+		const Configuration::ModScriptNativization& settings = Configuration::instance().mModScriptNativization;
+		const std::wstring sourceFilename = basePath + L".cpp";
+		const std::wstring tempLibraryFilename = basePath + L".tmp";
+
+		std::vector<std::string> includePaths;
+		if (!collectIncludePaths(includePaths))
+		{
+			RMX_LOG_WARNING("Can't nativize scripts of module '" << module.getModuleName() << "', as the lemonscript headers were not found in any of the include paths");
+			return false;
+		}
+
+		std::string source = WRAPPER_SOURCE_BEGIN;
+		source.append((const char*)nativizedCode.data(), nativizedCode.size());
+		source += WRAPPER_SOURCE_END;
+		if (!FTX::FileSystem->saveFile(sourceFilename, source.data(), source.length()))
+			return false;
+
+		std::string command = "\"" + settings.mCompiler + "\" -O2 -std=c++17 -shared -fPIC";
+		for (const std::string& includePath : includePaths)
+		{
+			command += " -I\"" + includePath + "\"";
+		}
+		command += " \"" + rmx::convertToUTF8(sourceFilename) + "\" -o \"" + rmx::convertToUTF8(tempLibraryFilename) + "\"";
+
+		RMX_LOG_INFO("Nativizing scripts of module '" << module.getModuleName() << "', this can take a while");
+		const int result = system(command.c_str());
+
+		FTX::FileSystem->removeFile(sourceFilename);
+		if (result != 0 || !FTX::FileSystem->exists(tempLibraryFilename))
+		{
+			RMX_LOG_WARNING("Failed to build nativized code for module '" << module.getModuleName() << "', compiler command was: " << command);
+			FTX::FileSystem->removeFile(tempLibraryFilename);
+			return false;
+		}
+
+		// Rename only now, so that an interrupted build never leaves a broken library in the cache
+		return FTX::FileSystem->renameFile(tempLibraryFilename, libraryFilename);
+	}
+#endif
+}
+
+
+bool ModScriptNativization::isSupported()
+{
+#if defined(PLATFORM_LINUX)
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool ModScriptNativization::addNativizedModule(lemon::NativizedOpcodeProvider& provider, const lemon::Module& module, lemon::Program& program, uint32 appVersion)
+{
+#if defined(PLATFORM_LINUX)
+	const Configuration& config = Configuration::instance();
+	if (config.mScriptCacheDir.empty())
+		return false;
+
+	// Nativization is done in any case, as the cache key is based on the generated code
+	//  -> This is fast compared to the compilation, which is needed only if there's no cached library yet
+	const std::wstring cacheDir = config.mScriptCacheDir + L"nativized/";
+	const std::wstring prefix = cacheDir + String(rmx::hexString(rmx::getMurmur2_64(module.getModuleName()), 16, "")).toStdWString() + L"_";
+	const std::wstring codeFilename = prefix + L"code.inc";
+	FTX::FileSystem->createDirectory(cacheDir);
+	program.runNativization(module, codeFilename, EmulatorInterface::instance());
+
+	std::vector<uint8> nativizedCode;
+	const bool readSuccess = FTX::FileSystem->readFile(codeFilename, nativizedCode);
+	FTX::FileSystem->removeFile(codeFilename);
+	if (!readSuccess)
+		return false;
+
+	const uint64 cacheKey = buildCacheKey(nativizedCode, appVersion);
+	void* handle = nullptr;
+
+	const auto it = loadedLibraries.find(cacheKey);
+	if (it != loadedLibraries.end())
+	{
+		handle = it->second;
+	}
+	else
+	{
+		// The file name consists of a prefix identifying the module, and the cache key
+		const std::wstring basePath = prefix + String(rmx::hexString(cacheKey, 16, "")).toStdWString();
+		const std::wstring libraryFilename = basePath + L".so";
+
+		if (!FTX::FileSystem->exists(libraryFilename))
+		{
+			// Remove outdated libraries for the same module
+			std::vector<rmx::FileIO::FileEntry> fileEntries;
+			FTX::FileSystem->listFilesByMask(prefix + L"*.so", false, fileEntries);
+			for (const rmx::FileIO::FileEntry& fileEntry : fileEntries)
+			{
+				FTX::FileSystem->removeFile(fileEntry.mPath + fileEntry.mFilename);
+			}
+
+			if (!buildSharedLibrary(module, nativizedCode, basePath, libraryFilename))
+				return false;
+		}
+
+		handle = dlopen(rmx::convertToUTF8(libraryFilename).c_str(), RTLD_NOW | RTLD_LOCAL);
+		if (nullptr == handle)
+		{
+			RMX_LOG_WARNING("Failed to load nativized code for module '" << module.getModuleName() << "': " << dlerror());
+			FTX::FileSystem->removeFile(libraryFilename);
+			return false;
+		}
+		loadedLibraries[cacheKey] = handle;
+	}
+
+	const lemon::NativizedOpcodeProvider::BuildFunction buildFunction = reinterpret_cast<lemon::NativizedOpcodeProvider::BuildFunction>(dlsym(handle, LOOKUP_FUNCTION_NAME));
+	if (nullptr == buildFunction)
+		return false;
+
+	provider.addLookup(buildFunction);
+	RMX_LOG_INFO("Using nativized code for module '" << module.getModuleName() << "'");
+	return true;
+#else
+	return false;
+#endif
+}
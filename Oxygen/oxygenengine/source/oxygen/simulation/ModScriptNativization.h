@@ -0,0 +1,32 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+#include <rmxbase.h>
+
+namespace lemon
+{
+	class Module;
+	class NativizedOpcodeProvider;
+	class Program;
+}
+
+
+// Load-time nativization of mod script modules
+//  -> Nativized code for a module gets compiled with the locally installed C++ compiler into a shared library, which is cached by a hash of the generated code
+//  -> Only supported on Linux, and needs the lemonscript and rmxbase headers that the application was built with
+//  -> Installations ship these in "nativization/include" next to the executable, see the include paths in Configuration
+class ModScriptNativization
+{
+public:
+	static bool isSupported();
+
+	// Adds the nativized code for the given module to the provider, building the shared library first if there's no cached one yet
+	static bool addNativizedModule(lemon::NativizedOpcodeProvider& provider, const lemon::Module& module, lemon::Program& program, uint32 appVersion);
+};
@@ -97,8 +97,19 @@ bool Simulation::startup()
 
 	if (mGameRecorder.isPlaying())
 	{
-		// Try the long and short name
-		if (mGameRecorder.loadRecording(L"gamerecording.bin"))
+		// Try the explicitly set file name, or otherwise the long and short name
+		if (!config.mGameRecorder.mPlaybackFilename.empty())
+		{
+			if (mGameRecorder.loadRecording(config.mGameRecorder.mPlaybackFilename))
+			{
+				RMX_LOG_INFO("Playback of '" << WString(config.mGameRecorder.mPlaybackFilename).toStdString() << "'");
+			}
+			else
+			{
+				RMX_LOG_ERROR("Failed to load game recording '" << WString(config.mGameRecorder.mPlaybackFilename).toStdString() << "'");
+			}
+		}
+		else if (mGameRecorder.loadRecording(L"gamerecording.bin"))
 		{
 			RMX_LOG_INFO("Playback of 'gamerecording.bin'");
 		}
@@ -242,6 +253,28 @@ void Simulation::saveState(const std::wstring& filename)
 	mStateLoaded = filename;
 }
 
+void Simulation::saveStateToMemory(std::vector<uint8>& outData)
+{
+	SaveStateSerializer serializer(*this, RenderParts::instance());
+	serializer.saveState(outData);
+}
+
+bool Simulation::restoreFrameState(uint32 frameNumber, const std::vector<uint8>& data, const uint16* previousInputs)
+{
+	SaveStateSerializer serializer(*this, RenderParts::instance());
+	if (!serializer.loadState(data))
+		return false;
+
+	ControlsIn::instance().injectInputs(previousInputs);
+	mCodeExec.reinitRuntime(nullptr, CodeExec::CallStackInitPolicy::USE_EXISTING);
+	mFrameNumber = frameNumber;
+
+	// Recorded inputs after this frame are outdated, and would override the ones used now
+	if (mGameRecorder.isRecording())
+		mGameRecorder.discardFramesAfter(frameNumber);
+	return true;
+}
+
 bool Simulation::triggerFullScriptsReload()
 {
 	if (mCodeExec.reloadScripts(true, true))
@@ -273,6 +306,9 @@ void Simulation::update(float timeElapsed)
 		mRewindSteps = -1;
 	}
 
+	// Correct mispredicted netplay inputs first
+	NetplayManager::instance().performRollback(*this);
+
 	// Limit length of one frame to 100ms
 	timeElapsed = clamp(timeElapsed, 0.0f, 0.1f);
 
@@ -498,6 +534,9 @@ bool Simulation::generateFrame()
 
 		if (mStepsLimit > 0)
 			--mStepsLimit;
+
+		// Netplay rollback needs the state at the beginning of each frame
+		NetplayManager::instance().onFrameCompleted(*this);
 	}
 
 	// Return false if frame got interrupted
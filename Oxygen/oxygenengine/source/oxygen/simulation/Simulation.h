@@ -52,6 +52,10 @@ public:
 	bool loadState(const std::wstring& filename, bool showError = true);
 	void saveState(const std::wstring& filename);
 
+	// Used by netplay rollback: Restoring puts the simulation at the beginning of the given frame, using the given controller state as previous input
+	void saveStateToMemory(std::vector<uint8>& outData);
+	bool restoreFrameState(uint32 frameNumber, const std::vector<uint8>& data, const uint16* previousInputs);
+
 	bool triggerFullScriptsReload();
 
 	inline uint32 getFrameNumber() const  { return mFrameNumber; }
@@ -17,6 +17,14 @@
 
 namespace
 {
+	lemon::StringRef makeRuntimeString(std::string_view str)
+	{
+		// Strings returned to scripts must be registered in the runtime, otherwise they can't be resolved there
+		lemon::Runtime* runtime = lemon::Runtime::getActiveRuntime();
+		RMX_CHECK(nullptr != runtime, "No lemon script runtime active", return lemon::StringRef());
+		return runtime->addStringRef(str);
+	}
+
 	uint8 Audio_getAudioKeyType(uint64 audioKey)
 	{
 		return (uint8)EngineMain::instance().getAudioOut().getAudioKeyType(audioKey);
@@ -24,7 +32,7 @@ namespace
 
 	lemon::StringRef Audio_getAudioKeyDisplayName(uint64 audioKey)
 	{
-		return lemon::StringRef(EngineMain::instance().getAudioOut().getAudioKeyDisplayName(audioKey));
+		return makeRuntimeString(EngineMain::instance().getAudioOut().getAudioKeyDisplayName(audioKey));
 	}
 
 	bool Audio_isPlayingAudio(uint64 audioKey)
@@ -215,7 +223,7 @@ namespace
 	{
 		AudioPlayer& audioPlayer = AudioPlayer::instance();
 		AudioPlayer::PlayingSoundRef ref = audioPlayer.getPlayingSoundByUniqueId(audioInstance.mUniqueId);
-		return lemon::StringRef(audioPlayer.getPlayingSoundAudioKey(ref));
+		return makeRuntimeString(audioPlayer.getPlayingSoundAudioKey(ref));
 	}
 
 	void AudioInstance_pause(AudioInstanceWrapper audioInstance)
@@ -410,7 +410,8 @@ namespace
 		CodeExec* codeExec = CodeExec::getActiveInstance();
 		RMX_CHECK(nullptr != codeExec, "No running CodeExec instance", return lemon::StringRef());
 		const lemon::AnyBaseValue value = codeExec->getLemonScriptRuntime().getGlobalVariableValue(variableName, &lemon::PredefinedDataTypes::STRING);
-		return lemon::StringRef(value.get<uint64>());
+		const lemon::FlyweightString* str = codeExec->getLemonScriptRuntime().getInternalLemonRuntime().resolveStringByKey(value.get<uint64>());
+		return (nullptr != str) ? lemon::StringRef(*str) : lemon::StringRef();
 	}
 
 	void System_setGlobalVariableValueByNameInt(lemon::StringRef variableName, int64 value)
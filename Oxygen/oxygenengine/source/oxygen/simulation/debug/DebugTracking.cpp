@@ -212,7 +212,7 @@ void DebugTracking::clearWatches(bool clearPersistent)
 	for (Watch* watch : mWatches)
 		deleteWatch(*watch);
 	mWatches.clear();
-	mEmulatorInterface.getWatches().clear();
+	mEmulatorInterface.clearWatches();
 
 	for (const SavedWatchData& saved : reAddWatches)
 	{
@@ -229,9 +229,7 @@ void DebugTracking::addWatch(uint32 address, uint16 bytes, bool persistent, std:
 		return;
 
 	// Add a new watch in EmulatorInterface
-	EmulatorInterface::Watch& internalWatch = vectorAdd(mEmulatorInterface.getWatches());
-	internalWatch.mAddress = address;
-	internalWatch.mBytes = bytes;
+	mEmulatorInterface.addWatch(address, bytes);
 
 	// Add a new watch here
 	Watch& watch = mWatchPool.rentObject();
@@ -259,7 +257,7 @@ void DebugTracking::removeWatch(uint32 address, uint16 bytes)
 	mWatches.erase(mWatches.begin() + index);
 
 	// Remove it in EmulatorInterface
-	mEmulatorInterface.getWatches().erase(mEmulatorInterface.getWatches().begin() + index);
+	mEmulatorInterface.removeWatch((size_t)index);
 }
 
 void DebugTracking::getCallStackFromCallFrameIndex(std::vector<Location>& outCallStack, int callFrameIndex, std::optional<size_t> firstProgramCounter)
@@ -142,6 +142,8 @@
 #include "oxygen/pch.h"
 #include "oxygen/simulation/sound/ym2612.h"
 
+#include <mutex>
+
 
 namespace soundemulation
 {
@@ -1771,7 +1773,10 @@ namespace soundemulation
 	void YM2612::init()
 	{
 		memset(this, 0, sizeof(YM2612));
-		init_tables();
+
+		// The tables are shared by all instances, which may be running on other threads already
+		static std::once_flag tablesInitialized;
+		std::call_once(tablesInitialized, [this] { init_tables(); });
 	}
 
 	/* reset OPN registers */
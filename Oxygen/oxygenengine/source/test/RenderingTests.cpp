@@ -0,0 +1,234 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+// Tests for the software renderer and resource handling, running without window or audio device
+//  -> Needs to be run from a directory containing the "data" folder with fonts and sprites, e.g. "Oxygen/sonic3air"
+//  -> Best run in a build with address sanitizer, as some of the issues covered would not crash reliably otherwise
+
+#include "oxygen/pch.h"
+#include "oxygen/application/ArgumentsReader.h"
+#include "oxygen/application/Configuration.h"
+#include "oxygen/application/EngineMain.h"
+#include "oxygen/application/video/VideoOut.h"
+#include "oxygen/drawing/software/SoftwareDrawer.h"
+#include "oxygen/rendering/RenderResources.h"
+#include "oxygen/rendering/parts/RenderParts.h"
+#include "oxygen/rendering/parts/palette/PaletteManager.h"
+#include "oxygen/resources/FontCollection.h"
+#include "oxygen/simulation/EmulatorInterface.h"
+
+
+namespace
+{
+	class TestConfiguration : public Configuration
+	{
+	protected:
+		void preLoadInitialization() override {}
+		bool loadConfigurationInternal(JsonSerializer& rootSerializer) override  { return true; }
+		bool loadSettingsInternal(JsonSerializer& rootSerializer, SettingsType settingsType) override  { return true; }
+		void saveSettingsInternal(JsonSerializer& rootSerializer, SettingsType settingsType) override {}
+	};
+
+	class TestDelegate : public EngineDelegateInterface
+	{
+	public:
+		const AppMetaData& getAppMetaData() override  { return mAppMetaData; }
+		GuiBase& createGameApp() override  { RMX_ERROR("Not supported in tests", RMX_REACT_THROW); return *(GuiBase*)nullptr; }
+		AudioOutBase& createAudioOut() override  { RMX_ERROR("Not supported in tests", RMX_REACT_THROW); return *(AudioOutBase*)nullptr; }
+
+		bool onEnginePreStartup() override  { return true; }
+		bool setupCustomGameProfile() override  { return false; }
+
+		void startupGame(EmulatorInterface& emulatorInterface) override {}
+		void shutdownGame() override {}
+		void updateGame(float timeElapsed) override {}
+
+		void registerScriptBindings(lemon::Module& module) override {}
+		void registerNativizedCode(lemon::Program& program) override {}
+
+		void onRuntimeInit(CodeExec& codeExec) override {}
+		void onPreFrameUpdate() override {}
+		void onPostFrameUpdate() override {}
+		void onControlsUpdate() override {}
+		void onPreSaveStateLoad() override {}
+
+		bool mayLoadScriptMods() override  { return false; }
+		bool allowModdedData() override  { return false; }
+		bool useDeveloperFeatures() override  { return true; }
+		void onActiveModsChanged() override {}
+
+		void onStartNetplayGame(bool isHost) override {}
+		void onStopNetplayGame(bool isHost) override {}
+		void serializeGameSettings(VectorBinarySerializer& serializer) override {}
+
+		void onGameRecordingHeaderLoaded(const std::string& buildString, const std::vector<uint8>& buffer) override {}
+		void onGameRecordingHeaderSave(std::vector<uint8>& buffer) override {}
+
+		void fillDebugVisualization(Bitmap& bitmap, int& mode) override {}
+
+	private:
+		AppMetaData mAppMetaData;
+	};
+
+	// Sets up the parts of the engine needed for rendering, without running the engine startup
+	struct TestEnvironment
+	{
+		TestConfiguration mConfiguration;
+		EmulatorInterface mEmulatorInterface;
+		TestDelegate mDelegate;
+		ArgumentsReader mArguments = ArgumentsReader("");
+		EngineMain mEngineMain = EngineMain(mDelegate, mArguments);
+
+		explicit TestEnvironment(bool pipelinedRendering)
+		{
+			mConfiguration.mPipelinedRendering = pipelinedRendering;
+			mConfiguration.mRenderMethod = Configuration::RenderMethod::SOFTWARE;
+			mConfiguration.mGameScreen.set(400, 224);
+			mEngineMain.getDrawer().createDrawer<SoftwareDrawer>();
+			VideoOut::instance().startup();
+		}
+
+		~TestEnvironment()
+		{
+			VideoOut::instance().shutdown();
+		}
+	};
+
+
+	bool testReloadWhileRendering()
+	{
+		// Reloading sprites and fonts must not free anything the render thread is still using for the frame in flight
+		TestEnvironment environment(true);
+		VideoOut& videoOut = VideoOut::instance();
+		FontCollection& fontCollection = FontCollection::instance();
+		RenderResources& renderResources = RenderResources::instance();
+		fontCollection.reloadAll();
+		renderResources.loadSprites();
+
+		std::vector<uint64> spriteKeys;
+		for (const auto& [key, item] : renderResources.mSpriteCollection.getAllSprites())
+		{
+			if (nullptr != item.mSprite && !item.mUsesComponentSprite)
+			{
+				spriteKeys.push_back(key);
+				if (spriteKeys.size() >= 64)
+					break;
+			}
+		}
+		if (spriteKeys.empty())
+		{
+			printf("No sprites found, is the working directory set correctly?\n");
+			return false;
+		}
+
+		const std::string_view fontKey = "sonic3_fontB";
+		const uint64 fontKeyHash = rmx::getMurmur2_64(fontKey);
+		for (int frame = 0; frame < 20; ++frame)
+		{
+			videoOut.preFrameUpdate();
+			SpriteManager& spriteManager = videoOut.getRenderParts().getSpriteManager();
+			for (size_t k = 0; k < spriteKeys.size(); ++k)
+			{
+				// Scaled up and rotated, to keep the render thread busy for a while
+				spriteManager.drawCustomSprite(spriteKeys[k], Vec2i((int)(k * 37) % 400, (int)(k * 13) % 224), 0, 0, 0xa000, Color::WHITE, 0.3f, 3.0f);
+			}
+			for (int line = 0; line < 20; ++line)
+			{
+				const std::string text = "RELOAD WHILE RENDERING " + std::to_string(frame * 100 + line);
+				spriteManager.addText(fontKey, fontKeyHash, Vec2i(10, line * 10), text, rmx::getMurmur2_64(text), Color::WHITE, 1, 0, 0xe000, SpriteManager::Space::SCREEN, false);
+			}
+			videoOut.postFrameUpdate();
+			videoOut.updateGameScreen();
+
+			// The render thread is busy with the frame now, so do the same reloads as the F10 hotkey or a change of active mods
+			if (frame % 2 == 0)
+			{
+				renderResources.loadSprites();
+				fontCollection.reloadAll();
+			}
+			else
+			{
+				renderResources.loadSprites(true);
+				fontCollection.collectFromMods();
+				videoOut.handleActiveModsChanged();
+			}
+		}
+		videoOut.waitUntilRenderingIdle();
+		return true;
+	}
+
+	bool testCustomDebugPlane(bool pipelinedRendering)
+	{
+		// Custom planes may use the debug plane (index 3), which the software plane cache has no cached plane for
+		TestEnvironment environment(pipelinedRendering);
+		VideoOut& videoOut = VideoOut::instance();
+		RenderParts& renderParts = videoOut.getRenderParts();
+
+		// Pattern 1 is filled with color 1, all others stay empty
+		memset(environment.mEmulatorInterface.getVRam(), 0, 0x10000);
+		environment.mEmulatorInterface.fillVRam(0x20, 0x1111, 0x20);
+		renderParts.getPaletteManager().writePaletteEntry(0, 1, 0xff0000ff);
+
+		int coloredPixels = 0;
+		for (int frame = 0; frame < 4; ++frame)
+		{
+			videoOut.preFrameUpdate();
+			renderParts.getPlaneManager().setupCustomPlane(Recti(0, 0, 400, 224), PlaneManager::PLANE_DEBUG, 0, 0x1000);
+			videoOut.postFrameUpdate();
+			videoOut.updateGameScreen();
+			videoOut.waitUntilRenderingIdle();
+			if (pipelinedRendering)
+			{
+				// Get the rendered frame presented
+				videoOut.updateGameScreen();
+			}
+
+			const Bitmap& bitmap = videoOut.getGameScreenTexture().accessBitmap();
+			coloredPixels = 0;
+			for (int i = 0; i < bitmap.getPixelCount(); ++i)
+			{
+				if ((bitmap.getData()[i] & 0xffffff) == 0x0000ff)
+					++coloredPixels;
+			}
+		}
+		if (coloredPixels == 0)
+		{
+			printf("Debug plane content did not get rendered\n");
+			return false;
+		}
+		return true;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	INIT_RMX;
+
+	struct Test
+	{
+		const char* mName;
+		bool(*mFunction)();
+	};
+	const Test TESTS[] =
+	{
+		{ "Reload while rendering", &testReloadWhileRendering },
+		{ "Custom plane using the debug plane", []() { return testCustomDebugPlane(false); } },
+		{ "Custom plane using the debug plane, pipelined", []() { return testCustomDebugPlane(true); } }
+	};
+
+	int numFailed = 0;
+	for (const Test& test : TESTS)
+	{
+		const bool success = test.mFunction();
+		printf("%s: %s\n", success ? "Passed" : "FAILED", test.mName);
+		if (!success)
+			++numFailed;
+	}
+	return (numFailed == 0) ? 0 : 1;
+}
@@ -71,6 +71,15 @@ chmod +x $OutputDir/sonic3air_linux
 
 cp source/external/discord_game_sdk/lib/x86_64/libdiscord_game_sdk.so $OutputDir
 
+# Headers needed for load-time nativization of mod scripts, see ModScriptNativization
+mkdir -p $OutputDir/nativization/include
+pushd ../lemonscript/source
+	find lemon \( -name "*.h" -o -name "*.inl" -o -name "*.inc" \) -exec cp --parents {} ../../sonic3air/$OutputDir/nativization/include \;
+popd
+pushd ../../librmx/source
+	find . \( -name "*.h" -o -name "*.inl" -o -name "*.inc" \) -exec cp --parents {} ../../Oxygen/sonic3air/$OutputDir/nativization/include \;
+popd
+
 # Leave out the remastered music, as the Linux build can use an internal downloader
 rm $OutputDir/data/audioremaster.bin
 
@@ -0,0 +1,127 @@
+/*
+*	Part of the Oxygen Engine / Sonic 3 A.I.R. software distribution.
+*	Copyright (C) 2017-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+// Headless benchmark runner for S3AIR
+//  -> Plays back a game recording as fast as possible, without window or audio output
+//  -> Usage: sonic3air_benchmark [-frames=<count>] [-start=<frame>] [-renderthreads=<count>] [-pipelined] [-norender] [-noaudio] <gamerecording.bin>
+
+#include "sonic3air/pch.h"
+#include "sonic3air/EngineDelegate.h"
+#include "sonic3air/GameArgumentsReader.h"
+#include "sonic3air/platform/PlatformSpecifics.h"
+
+#include "oxygen/application/HeadlessRunner.h"
+#include "oxygen/platform/PlatformFunctions.h"
+
+
+namespace
+{
+	class BenchmarkArgumentsReader : public GameArgumentsReader
+	{
+	public:
+		HeadlessRunner::Options mOptions;
+
+	protected:
+		virtual bool readParameter(const std::string& parameter) override
+		{
+			if (rmx::startsWith(parameter, "-frames="))
+			{
+				mOptions.mMaxFrames = (uint32)rmx::parseInteger(parameter.substr(8));
+				return true;
+			}
+			else if (rmx::startsWith(parameter, "-start="))
+			{
+				mOptions.mStartFrame = (uint32)rmx::parseInteger(parameter.substr(7));
+				return true;
+			}
+			else if (rmx::startsWith(parameter, "-renderthreads="))
+			{
+				mOptions.mRenderThreads = (int)rmx::parseInteger(parameter.substr(15));
+				return true;
+			}
+			else if (parameter == "-pipelined")
+			{
+				mOptions.mPipelinedRendering = true;
+				return true;
+			}
+			else if (parameter == "-norender")
+			{
+				mOptions.mRenderFrames = false;
+				return true;
+			}
+			else if (parameter == "-noaudio")
+			{
+				mOptions.mMixAudio = false;
+				return true;
+			}
+			return GameArgumentsReader::readParameter(parameter);
+		}
+	};
+
+	void printRegion(const char* name, double seconds, const HeadlessRunner::Results& results)
+	{
+		const double msPerFrame = (results.mSimulatedFrames > 0) ? seconds * 1000.0 / (double)results.mSimulatedFrames : 0.0;
+		const double percentage = (results.mTotalSeconds > 0.0) ? seconds * 100.0 / results.mTotalSeconds : 0.0;
+		printf("  %-12s %10.3f s  %8.4f ms/frame  %6.2f %%\n", name, seconds, msPerFrame, percentage);
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	EngineMain::earlySetup();
+	PlatformSpecifics::platformStartup();
+
+	BenchmarkArgumentsReader arguments;
+	arguments.read(argc, argv);
+
+	// The non-parameter argument is read as project path, but here it's the game recording to play back
+	HeadlessRunner::Options options = arguments.mOptions;
+	options.mRecordingFilename = arguments.mProjectPath;
+	if (!options.mRecordingFilename.empty() && options.mRecordingFilename.back() == L'/')
+		options.mRecordingFilename.pop_back();
+	arguments.mProjectPath.clear();
+
+	if (options.mRecordingFilename.empty())
+	{
+		printf("Usage: %s [-frames=<count>] [-start=<frame>] [-renderthreads=<count>] [-pipelined] [-norender] [-noaudio] <gamerecording.bin>\n", (argc > 0) ? argv[0] : "sonic3air_benchmark");
+		return 1;
+	}
+
+	// Make recording path absolute before changing the working directory
+	const bool isAbsolutePath = (options.mRecordingFilename[0] == L'/' || (options.mRecordingFilename.length() >= 2 && options.mRecordingFilename[1] == L':'));
+	if (!isAbsolutePath)
+	{
+		std::wstring currentDirectory = rmx::FileSystem::getCurrentDirectory();
+		rmx::FileSystem::normalizePath(currentDirectory, true);
+		options.mRecordingFilename = currentDirectory + options.mRecordingFilename;
+	}
+	PlatformFunctions::changeWorkingDirectory(arguments.mExecutableCallPath);
+
+	HeadlessRunner headlessRunner(options);
+	try
+	{
+		EngineDelegate myDelegate;
+		EngineMain myMain(myDelegate, arguments);
+		myMain.executeHeadless(headlessRunner);
+	}
+	catch (const std::exception& e)
+	{
+		printf("Caught unhandled exception: %s\n", e.what());
+		return 2;
+	}
+
+	const HeadlessRunner::Results& results = headlessRunner.getResults();
+	printf("Simulated frames: %u\n", results.mSimulatedFrames);
+	printf("Total time:       %.3f s\n", results.mTotalSeconds);
+	printf("Frames / second:  %.1f\n", results.getFramesPerSecond());
+	printRegion("Simulation", results.mSimulationSeconds, results);
+	printRegion("Audio", results.mAudioSeconds, results);
+	printRegion("Rendering", results.mRenderingSeconds, results);
+	return results.mSuccess ? 0 : 3;
+}
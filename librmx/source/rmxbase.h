@@ -59,6 +59,7 @@
 #include "rmxbase/memory/UTF8Conversion.h"
 #include "rmxbase/tools/Tools.h"
 #include "rmxbase/file/FileHandle.h"
+#include "rmxbase/file/MemoryMappedFile.h"
 #include "rmxbase/file/FileIO.h"
 #include "rmxbase/file/FileProvider.h"
 #include "rmxbase/file/RealFileProvider.h"
@@ -29,10 +29,17 @@ protected:
 		mSingleInstance = static_cast<CLASS*>(this);
 	}
 
+	// Allows for creation of additional instances that don't replace the registered one
+	explicit SingleInstance(bool registerInstance)
+	{
+		if (registerInstance)
+			mSingleInstance = static_cast<CLASS*>(this);
+	}
+
 	virtual ~SingleInstance()
 	{
-		// TODO: Sanity check: (mSingleInstance == this)
-		mSingleInstance = nullptr;
+		if (mSingleInstance == static_cast<CLASS*>(this))
+			mSingleInstance = nullptr;
 	}
 
 private:
@@ -283,12 +283,12 @@ namespace rmx
 
 	bool FileIO::getFileSize(std::wstring_view filename, uint64& outSize)
 	{
-		mLastErrorCode.clear();
-
+		// Read-only queries don't touch mLastErrorCode, as they may get called from multiple threads at once
 	#if defined(USE_STD_FILESYSTEM) && !defined(PLATFORM_MAC)
 		const std_filesystem::path fspath(filename.data());
-		const std::uintmax_t size = std_filesystem::file_size(fspath, mLastErrorCode);
-		if (mLastErrorCode)
+		std::error_code errorCode;
+		const std::uintmax_t size = std_filesystem::file_size(fspath, errorCode);
+		if (errorCode)
 			return false;
 		outSize = (uint64)size;
 		return true;
@@ -303,12 +303,11 @@ namespace rmx
 
 	bool FileIO::getFileTime(std::wstring_view filename, time_t& outTime)
 	{
-		mLastErrorCode.clear();
-
 	#if defined(USE_STD_FILESYSTEM)
 		const std_filesystem::path fspath(filename.data());
-		const std_filesystem::file_time_type time = std_filesystem::last_write_time(fspath, mLastErrorCode);
-		if (mLastErrorCode)
+		std::error_code errorCode;
+		const std_filesystem::file_time_type time = std_filesystem::last_write_time(fspath, errorCode);
+		if (errorCode)
 			return false;
 
 		// This is the C++17 solution for converting the time -- see https://stackoverflow.com/questions/61030383/how-to-convert-stdfilesystemfile-time-type-to-time-t
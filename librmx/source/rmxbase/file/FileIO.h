@@ -25,7 +25,7 @@ namespace rmx
 			size_t mSize = 0;
 		};
 
-		static inline std::error_code mLastErrorCode;
+		static inline std::error_code mLastErrorCode;	// Only set by modifying operations (rename, remove), not by read-only queries
 
 	public:
 		static bool exists(std::wstring_view path);
@@ -14,6 +14,14 @@ namespace rmx
 	class FileSystem;
 
 
+	// Read-only view into file content owned by a file provider
+	struct FileView
+	{
+		const uint8* mData = nullptr;
+		size_t mSize = 0;
+	};
+
+
 	class API_EXPORT FileProvider
 	{
 	friend class FileSystem;
@@ -28,6 +36,7 @@ namespace rmx
 		virtual bool getFileSize(const std::wstring& filename, uint64& outFileSize)  { return false; }
 		virtual bool getFileTime(const std::wstring& filename, time_t& outFileTime)  { return false; }
 		virtual bool readFile(const std::wstring& filename, std::vector<uint8>& outData)  { return false; }
+		virtual bool getFileView(const std::wstring& filename, FileView& outFileView)  { return false; }	// Only for providers that have the content in memory anyways; the view stays valid as long as the provider exists
 
 		virtual bool renameFile(const std::wstring& oldFilename, const std::wstring& newFilename)  { return false; }
 		virtual bool renameDirectory(const std::wstring& oldPath, const std::wstring& newPath)  { return false; }
@@ -37,6 +46,9 @@ namespace rmx
 		virtual bool listDirectories(const std::wstring& path, std::vector<std::wstring>& outDirectories)  { return false; }
 		virtual InputStream* createInputStream(const std::wstring& filename)  { return nullptr; }
 
+		// Only for providers with a fixed set of files and directories, which can then be part of the file system's path index; directory paths end with a slash
+		virtual bool listAllPaths(std::vector<std::wstring>& outPaths)  { return false; }
+
 	protected:
 		std::set<FileSystem*> mRegisteredMountPointFileSystems;		// Usually just one
 	};
@@ -24,8 +24,99 @@
 
 namespace rmx
 {
+	namespace
+	{
+		uint64 getLowercasePathHash(std::wstring_view path)
+		{
+			// FNV-1a hash of the lowercase path, as file providers with a file structure tree do case-insensitive lookups
+			//  -> Leading and repeated slashes get ignored, just like in the file structure tree
+			uint64 hash = 0xcbf29ce484222325ull;
+			wchar_t lastCharacter = L'/';
+			for (wchar_t character : path)
+			{
+				if (character == L'\\')
+					character = L'/';
+				else if (character >= L'A' && character <= L'Z')
+					character += 32;
+
+				if (character == L'/' && lastCharacter == L'/')
+					continue;
+
+				hash = (hash ^ (uint64)character) * 0x100000001b3ull;
+				lastCharacter = character;
+			}
+			return hash;
+		}
+
+		inline uint64 getMountPointBit(size_t mountPointIndex)
+		{
+			// All mount points from index 63 on share the last bit
+			return (uint64)1 << std::min<size_t>(mountPointIndex, 63);
+		}
+	}
+
+
+	uint64 FileSystem::MountTable::getPathIndexMask(std::wstring_view path) const
+	{
+		std::call_once(mPathIndexBuilt, [this]() { buildPathIndex(); });
+		const auto it = mPathIndex.find(getLowercasePathHash(path));
+		return (it == mPathIndex.end()) ? 0 : it->second;
+	}
+
+	bool FileSystem::MountTable::mayContainPath(size_t mountPointIndex, uint64 pathIndexMask) const
+	{
+		// Mount points without index always have to be asked, the indexed ones only if the path index says so
+		return !mIndexedMountPoints[mountPointIndex] || (pathIndexMask & getMountPointBit(mountPointIndex)) != 0;
+	}
+
+	void FileSystem::MountTable::buildPathIndex() const
+	{
+		mIndexedMountPoints.resize(mMountPoints.size(), false);
+
+		std::vector<std::wstring> paths;
+		for (size_t k = 0; k < mMountPoints.size(); ++k)
+		{
+			const MountPoint& mountPoint = mMountPoints[k];
+			paths.clear();
+			if (!mountPoint.mFileProvider->listAllPaths(paths))
+				continue;
+
+			mIndexedMountPoints[k] = true;
+			const uint64 mountPointBit = getMountPointBit(k);
+
+			// The mount point itself acts as a directory as well
+			addToPathIndex(mountPoint.mMountPoint, mountPointBit);
+
+			const size_t prefixLength = mountPoint.mPrefixReplacement.length();
+			const uint64 prefixHash = getLowercasePathHash(mountPoint.mPrefixReplacement);
+			for (std::wstring& path : paths)
+			{
+				if (mountPoint.mNeedsPrefixConversion)
+				{
+					// Convert the provider's local path into a path as seen from outside, comparing the prefix case-insensitively like the file providers do
+					if (path.length() < prefixLength || getLowercasePathHash(std::wstring_view(path).substr(0, prefixLength)) != prefixHash)
+						continue;
+					path = mountPoint.mMountPoint + path.substr(prefixLength);
+				}
+				addToPathIndex(path, mountPointBit);
+			}
+		}
+	}
+
+	void FileSystem::MountTable::addToPathIndex(std::wstring_view path, uint64 mountPointBit) const
+	{
+		mPathIndex[getLowercasePathHash(path)] |= mountPointBit;
+
+		// Directories can be queried with or without a slash at the end
+		if (!path.empty() && path.back() == L'/')
+		{
+			mPathIndex[getLowercasePathHash(path.substr(0, path.length() - 1))] |= mountPointBit;
+		}
+	}
+
 
-	FileSystem::FileSystem()
+	FileSystem::FileSystem() :
+		mMountTable(std::make_shared<MountTable>())
 	{
 		// By default, add a real file provider with mounted at root
 	#if !defined(PLATFORM_VITA)
@@ -38,13 +129,13 @@ namespace rmx
 	FileSystem::~FileSystem()
 	{
 		// Unregister from the file providers
-		for (size_t k = 0; k < mMountPoints.size(); ++k)
+		for (const MountPoint& mountPoint : mMountTable->mMountPoints)
 		{
-			mMountPoints[k].mFileProvider->mRegisteredMountPointFileSystems.erase(this);
+			mountPoint.mFileProvider->mRegisteredMountPointFileSystems.erase(this);
 		}
 
 		// Clear the mount points before destroying the managed file provider, so that the calls to "addManagedFileProvider" made by the file provider descructors won't need to do anything
-		mMountPoints.clear();
+		mMountTable = std::make_shared<MountTable>();
 
 		// Destroy the managed file provider
 		for (FileProvider* fileProvider : mManagedFileProviders)
@@ -56,132 +147,92 @@ namespace rmx
 
 	bool FileSystem::exists(std::wstring_view path)
 	{
-		mTempPath2 = normalizePath(path, mTempPath2, FileIO::isDirectoryPath(path));
-		for (MountPoint& mountPoint : mMountPoints)
-		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
-			if (nullptr != localPath)
-			{
-				if (mountPoint.mFileProvider->exists(*localPath))
-					return true;
-			}
-		}
-		return false;
+		return findInMountPoints(path, FileIO::isDirectoryPath(path), [](FileProvider& fileProvider, const std::wstring& localPath) { return fileProvider.exists(localPath); });
 	}
 
 	bool FileSystem::isFile(std::wstring_view path)
 	{
-		mTempPath2 = normalizePath(path, mTempPath2, FileIO::isDirectoryPath(path));
-		for (MountPoint& mountPoint : mMountPoints)
-		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
-			if (nullptr != localPath)
-			{
-				if (mountPoint.mFileProvider->isFile(*localPath))
-					return true;
-			}
-		}
-		return false;
+		return findInMountPoints(path, FileIO::isDirectoryPath(path), [](FileProvider& fileProvider, const std::wstring& localPath) { return fileProvider.isFile(localPath); });
 	}
 
 	bool FileSystem::isDirectory(std::wstring_view path)
 	{
-		mTempPath2 = normalizePath(path, mTempPath2, FileIO::isDirectoryPath(path));
-		for (MountPoint& mountPoint : mMountPoints)
-		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
-			if (nullptr != localPath)
-			{
-				if (mountPoint.mFileProvider->isDirectory(*localPath))
-					return true;
-			}
-		}
-		return false;
+		return findInMountPoints(path, FileIO::isDirectoryPath(path), [](FileProvider& fileProvider, const std::wstring& localPath) { return fileProvider.isDirectory(localPath); });
 	}
 
 	uint64 FileSystem::getFileSize(std::wstring_view filename)
 	{
-		mTempPath2 = normalizePath(filename, mTempPath2, false);
-		for (MountPoint& mountPoint : mMountPoints)
-		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
-			if (nullptr != localPath)
-			{
-				uint64 fileSize = 0;
-				if (mountPoint.mFileProvider->getFileSize(*localPath, fileSize))
-					return fileSize;
-			}
-		}
-		return 0;
+		uint64 fileSize = 0;
+		findInMountPoints(filename, false, [&](FileProvider& fileProvider, const std::wstring& localPath) { return fileProvider.getFileSize(localPath, fileSize); });
+		return fileSize;
 	}
 
 	time_t FileSystem::getFileTime(std::wstring_view filename)
 	{
 		time_t time = 0;
-		mTempPath2 = normalizePath(filename, mTempPath2, false);
-		for (MountPoint& mountPoint : mMountPoints)
-		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
-			if (nullptr != localPath)
-			{
-				if (mountPoint.mFileProvider->getFileTime(*localPath, time))
-					return time;
-			}
-		}
+		findInMountPoints(filename, false, [&](FileProvider& fileProvider, const std::wstring& localPath) { return fileProvider.getFileTime(localPath, time); });
 		return time;
 	}
 
 	bool FileSystem::readFile(std::wstring_view filename, std::vector<uint8>& outData)
 	{
-		mTempPath2 = normalizePath(filename, mTempPath2, false);
-		for (MountPoint& mountPoint : mMountPoints)
+		return findInMountPoints(filename, false, [&](FileProvider& fileProvider, const std::wstring& localPath) { return fileProvider.readFile(localPath, outData); });
+	}
+
+	bool FileSystem::readFileView(std::wstring_view filename, FileView& outFileView, std::vector<uint8>& outFallbackData)
+	{
+		return findInMountPoints(filename, false, [&](FileProvider& fileProvider, const std::wstring& localPath)
 		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
-			if (nullptr != localPath)
+			if (fileProvider.getFileView(localPath, outFileView))
+				return true;
+
+			// Still respect the mount point priorities if the provider can't provide a view
+			if (fileProvider.readFile(localPath, outFallbackData))
 			{
-				if (mountPoint.mFileProvider->readFile(*localPath, outData))
-					return true;
+				outFileView.mData = outFallbackData.data();
+				outFileView.mSize = outFallbackData.size();
+				return true;
 			}
-		}
-		return false;
+			return false;
+		});
 	}
 
 	bool FileSystem::saveFile(std::wstring_view filename, const void* data, size_t size)
 	{
 		// TODO: Use file providers here as well
-		mTempPath2 = normalizePath(filename, mTempPath2, false);
-		return FileIO::saveFile(mTempPath2, data, size);
+		std::wstring normalizedPath;
+		normalizedPath = normalizePath(filename, normalizedPath, false);
+		return FileIO::saveFile(normalizedPath, data, size);
 	}
 
 	InputStream* FileSystem::createInputStream(std::wstring_view filename)
 	{
-		mTempPath2 = normalizePath(filename, mTempPath2, false);
-		for (MountPoint& mountPoint : mMountPoints)
+		InputStream* stream = nullptr;
+		findInMountPoints(filename, false, [&](FileProvider& fileProvider, const std::wstring& localPath)
 		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
-			if (nullptr != localPath)
-			{
-				InputStream* stream = mountPoint.mFileProvider->createInputStream(*localPath);
-				if (nullptr != stream)
-					return stream;
-			}
-		}
-		return nullptr;
+			stream = fileProvider.createInputStream(localPath);
+			return (nullptr != stream);
+		});
+		return stream;
 	}
 
 	bool FileSystem::createDirectory(std::wstring_view path)
 	{
 		// TODO: Use file providers here as well
-		mTempPath2 = normalizePath(path, mTempPath2, true);
-		return FileIO::createDirectory(mTempPath2);
+		std::wstring normalizedPath;
+		normalizedPath = normalizePath(path, normalizedPath, true);
+		return FileIO::createDirectory(normalizedPath);
 	}
 
 	void FileSystem::listFiles(std::wstring_view path, bool recursive, std::vector<rmx::FileIO::FileEntry>& outEntries)
 	{
-		mTempPath2 = normalizePath(path, mTempPath2, false);
-		for (MountPoint& mountPoint : mMountPoints)
+		std::wstring normalizedPath;
+		normalizedPath = normalizePath(path, normalizedPath, false);
+		std::wstring tempPath;
+		const std::shared_ptr<const MountTable> mountTable = getMountTable();
+		for (const MountPoint& mountPoint : mountTable->mMountPoints)
 		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
+			const std::wstring* localPath = applyMountPoint(mountPoint, normalizedPath, tempPath);
 			if (nullptr != localPath)
 			{
 				mountPoint.mFileProvider->listFiles(*localPath, recursive, outEntries);
@@ -199,10 +250,13 @@ namespace rmx
 
 	void FileSystem::listFilesByMask(std::wstring_view filemask, bool recursive, std::vector<rmx::FileIO::FileEntry>& outEntries)
 	{
-		mTempPath2 = normalizePath(filemask, mTempPath2, false);
-		for (MountPoint& mountPoint : mMountPoints)
+		std::wstring normalizedPath;
+		normalizedPath = normalizePath(filemask, normalizedPath, false);
+		std::wstring tempPath;
+		const std::shared_ptr<const MountTable> mountTable = getMountTable();
+		for (const MountPoint& mountPoint : mountTable->mMountPoints)
 		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
+			const std::wstring* localPath = applyMountPoint(mountPoint, normalizedPath, tempPath);
 			if (nullptr != localPath)
 			{
 				mountPoint.mFileProvider->listFilesByMask(*localPath, recursive, outEntries);
@@ -220,10 +274,13 @@ namespace rmx
 
 	void FileSystem::listDirectories(std::wstring_view path, std::vector<std::wstring>& outEntries)
 	{
-		mTempPath2 = normalizePath(path, mTempPath2, true);
-		for (MountPoint& mountPoint : mMountPoints)
+		std::wstring normalizedPath;
+		normalizedPath = normalizePath(path, normalizedPath, true);
+		std::wstring tempPath;
+		const std::shared_ptr<const MountTable> mountTable = getMountTable();
+		for (const MountPoint& mountPoint : mountTable->mMountPoints)
 		{
-			const std::wstring* localPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
+			const std::wstring* localPath = applyMountPoint(mountPoint, normalizedPath, tempPath);
 			if (nullptr != localPath)
 			{
 				mountPoint.mFileProvider->listDirectories(*localPath, outEntries);
@@ -232,9 +289,9 @@ namespace rmx
 			{
 				// Handle the special case that the mount point includes the given path
 				//  -> In this case, we want the mount point itself to act as a virtual directory
-				if (!mTempPath2.empty() && startsWith(mountPoint.mMountPoint, mTempPath2))
+				if (!normalizedPath.empty() && startsWith(mountPoint.mMountPoint, normalizedPath))
 				{
-					const size_t startPos = mTempPath2.size();
+					const size_t startPos = normalizedPath.size();
 					size_t endPos = startPos;
 					while (endPos < mountPoint.mMountPoint.size() && mountPoint.mMountPoint[endPos] != '/')
 					{
@@ -258,12 +315,15 @@ namespace rmx
 
 	bool FileSystem::renameFile(std::wstring_view oldFilename, std::wstring_view newFilename)
 	{
-		mTempPath2 = normalizePath(oldFilename, mTempPath2, false);
+		std::wstring oldNormalizedPath;
+		oldNormalizedPath = normalizePath(oldFilename, oldNormalizedPath, false);
 		std::wstring newTempPath(newFilename);
 		normalizePath(newTempPath, false);
-		for (MountPoint& mountPoint : mMountPoints)
+		std::wstring tempPath;
+		const std::shared_ptr<const MountTable> mountTable = getMountTable();
+		for (const MountPoint& mountPoint : mountTable->mMountPoints)
 		{
-			const std::wstring* oldLocalPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
+			const std::wstring* oldLocalPath = applyMountPoint(mountPoint, oldNormalizedPath, tempPath);
 			if (nullptr != oldLocalPath)
 			{
 				std::wstring tempPathForMounting;
@@ -280,12 +340,15 @@ namespace rmx
 
 	bool FileSystem::renameDirectory(std::wstring_view oldPath, std::wstring_view newPath)
 	{
-		mTempPath2 = normalizePath(oldPath, mTempPath2, true);
+		std::wstring oldNormalizedPath;
+		oldNormalizedPath = normalizePath(oldPath, oldNormalizedPath, true);
 		std::wstring newTempPath(newPath);
 		normalizePath(newTempPath, true);
-		for (MountPoint& mountPoint : mMountPoints)
+		std::wstring tempPath;
+		const std::shared_ptr<const MountTable> mountTable = getMountTable();
+		for (const MountPoint& mountPoint : mountTable->mMountPoints)
 		{
-			const std::wstring* oldLocalPath = applyMountPoint(mountPoint, mTempPath2, mTempPath);
+			const std::wstring* oldLocalPath = applyMountPoint(mountPoint, oldNormalizedPath, tempPath);
 			if (nullptr != oldLocalPath)
 			{
 				std::wstring tempPathForMounting;
@@ -365,12 +428,13 @@ namespace rmx
 	void FileSystem::clearMountPoints()
 	{
 		// This also removes the default real file provider -- this way you can get rid of it
-		mMountPoints.clear();
+		setMountPoints(std::vector<MountPoint>());
 	}
 
 	void FileSystem::addMountPoint(FileProvider& fileProvider, std::wstring_view mountPoint, std::wstring_view prefixReplacement, int priority)
 	{
-		MountPoint& newMountPoint = vectorAdd(mMountPoints);
+		std::vector<MountPoint> mountPoints = getMountTable()->mMountPoints;
+		MountPoint& newMountPoint = vectorAdd(mountPoints);
 		newMountPoint.mFileProvider = &fileProvider;
 		newMountPoint.mPriority = priority;
 		if (!mountPoint.empty() || !prefixReplacement.empty())
@@ -381,20 +445,23 @@ namespace rmx
 		}
 
 		fileProvider.mRegisteredMountPointFileSystems.insert(this);
-		std::sort(mMountPoints.begin(), mMountPoints.end(), [](const MountPoint& a, const MountPoint& b) { return a.mPriority > b.mPriority; } );
+		std::sort(mountPoints.begin(), mountPoints.end(), [](const MountPoint& a, const MountPoint& b) { return a.mPriority > b.mPriority; } );
+		setMountPoints(std::move(mountPoints));
 	}
 
 	void FileSystem::removeMountPoints(FileProvider& fileProvider)
 	{
 		// Remove all mount points of this file provider
-		for (size_t k = 0; k < mMountPoints.size(); ++k)
+		std::vector<MountPoint> mountPoints = getMountTable()->mMountPoints;
+		for (size_t k = 0; k < mountPoints.size(); ++k)
 		{
-			if (&fileProvider == mMountPoints[k].mFileProvider)
+			if (&fileProvider == mountPoints[k].mFileProvider)
 			{
-				mMountPoints.erase(mMountPoints.begin() + k);
+				mountPoints.erase(mountPoints.begin() + k);
 				--k;
 			}
 		}
+		setMountPoints(std::move(mountPoints));
 	}
 
 	void FileSystem::normalizePath(std::wstring& path, bool isDirectory)
@@ -432,7 +499,49 @@ namespace rmx
 		removeMountPoints(fileProvider);
 	}
 
-	const std::wstring* FileSystem::applyMountPoint(const MountPoint& mountPoint, const std::wstring& inPath, std::wstring& tempPath) const
+	std::shared_ptr<const FileSystem::MountTable> FileSystem::getMountTable() const
+	{
+		std::shared_lock<std::shared_mutex> lock(mMountTableMutex);
+		return mMountTable;
+	}
+
+	void FileSystem::setMountPoints(std::vector<MountPoint>&& mountPoints)
+	{
+		// Create a new mount table, which also means a new path index
+		std::shared_ptr<MountTable> mountTable = std::make_shared<MountTable>();
+		mountTable->mMountPoints = std::move(mountPoints);
+
+		std::unique_lock<std::shared_mutex> lock(mMountTableMutex);
+		mMountTable = std::move(mountTable);
+	}
+
+	template<typename FUNCTION>
+	bool FileSystem::findInMountPoints(std::wstring_view path, bool isDirectory, FUNCTION&& function) const
+	{
+		std::wstring normalizedPath;
+		normalizedPath = normalizePath(path, normalizedPath, isDirectory);
+		std::wstring tempPath;
+
+		// Go through the mount points in order of priority, but skip the indexed ones that don't have this path anyways
+		const std::shared_ptr<const MountTable> mountTable = getMountTable();
+		const uint64 pathIndexMask = mountTable->getPathIndexMask(normalizedPath);
+		for (size_t k = 0; k < mountTable->mMountPoints.size(); ++k)
+		{
+			if (!mountTable->mayContainPath(k, pathIndexMask))
+				continue;
+
+			const MountPoint& mountPoint = mountTable->mMountPoints[k];
+			const std::wstring* localPath = applyMountPoint(mountPoint, normalizedPath, tempPath);
+			if (nullptr != localPath)
+			{
+				if (function(*mountPoint.mFileProvider, *localPath))
+					return true;
+			}
+		}
+		return false;
+	}
+
+	const std::wstring* FileSystem::applyMountPoint(const MountPoint& mountPoint, const std::wstring& inPath, std::wstring& tempPath)
 	{
 		// Check if path starts with the mount point
 		if (!mountPoint.mMountPoint.empty() && !startsWith(inPath, mountPoint.mMountPoint))
@@ -463,7 +572,7 @@ namespace rmx
 		}
 	}
 
-	void FileSystem::removeMountPointPath(const MountPoint& mountPoint, std::wstring& path) const
+	void FileSystem::removeMountPointPath(const MountPoint& mountPoint, std::wstring& path)
 	{
 		// Check if path starts with the mount point
 		if (!mountPoint.mPrefixReplacement.empty() && !startsWith(path, mountPoint.mPrefixReplacement))
@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
 
 class InputStream;
 
@@ -16,6 +20,9 @@ namespace rmx
 	class FileProvider;
 
 
+	// Virtual file system combining multiple file providers via mount points
+	//  -> All read access (file lookups, reading, listing) is safe to use from multiple threads at the same time
+	//  -> Lookups use a path index over the files and directories of providers with a fixed file list (like file packages), so these don't need to get searched one by one
 	class API_EXPORT FileSystem
 	{
 	friend class FileProvider;
@@ -34,6 +41,7 @@ namespace rmx
 		time_t getFileTime(std::wstring_view filename);
 
 		bool readFile(std::wstring_view filename, std::vector<uint8>& outData);
+		bool readFileView(std::wstring_view filename, FileView& outFileView, std::vector<uint8>& outFallbackData);	// Zero-copy if supported by the file provider, otherwise the content gets read into the fallback data
 		bool saveFile(std::wstring_view filename, const void* data, size_t size);
 		InputStream* createInputStream(std::wstring_view filename);
 
@@ -85,19 +93,43 @@ namespace rmx
 			bool mNeedsPrefixConversion = false;	// Set if mount point and prefix replacement are different
 		};
 
+		// Mount points are never modified in place, but replaced as a whole, so that readers can keep using their snapshot without locking
+		struct MountTable
+		{
+			std::vector<MountPoint> mMountPoints;
+
+			uint64 getPathIndexMask(std::wstring_view path) const;
+			bool mayContainPath(size_t mountPointIndex, uint64 pathIndexMask) const;
+
+		private:
+			void buildPathIndex() const;
+			void addToPathIndex(std::wstring_view path, uint64 mountPointBit) const;
+
+		private:
+			// Path index gets built on first use
+			mutable std::once_flag mPathIndexBuilt;
+			mutable std::unordered_map<uint64, uint64> mPathIndex;		// Maps lowercase path hashes to a bit mask of the indexed mount points containing that path
+			mutable std::vector<bool> mIndexedMountPoints;
+		};
+
 	private:
 		void onFileProviderDestroyed(FileProvider& fileProvider);
 
-		const std::wstring* applyMountPoint(const MountPoint& mountPoint, const std::wstring& inPath, std::wstring& tempPath) const;
-		void removeMountPointPath(const MountPoint& mountPoint, std::wstring& path) const;
+		std::shared_ptr<const MountTable> getMountTable() const;
+		void setMountPoints(std::vector<MountPoint>&& mountPoints);
+
+		template<typename FUNCTION>
+		bool findInMountPoints(std::wstring_view path, bool isDirectory, FUNCTION&& function) const;
+
+		static const std::wstring* applyMountPoint(const MountPoint& mountPoint, const std::wstring& inPath, std::wstring& tempPath);
+		static void removeMountPointPath(const MountPoint& mountPoint, std::wstring& path);
 
 	private:
 		RealFileProvider mDefaultRealFileProvider;
 		std::set<FileProvider*> mManagedFileProviders;	// List of file providers that get deleted automatically with this file system -- though file providers that have mount points here can be managed outside as well, they're not in this list then
-		std::vector<MountPoint> mMountPoints;
 
-		mutable std::wstring mTempPath;		// Only for temporary internal use
-		mutable std::wstring mTempPath2;	// Only for temporary internal use
+		std::shared_ptr<const MountTable> mMountTable;
+		mutable std::shared_mutex mMountTableMutex;		// Only protects the exchange of the mount table pointer
 
 		std::error_code mLastErrorCode;
 	};
@@ -0,0 +1,122 @@
+/*
+*	rmx Library
+*	Copyright (C) 2008-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#include "rmxbase.h"
+
+#if defined(PLATFORM_WINDOWS)
+	#include "CleanWindowsInclude.h"
+#elif defined(PLATFORM_LINUX) || defined(PLATFORM_MAC) || defined(PLATFORM_IOS) || defined(PLATFORM_ANDROID)
+	#define RMX_USE_MMAP
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+bool MemoryMappedFile::isSupported()
+{
+#if defined(PLATFORM_WINDOWS) || defined(RMX_USE_MMAP)
+	return true;
+#else
+	return false;
+#endif
+}
+
+MemoryMappedFile::MemoryMappedFile()
+{
+}
+
+MemoryMappedFile::MemoryMappedFile(std::wstring_view filename)
+{
+	open(filename);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	close();
+}
+
+bool MemoryMappedFile::open(std::wstring_view filename)
+{
+	close();
+
+#if defined(PLATFORM_WINDOWS)
+	const std::wstring filenameString(filename);
+	HANDLE fileHandle = CreateFileW(filenameString.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart <= 0 || (uint64)fileSize.QuadPart > (uint64)SIZE_MAX)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	// The file mapping keeps its own reference to the file, so the file handle is not needed any more afterwards
+	HANDLE fileMappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(fileHandle);
+	if (nullptr == fileMappingHandle)
+		return false;
+
+	void* data = MapViewOfFile(fileMappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (nullptr == data)
+	{
+		CloseHandle(fileMappingHandle);
+		return false;
+	}
+
+	mData = (const uint8*)data;
+	mSize = (size_t)fileSize.QuadPart;
+	mFileMappingHandle = fileMappingHandle;
+	return true;
+
+#elif defined(RMX_USE_MMAP)
+	const int fileDescriptor = ::open(*WString(filename).toUTF8(), O_RDONLY);
+	if (fileDescriptor < 0)
+		return false;
+
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode) || fileStatus.st_size <= 0 || (uint64)fileStatus.st_size > (uint64)SIZE_MAX)
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	// The mapping stays valid after closing the file descriptor
+	void* data = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	::close(fileDescriptor);
+	if (data == MAP_FAILED)
+		return false;
+
+	mData = (const uint8*)data;
+	mSize = (size_t)fileStatus.st_size;
+	return true;
+
+#else
+	return false;
+#endif
+}
+
+void MemoryMappedFile::close()
+{
+	if (nullptr == mData)
+		return;
+
+#if defined(PLATFORM_WINDOWS)
+	UnmapViewOfFile(mData);
+	CloseHandle((HANDLE)mFileMappingHandle);
+	mFileMappingHandle = nullptr;
+#elif defined(RMX_USE_MMAP)
+	munmap((void*)mData, mSize);
+#endif
+
+	mData = nullptr;
+	mSize = 0;
+}
@@ -0,0 +1,38 @@
+/*
+*	rmx Library
+*	Copyright (C) 2008-2026 by Eukaryot
+*
+*	Published under the GNU GPLv3 open source software license, see license.txt
+*	or https://www.gnu.org/licenses/gpl-3.0.en.html
+*/
+
+#pragma once
+
+
+// Read-only view of a whole file mapped into memory
+//  -> Pages get loaded by the OS on first access, and can be dropped again under memory pressure
+//  -> Not available on all platforms, so users always need a fallback for when "open" fails
+class API_EXPORT MemoryMappedFile
+{
+public:
+	static bool isSupported();
+
+public:
+	MemoryMappedFile();
+	MemoryMappedFile(std::wstring_view filename);
+	~MemoryMappedFile();
+
+	bool open(std::wstring_view filename);
+	void close();
+
+	inline bool isOpen() const  { return (nullptr != mData); }
+	inline const uint8* getData() const  { return mData; }
+	inline size_t getSize() const  { return mSize; }
+
+private:
+	const uint8* mData = nullptr;
+	size_t mSize = 0;
+#if defined(PLATFORM_WINDOWS)
+	void* mFileMappingHandle = nullptr;
+#endif
+};
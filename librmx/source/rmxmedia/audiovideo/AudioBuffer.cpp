@@ -8,12 +8,15 @@
 
 #include "rmxmedia.h"
 
+#include <thread>
+
 
 // Static list of loading callbacks
 AudioBuffer::LoadCallbackList AudioBuffer::mStaticLoadCallbacks;
 
 
-AudioBuffer::AudioFrame::AudioFrame(int channels)
+AudioBuffer::AudioFrame::AudioFrame(int channels, int frameIndex) :
+	mFrameIndex(frameIndex)
 {
 	mBuffer = new short[channels * MAX_FRAME_LENGTH];
 	for (int i = 0; i < channels; ++i)
@@ -33,11 +36,12 @@ AudioBuffer::AudioBuffer()
 AudioBuffer::~AudioBuffer()
 {
 	clearInternal();
+	for (std::atomic<FrameBlock*>& block : mFrameBlocks)
+		delete block.load();
 }
 
 void AudioBuffer::clear(int frequency, int channels)
 {
-	RMX_ASSERT(mMutexLockCounter > 0, "Audio buffer mutex should be locked in 'AudioBuffer::clear' method");
 	clearInternal();
 	mFrequency = clamp(frequency, 22050, 48000);
 	mChannels = clamp(channels, 1, 2);
@@ -46,7 +50,6 @@ void AudioBuffer::clear(int frequency, int channels)
 
 void AudioBuffer::addData(short** data, int length, int frequency, int channels)
 {
-	RMX_ASSERT(mMutexLockCounter > 0, "Audio buffer mutex should be locked in 'AudioBuffer::addData' method");
 	if (nullptr == data || length <= 0)
 		return;
 
@@ -56,29 +59,35 @@ void AudioBuffer::addData(short** data, int length, int frequency, int channels)
 	if (frequency <= 0)
 		frequency = mDefaultFrequency;
 */
+	// Only this thread writes the length, so no need to care about the memory order here
+	int64 bufferLength = mLength.load(std::memory_order_relaxed);
 	int offset = 0;
 	while (offset < length)
 	{
 		// Get or create working frame
-		AudioFrame& workingFrame = getWorkingFrame();
+		AudioFrame* workingFrame = getWorkingFrame();
+		if (nullptr == workingFrame)
+			break;
 
 		// Copy data
-		int len = std::min(length - offset, MAX_FRAME_LENGTH - workingFrame.mLength);
+		const int frameLength = (int)(bufferLength % MAX_FRAME_LENGTH);
+		const int len = std::min(length - offset, MAX_FRAME_LENGTH - frameLength);
 		for (int i = 0; i < mChannels; ++i)
 		{
 			short* src = &data[i][offset];
-			short* dst = &workingFrame.mData[i][workingFrame.mLength];
+			short* dst = &workingFrame->mData[i][frameLength];
 			memcpy(dst, src, len * sizeof(short));
 		}
 		offset += len;
-		workingFrame.mLength += len;
-		mLength += len;
+		bufferLength += len;
+
+		// Publish the new samples to the consumer
+		mLength.store(bufferLength, std::memory_order_release);
 	}
 }
 
 void AudioBuffer::addData(float** data, int length, int frequency, int channels)
 {
-	RMX_ASSERT(mMutexLockCounter > 0, "Audio buffer mutex should be locked in 'AudioBuffer::addData' method");
 	if (nullptr == data || length <= 0)
 		return;
 
@@ -88,18 +97,22 @@ void AudioBuffer::addData(float** data, int length, int frequency, int channels)
 	if (frequency <= 0)
 		frequency = mDefaultFrequency;
 */
+	int64 bufferLength = mLength.load(std::memory_order_relaxed);
 	int offset = 0;
 	while (offset < length)
 	{
 		// Get or create working frame
-		AudioFrame& workingFrame = getWorkingFrame();
+		AudioFrame* workingFrame = getWorkingFrame();
+		if (nullptr == workingFrame)
+			break;
 
 		// Copy data
-		const int len = std::min(length - offset, MAX_FRAME_LENGTH - workingFrame.mLength);
+		const int frameLength = (int)(bufferLength % MAX_FRAME_LENGTH);
+		const int len = std::min(length - offset, MAX_FRAME_LENGTH - frameLength);
 		for (int i = 0; i < mChannels; ++i)
 		{
 			const float* src = &data[i][offset];
-			short* dst = &workingFrame.mData[i][workingFrame.mLength];
+			short* dst = &workingFrame->mData[i][frameLength];
 			for (int j = 0; j < len; ++j)
 			{
 				const int value = (int)(src[j] * 0x8000 + 0.5f);
@@ -107,29 +120,28 @@ void AudioBuffer::addData(float** data, int length, int frequency, int channels)
 			}
 		}
 		offset += len;
-		workingFrame.mLength += len;
-		mLength += len;
+		bufferLength += len;
+
+		// Publish the new samples to the consumer
+		mLength.store(bufferLength, std::memory_order_release);
 	}
 }
 
-void AudioBuffer::markPurgeableSamples(int purgePosition)
+void AudioBuffer::markPurgeableSamples(int64 purgePosition)
 {
 	RMX_ASSERT(!mPersistent, "'AudioBuffer::markPurgeableSamples' is meant only for non-persistent audio buffers");
-	RMX_ASSERT(mMutexLockCounter > 0, "Audio buffer mutex should be locked in 'AudioBuffer::markPurgeableSamples' method");
-	int numFramesToPurge = purgePosition / MAX_FRAME_LENGTH;
-	numFramesToPurge = clamp(numFramesToPurge, 0, mPurgedFrames + (int)mFrames.size() - 1);
-	const int difference = numFramesToPurge - mPurgedFrames;
 
-	// To avoid the expensive copying all the time, don't purge any frames unless it's at least 32 frames to be moved
-	if (difference >= 32)
+	// The frame including the purge position and everything after it must stay, as that's still needed for playback
+	//  -> This way, the purged frames never include the working frame the producer is possibly writing to at the same time
+	const int numFramesToPurge = (int)(std::min(purgePosition, getLength()) / MAX_FRAME_LENGTH);
+	const int purgedFrames = mPurgedFrames.load(std::memory_order_relaxed);
+	if (numFramesToPurge > purgedFrames)
 	{
-		const int framesRemaining = (int)mFrames.size() - difference;
-		for (int i = 0; i < difference; ++i)
-			delete mFrames[i];
-		for (int i = 0; i < framesRemaining; ++i)
-			mFrames[i] = mFrames[i + difference];
-		mFrames.resize(framesRemaining);
-		mPurgedFrames = numFramesToPurge;
+		detachFrames(purgedFrames, numFramesToPurge, mFramesToPurge);
+		deleteDetachedFrames(mFramesToPurge);
+
+		// Tell the producer that it may reuse the slots now
+		mPurgedFrames.store(numFramesToPurge, std::memory_order_release);
 	}
 }
 
@@ -148,12 +160,12 @@ bool AudioBuffer::load(const String& source, const String& params)
 
 float AudioBuffer::getLengthInSec() const
 {
-	return (float)mLength / (float)mFrequency;
+	return (float)((double)mLength.load(std::memory_order_relaxed) / (double)mFrequency);
 }
 
 size_t AudioBuffer::getMemoryUsage() const
 {
-	return mFrames.size() * MAX_FRAME_LENGTH * sizeof(short) * mChannels;
+	return (size_t)mNumFrames.load(std::memory_order_relaxed) * MAX_FRAME_LENGTH * sizeof(short) * mChannels;
 }
 
 void AudioBuffer::setPersistent(bool persistent)
@@ -166,64 +178,108 @@ void AudioBuffer::setCompleted(bool completed)
 	mCompleted = completed;
 }
 
-int AudioBuffer::getData(short** output, int position) const
+int AudioBuffer::getData(short** output, int64 position) const
 {
 	// Access audio data
-	RMX_ASSERT(mMutexLockCounter > 0, "Audio buffer mutex should be locked in 'AudioBuffer::getData' method");
+	RMX_ASSERT(mReading.load(std::memory_order_relaxed), "Missing call to 'AudioBuffer::beginReading' before 'AudioBuffer::getData'");
 	output[0] = nullptr;
 	output[1] = nullptr;
-	if (position < 0)
+
+	// Only samples before the published length are complete
+	//  -> Using sequentially consistent ordering here, see "deleteDetachedFrames"
+	const int64 length = mLength.load();
+	if (position < 0 || position >= length)
+		return 0;
+
+	const int frameIndex = (int)(position / MAX_FRAME_LENGTH);
+	const AudioFrame* frame = getFrame(frameIndex);
+	if (nullptr == frame)
 		return 0;
 
-	const int frameIndex = (position / MAX_FRAME_LENGTH) - mPurgedFrames;
-	RMX_ASSERT(frameIndex >= 0 && frameIndex <= (int)mFrames.size(), "Invalid frame index " << frameIndex);  // Equality with frame size is okay and does not trigger the assert, but caught by the if-check
-	if (frameIndex >= 0 && frameIndex < (int)mFrames.size())
+	const int localPosition = (int)(position % MAX_FRAME_LENGTH);
+	const int frameLength = (int)std::min<int64>(length - (int64)frameIndex * MAX_FRAME_LENGTH, MAX_FRAME_LENGTH);
+	output[0] = &frame->mData[0][localPosition];
+	output[1] = &frame->mData[1][localPosition];
+	return frameLength - localPosition;
+}
+
+AudioBuffer::AudioFrame* AudioBuffer::getFrame(int frameIndex) const
+{
+	const FrameBlock* block = mFrameBlocks[getBlockIndex(frameIndex)].load(std::memory_order_acquire);
+	if (nullptr == block)
+		return nullptr;
+
+	// The slot might be used by a later frame already if the requested one got purged
+	AudioFrame* frame = block->mFrames[frameIndex % FRAMES_PER_BLOCK].load(std::memory_order_acquire);
+	return (nullptr != frame && frame->mFrameIndex == frameIndex) ? frame : nullptr;
+}
+
+void AudioBuffer::detachFrames(int firstFrameIndex, int endFrameIndex, std::vector<AudioFrame*>& outFrames)
+{
+	outFrames.clear();
+	for (int frameIndex = firstFrameIndex; frameIndex < endFrameIndex; ++frameIndex)
 	{
-		const AudioFrame* frame = mFrames[frameIndex];
+		FrameBlock* block = mFrameBlocks[getBlockIndex(frameIndex)].load(std::memory_order_relaxed);
+		if (nullptr == block)
+			continue;
+
+		AudioFrame* frame = block->mFrames[frameIndex % FRAMES_PER_BLOCK].exchange(nullptr);
 		if (nullptr != frame)
-		{
-			const int localPosition = position % MAX_FRAME_LENGTH;
-			if (localPosition < frame->mLength)
-			{
-				output[0] = &frame->mData[0][localPosition];
-				output[1] = &frame->mData[1][localPosition];
-				return frame->mLength - localPosition;
-			}
-		}
+			outFrames.push_back(frame);
 	}
-	return 0;
 }
 
-void AudioBuffer::lock()
+void AudioBuffer::deleteDetachedFrames(std::vector<AudioFrame*>& frames)
 {
-	// Note: An SDL mutex can be locked multiple times by the same thread with no problems
-	mMutex.lock();
-	++mMutexLockCounter;
-}
+	// The consumer might have looked up one of the frames before they got detached, so wait until it's done reading
+	//  -> Together with the sequentially consistent accesses in "getData", this makes sure the consumer can't access the frames any more afterwards
+	//  -> The consumer's reading is short (one audio mixer pass), so there's no need for anything better than just yielding
+	while (mReading.load())
+	{
+		std::this_thread::yield();
+	}
 
-void AudioBuffer::unlock()
-{
-	--mMutexLockCounter;
-	mMutex.unlock();
+	for (AudioFrame* frame : frames)
+		delete frame;
+	mNumFrames.fetch_sub((int)frames.size(), std::memory_order_relaxed);
+	frames.clear();
 }
 
 void AudioBuffer::clearInternal()
 {
 	// Clear all frames
-	for (int i = 0; i < (int)mFrames.size(); ++i)
-		delete mFrames[i];
-	mFrames.clear();
-	mPurgedFrames = 0;
-	mLength = 0;
+	const int numFrames = (int)((mLength.load(std::memory_order_relaxed) + MAX_FRAME_LENGTH - 1) / MAX_FRAME_LENGTH);
+	mLength.store(0);
+
+	std::vector<AudioFrame*> frames;
+	detachFrames(mPurgedFrames.load(std::memory_order_relaxed), numFrames, frames);
+	deleteDetachedFrames(frames);
+	mPurgedFrames.store(0, std::memory_order_relaxed);
 }
 
-AudioBuffer::AudioFrame& AudioBuffer::getWorkingFrame()
+AudioBuffer::AudioFrame* AudioBuffer::getWorkingFrame()
 {
-	AudioFrame* workingFrame = mFrames.empty() ? nullptr : mFrames[mFrames.size()-1];
-	if (nullptr == workingFrame || workingFrame->mLength >= MAX_FRAME_LENGTH)
+	const int64 length = mLength.load(std::memory_order_relaxed);
+	const int frameIndex = (int)(length / MAX_FRAME_LENGTH);
+	if (length % MAX_FRAME_LENGTH != 0)
 	{
-		workingFrame = new AudioFrame(mChannels);
-		mFrames.push_back(workingFrame);
+		// Working frame is not full yet
+		return getFrame(frameIndex);
 	}
-	return *workingFrame;
+
+	// Start a new frame, and possibly a new frame block
+	//  -> Its slot in the ring must not be in use by a frame that was not purged yet
+	RMX_CHECK(frameIndex - mPurgedFrames.load(std::memory_order_acquire) < MAX_FRAME_BLOCKS * FRAMES_PER_BLOCK, "Reached maximum length of audio buffer '" << mName << "'", return nullptr);
+	std::atomic<FrameBlock*>& blockPointer = mFrameBlocks[getBlockIndex(frameIndex)];
+	FrameBlock* block = blockPointer.load(std::memory_order_relaxed);
+	if (nullptr == block)
+	{
+		block = new FrameBlock();
+		blockPointer.store(block, std::memory_order_release);
+	}
+
+	AudioFrame* workingFrame = new AudioFrame(mChannels, frameIndex);
+	block->mFrames[frameIndex % FRAMES_PER_BLOCK].store(workingFrame, std::memory_order_release);
+	mNumFrames.fetch_add(1, std::memory_order_relaxed);
+	return workingFrame;
 }
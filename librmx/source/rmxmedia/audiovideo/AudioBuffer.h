@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <atomic>
+
 
 class API_EXPORT AudioBuffer
 {
@@ -23,19 +25,20 @@ public:
 	AudioBuffer();
 	~AudioBuffer();
 
+	// Must not be called while another thread is adding data
 	void clear(int frequency = 44100, int channels = 2);
 
 	void addData(short** data, int length, int frequency = 0, int channels = 0);
 	void addData(float** data, int length, int frequency = 0, int channels = 0);
 
-	void markPurgeableSamples(int purgePosition);
+	void markPurgeableSamples(int64 purgePosition);
 
 	bool load(const String& source, const String& params = String());
 
 	inline int getFrequency() const { return mFrequency; }
 	inline int getChannels() const  { return mChannels; }
 
-	inline int getLength() const	{ return mLength; }
+	inline int64 getLength() const	{ return mLength.load(std::memory_order_acquire); }
 	float getLengthInSec() const;
 
 	size_t getMemoryUsage() const;
@@ -46,42 +49,60 @@ public:
 	inline bool isCompleted() const  { return mCompleted; }
 	void setCompleted(bool completed = true);
 
-	int getData(short** output, int position) const;
+	int getData(short** output, int64 position) const;
 
-	void lock();
-	void unlock();
+	// Data is added by one producer thread and read by one consumer thread (the audio mixer) without any locking
+	//  -> The consumer has to wrap all of its "getData" calls in these, so that "clear" knows when it's safe to delete data
+	inline void beginReading()  { mReading.store(true); }
+	inline void endReading()	{ mReading.store(false); }
 
 	void setName(std::string_view name)  { mName = name; }
 
 private:
 	static const constexpr int MAX_FRAME_LENGTH = 4096;		// Maximum length of an audio frame in samples -- this is the length of all audio frames, except the last
+	static const constexpr int FRAMES_PER_BLOCK = 256;		// Number of audio frames in one frame block
+	static const constexpr int MAX_FRAME_BLOCKS = 512;		// Number of frame blocks in the ring, this allows for keeping around 3 hours of audio at 48 kHz at the same time
 
 	struct AudioFrame
 	{
 		short* mBuffer = nullptr;				// Holds all audio data
 		short* mData[2] = { nullptr, nullptr };	// Pointers into the buffer, one for each channel
-		int mLength = 0;						// Length in samples
+		const int mFrameIndex;					// Index of this frame, needed to tell it apart from other frames using the same slot
 
-		explicit AudioFrame(int channels);
+		AudioFrame(int channels, int frameIndex);
 		~AudioFrame();
 	};
 
+	// Frames are referenced from fixed blocks that never get moved in memory, so the consumer can access them while the producer adds new ones
+	//  -> The blocks form a ring indexed by frame index modulo the ring size; slots of purged frames get reused for later frames
+	struct FrameBlock
+	{
+		std::atomic<AudioFrame*> mFrames[FRAMES_PER_BLOCK] = { };
+	};
+
 private:
+	inline static int getBlockIndex(int frameIndex)  { return (frameIndex / FRAMES_PER_BLOCK) % MAX_FRAME_BLOCKS; }
+
+	AudioFrame* getFrame(int frameIndex) const;
+	void detachFrames(int firstFrameIndex, int endFrameIndex, std::vector<AudioFrame*>& outFrames);
+	void deleteDetachedFrames(std::vector<AudioFrame*>& frames);
 	void clearInternal();
-	AudioFrame& getWorkingFrame();
+	AudioFrame* getWorkingFrame();
 
 private:
-	std::vector<AudioFrame*> mFrames;	// Array of audio frames
-	int mPurgedFrames = 0;
-	int mLength = 0;					// In samples
+	std::atomic<FrameBlock*> mFrameBlocks[MAX_FRAME_BLOCKS] = { };
+	std::atomic<int> mNumFrames = 0;		// Number of frames currently allocated
+	std::atomic<int> mPurgedFrames = 0;		// Index of the first frame not purged yet
+	std::vector<AudioFrame*> mFramesToPurge;	// Only used inside "markPurgeableSamples", kept as a member to reuse its memory
+	std::atomic<int64> mLength = 0;			// In samples; the producer only publishes samples by updating this after writing them
+											//  -> This is a 64-bit value, as streaming for long enough (about 12 hours at 48 kHz) would overflow an int
 
-	int mChannels = 2;					// 1 for Mono, 2 for Stereo
-	int mFrequency = 44100;				// Sampling frequency, e.g. 44100 Hz
-	bool mPersistent = true;			// If false, played audio frames get deleted (e.g. for music streams)
-	bool mCompleted = false;			// Set to true when loading / streaming is completed
+	std::atomic<int> mChannels = 2;			// 1 for Mono, 2 for Stereo
+	std::atomic<int> mFrequency = 44100;	// Sampling frequency, e.g. 44100 Hz
+	bool mPersistent = true;				// If false, played audio frames get deleted (e.g. for music streams)
+	std::atomic<bool> mCompleted = false;	// Set to true when loading / streaming is completed
 
-	std::string mName;					// Internal name for debugging
+	std::string mName;						// Internal name for debugging
 
-	rmx::Mutex mMutex;
-	int mMutexLockCounter = 0;
+	std::atomic<bool> mReading = false;		// Set by the consumer while it's accessing audio data
 };
@@ -88,9 +88,37 @@ namespace rmx
 		playAudio(true);
 	}
 
+	void AudioManager::initializeWithoutDevice(int sample_freq, int channels, int audioBufferSamples)
+	{
+		// Reset instances
+		mInstances.clear();
+		mRootMixer.clearAudioInstances();
+
+		// Define format, just like with an actual audio device
+		mFormat.freq = sample_freq;
+		mFormat.format = AUDIO_S16LSB;
+		mFormat.channels = clamp(channels, 1, 2);
+		mFormat.samples = audioBufferSamples;
+		mFormat.callback = nullptr;
+		mFormat.userdata = 0;
+
+		mAudioDeviceID = 0;
+		mPlayedSamples = 0;
+	}
+
 	void AudioManager::exit()
 	{
-		SDL_CloseAudioDevice(mAudioDeviceID);
+		if (mAudioDeviceID != 0)
+		{
+			SDL_CloseAudioDevice(mAudioDeviceID);
+			mAudioDeviceID = 0;
+		}
+	}
+
+	void AudioManager::mixAudioWithoutDevice(uint8* outputStream, int outputBytes)
+	{
+		RMX_ASSERT(mAudioDeviceID == 0, "Audio must not be mixed manually while an audio device is open");
+		mixAudio(outputStream, outputBytes);
 	}
 
 	void AudioManager::clear()
@@ -148,7 +176,7 @@ namespace rmx
 			lockAudio();
 
 			// Collect non-persistent audio buffers currently played back, and the earliest playback positions
-			static std::vector<std::pair<AudioBuffer*, int>> audioBufferPurgePositions;
+			static std::vector<std::pair<AudioBuffer*, int64>> audioBufferPurgePositions;
 			audioBufferPurgePositions.clear();
 			for (const auto& instancePair : mInstances)
 			{
@@ -180,9 +208,7 @@ namespace rmx
 			for (auto& bufferPair : audioBufferPurgePositions)
 			{
 				AudioBuffer* audioBuffer = bufferPair.first;
-				audioBuffer->lock();
 				audioBuffer->markPurgeableSamples(bufferPair.second);
-				audioBuffer->unlock();
 			}
 
 			unlockAudio();
@@ -237,7 +263,7 @@ namespace rmx
 		instance.mVolume = playbackOptions.mVolume;
 		instance.mVolumeChange = playbackOptions.mVolumeChange;
 		instance.mSpeed = playbackOptions.mSpeed;
-		instance.mPosition = roundToInt(playbackOptions.mPosition * (float)playbackOptions.mAudioBuffer->getFrequency());
+		instance.mPosition = (int64)std::round((double)playbackOptions.mPosition * playbackOptions.mAudioBuffer->getFrequency());
 		instance.mLoop = playbackOptions.mLoop;
 		instance.mStreaming = playbackOptions.mStreaming;
 		instance.mPaused = playbackOptions.mStartPaused;
@@ -406,6 +432,7 @@ namespace rmx
 		parameters.mOutputSamples = outputSamples;
 		parameters.mOutputFormat = &mFormat;
 		parameters.mAccumulatedVolume = 1.0f;
+		parameters.mResamplingQuality = mResamplingQuality;
 		mRootMixer.performAudioMix(parameters);
 
 		// Copy results into the output stream
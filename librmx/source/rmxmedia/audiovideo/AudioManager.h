@@ -23,12 +23,20 @@ namespace rmx
 	class API_EXPORT AudioManager
 	{
 	public:
+		enum class ResamplingQuality
+		{
+			NEAREST	  = 0,		// Nearest input sample, fastest but with audible artifacts at non-native playback speeds
+			POLYPHASE = 1		// Polyphase windowed-sinc filter
+		};
+
 		struct AudioInstance
 		{
+			static const constexpr int RESAMPLER_HISTORY_LENGTH = 8;
+
 			int mID = 0;							// Unique audio instance ID, invalid if 0
 			AudioBuffer* mAudioBuffer = nullptr;	// The audio buffer used as a source, must not be a nullptr
 			AudioMixer* mAudioMixer = nullptr;		// Audio mixer this is played in
-			int mPosition = 0;						// Position in the audio buffer, in samples
+			int64 mPosition = 0;					// Position in the audio buffer, in samples
 			int mTimeout = 0;						// Time until playback gets stopped in samples, or 0 if not used
 			int mLoopStart = 0;						// If looping is enabled, jump back to this sample position
 			float mVolume = 1.0f;					// Volume in range [0.0f, 1.0f]
@@ -39,6 +47,7 @@ namespace rmx
 			bool mPaused = false;					// Set when sound playback is paused
 			bool mStreaming = false;				// Set if reaching the end of the audio buffer should not stop the playback, just temporily pause it until more data comes in
 			bool mPlaybackDone = false;				// Gets set by audio mixer when playback should stop now
+			short mResamplerHistory[2][RESAMPLER_HISTORY_LENGTH] = { { 0 } };	// Input samples before the current position, used by the audio mixer's polyphase resampler
 		};
 
 		struct PlaybackOptions
@@ -59,8 +68,12 @@ namespace rmx
 		~AudioManager();
 
 		void initialize(int sample_freq = 44100, int channels = 2, int audioBufferSamples = 1024);
+		void initializeWithoutDevice(int sample_freq = 44100, int channels = 2, int audioBufferSamples = 1024);	// No SDL audio device, output must be pulled with "mixAudioWithoutDevice"
 		void exit();
 
+		inline bool hasAudioDevice() const  { return (mAudioDeviceID != 0); }
+		void mixAudioWithoutDevice(uint8* outputStream, int outputBytes);
+
 		void clear();
 
 		void playAudio(bool onoff);
@@ -73,6 +86,9 @@ namespace rmx
 
 		void setGlobalVolume(float volume);
 
+		inline ResamplingQuality getResamplingQuality() const  { return mResamplingQuality; }
+		inline void setResamplingQuality(ResamplingQuality quality)  { mResamplingQuality = quality; }
+
 		template<typename T>
 		T& createAudioMixer(std::string_view name, int mixerId, int parentMixerId = 0)
 		{
@@ -122,6 +138,7 @@ namespace rmx
 		int mNextFreeID = 1;						// ID to use for next audio instance created
 		int mChangeCounter = 0;						// Changed whenever an audio instance gets created or invalidated
 		uint32 mPlayedSamples = 0;					// Number of samples played (this takes about one day to overflow at 48 kHz)
+		ResamplingQuality mResamplingQuality = ResamplingQuality::NEAREST;
 
 		float mTimeSinceLastUpdate = 0.0f;
 
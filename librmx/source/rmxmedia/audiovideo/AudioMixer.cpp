@@ -8,19 +8,206 @@
 
 #include "rmxmedia.h"
 
+#if !defined(PLATFORM_WEB) && (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define AUDIO_MIXER_SSE2
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define AUDIO_MIXER_NEON
+	#include <arm_neon.h>
+#endif
+
 
 namespace rmx
 {
 
 	namespace
 	{
+		// Polyphase windowed-sinc filter for resampling
+		//  -> Each output sample is the weighted sum of FILTER_TAPS input samples, with weights depending on its fractional position between input samples
+		//  -> Only input samples up to the current position are used, which delays the output by a few samples
+		static const constexpr int FILTER_TAPS = 8;		// The SIMD code relies on this being exactly 8
+		static const constexpr int FILTER_PHASE_BITS = 6;
+		static const constexpr int FILTER_PHASES = (1 << FILTER_PHASE_BITS);
+		static const constexpr int FILTER_PRECISION = 14;
+		static_assert(FILTER_TAPS - 1 <= AudioManager::AudioInstance::RESAMPLER_HISTORY_LENGTH, "Audio instance's resampler history is too short");
+
+		struct PolyphaseFilter
+		{
+			alignas(16) int16 mCoefficients[FILTER_PHASES][FILTER_TAPS];
+
+			void build(double cutoff)
+			{
+				for (int phase = 0; phase < FILTER_PHASES; ++phase)
+				{
+					const double fraction = (double)phase / (double)FILTER_PHASES;
+					double weights[FILTER_TAPS];
+					double sum = 0.0;
+					for (int tap = 0; tap < FILTER_TAPS; ++tap)
+					{
+						// Distance between the tap's input sample and the output sample, in input samples
+						const double x = (double)(tap - (FILTER_TAPS / 2 - 1)) - fraction;
+						const double sinc = (x == 0.0) ? 1.0 : std::sin(PI_DOUBLE * cutoff * x) / (PI_DOUBLE * cutoff * x);
+
+						// Blackman window, reaching zero at the outermost taps' maximum distance
+						const double w = x / (double)(FILTER_TAPS / 2);
+						const double window = 0.42 + 0.5 * std::cos(PI_DOUBLE * w) + 0.08 * std::cos(2.0 * PI_DOUBLE * w);
+
+						weights[tap] = sinc * window;
+						sum += weights[tap];
+					}
+
+					// Normalize each phase to unity gain, and make sure rounding does not change that
+					int total = 0;
+					int largestTap = 0;
+					for (int tap = 0; tap < FILTER_TAPS; ++tap)
+					{
+						const int coefficient = roundToInt(weights[tap] / sum * (double)(1 << FILTER_PRECISION));
+						mCoefficients[phase][tap] = (int16)coefficient;
+						total += coefficient;
+						if (std::abs(coefficient) > std::abs(mCoefficients[phase][largestTap]))
+							largestTap = tap;
+					}
+					mCoefficients[phase][largestTap] += (int16)((1 << FILTER_PRECISION) - total);
+				}
+			}
+
+			FORCE_INLINE const int16* getCoefficients(int sourceIndex) const
+			{
+				return mCoefficients[(sourceIndex >> (16 - FILTER_PHASE_BITS)) & (FILTER_PHASES - 1)];
+			}
+		};
+
+		const PolyphaseFilter& getPolyphaseFilter(int sourceIndexAdvance)
+		{
+			// Playback faster than the output frequency needs a lower cutoff frequency against aliasing
+			static const std::vector<PolyphaseFilter> filters = []()
+			{
+				std::vector<PolyphaseFilter> result(3);
+				result[0].build(0.9);
+				result[1].build(0.9 / 1.5);
+				result[2].build(0.9 / 2.0);
+				return result;
+			}();
+			return filters[(sourceIndexAdvance <= 0x10000) ? 0 : (sourceIndexAdvance <= 0x18000) ? 1 : 2];
+		}
+
+		enum class PolyphaseSignal
+		{
+			MONO,		// Mono input
+			STEREO,		// Stereo input, each channel goes into its own output channel
+			AVERAGE		// Stereo input, channels get mixed together
+		};
+
+		int getNumRampSamples(int numSamples, int volume, int volumeChange)
+		{
+			// Volume must not leave the range from 0 to 0x10000 during a volume change
+			if (volume + volumeChange * numSamples < 0)
+				return -volume / volumeChange;
+			if (volume + volumeChange * numSamples > 0x10000)
+				return (0x10000 - volume) / volumeChange;
+			return numSamples;
+		}
+
+	#if defined(AUDIO_MIXER_SSE2)
+		FORCE_INLINE __m128i gatherSamples(const short* input, int& j, int sourceIndexAdvance)
+		{
+			// Playback at the output frequency reads consecutive input samples
+			if (sourceIndexAdvance == 0x10000)
+			{
+				const __m128i samples = _mm_loadu_si128((const __m128i*)&input[j >> 16]);
+				j += 0x80000;
+				return samples;
+			}
+
+			__m128i samples = _mm_cvtsi32_si128(input[j >> 16]);
+			samples = _mm_insert_epi16(samples, input[(j + sourceIndexAdvance) >> 16], 1);
+			samples = _mm_insert_epi16(samples, input[(j + sourceIndexAdvance * 2) >> 16], 2);
+			samples = _mm_insert_epi16(samples, input[(j + sourceIndexAdvance * 3) >> 16], 3);
+			samples = _mm_insert_epi16(samples, input[(j + sourceIndexAdvance * 4) >> 16], 4);
+			samples = _mm_insert_epi16(samples, input[(j + sourceIndexAdvance * 5) >> 16], 5);
+			samples = _mm_insert_epi16(samples, input[(j + sourceIndexAdvance * 6) >> 16], 6);
+			samples = _mm_insert_epi16(samples, input[(j + sourceIndexAdvance * 7) >> 16], 7);
+			j += sourceIndexAdvance * 8;
+			return samples;
+		}
+
+		FORCE_INLINE void accumulateProducts(int32* output, __m128i samples, __m128i volumes)
+		{
+			// Full 32-bit products are put together from the low and high halves of 16-bit multiplications
+			const __m128i productsLow = _mm_mullo_epi16(samples, volumes);
+			const __m128i productsHigh = _mm_mulhi_epi16(samples, volumes);
+			__m128i* out = (__m128i*)output;
+			_mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), _mm_unpacklo_epi16(productsLow, productsHigh)));
+			_mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), _mm_unpackhi_epi16(productsLow, productsHigh)));
+		}
+	#elif defined(AUDIO_MIXER_NEON)
+		FORCE_INLINE int16x8_t gatherSamples(const short* input, int& j, int sourceIndexAdvance)
+		{
+			// Playback at the output frequency reads consecutive input samples
+			if (sourceIndexAdvance == 0x10000)
+			{
+				const int16x8_t samples = vld1q_s16(&input[j >> 16]);
+				j += 0x80000;
+				return samples;
+			}
+
+			int16x8_t samples = vdupq_n_s16(input[j >> 16]);
+			samples = vsetq_lane_s16(input[(j + sourceIndexAdvance) >> 16], samples, 1);
+			samples = vsetq_lane_s16(input[(j + sourceIndexAdvance * 2) >> 16], samples, 2);
+			samples = vsetq_lane_s16(input[(j + sourceIndexAdvance * 3) >> 16], samples, 3);
+			samples = vsetq_lane_s16(input[(j + sourceIndexAdvance * 4) >> 16], samples, 4);
+			samples = vsetq_lane_s16(input[(j + sourceIndexAdvance * 5) >> 16], samples, 5);
+			samples = vsetq_lane_s16(input[(j + sourceIndexAdvance * 6) >> 16], samples, 6);
+			samples = vsetq_lane_s16(input[(j + sourceIndexAdvance * 7) >> 16], samples, 7);
+			j += sourceIndexAdvance * 8;
+			return samples;
+		}
+
+		FORCE_INLINE void accumulateProducts(int32* output, int16x8_t samples, int16x4_t volumes)
+		{
+			vst1q_s32(&output[0], vmlal_s16(vld1q_s32(&output[0]), vget_low_s16(samples), volumes));
+			vst1q_s32(&output[4], vmlal_s16(vld1q_s32(&output[4]), vget_high_s16(samples), volumes));
+		}
+	#endif
+
+		FORCE_INLINE int32 filterSample(const short* samples, const int16* coefficients)
+		{
+		#if defined(AUDIO_MIXER_NEON)
+			const int16x8_t samplesVector = vld1q_s16(samples);
+			const int16x8_t coefficientsVector = vld1q_s16(coefficients);
+			int32x4_t products = vmull_s16(vget_low_s16(samplesVector), vget_low_s16(coefficientsVector));
+			products = vmlal_s16(products, vget_high_s16(samplesVector), vget_high_s16(coefficientsVector));
+			const int32x2_t pairs = vadd_s32(vget_low_s32(products), vget_high_s32(products));
+			return vget_lane_s32(vpadd_s32(pairs, pairs), 0);
+		#else
+			int32 sum = 0;
+			for (int tap = 0; tap < FILTER_TAPS; ++tap)
+				sum += samples[tap] * coefficients[tap];
+			return sum;
+		#endif
+		}
+
 		void mixInSamples(int32* output, const short* input, int numSamples, int sourceIndexStart, int sourceIndexAdvance, int volume, int volumeChange)
 		{
 			int j = sourceIndexStart;
 			if (volumeChange == 0)
 			{
 				volume >>= 8;
-				for (int i = 0; i < numSamples; ++i)
+				int i = 0;
+			#if defined(AUDIO_MIXER_SSE2)
+				const __m128i volumes = _mm_set1_epi16((int16)volume);
+				for (; i + 8 <= numSamples; i += 8)
+				{
+					accumulateProducts(&output[i], gatherSamples(input, j, sourceIndexAdvance), volumes);
+				}
+			#elif defined(AUDIO_MIXER_NEON)
+				const int16x4_t volumes = vdup_n_s16((int16)volume);
+				for (; i + 8 <= numSamples; i += 8)
+				{
+					accumulateProducts(&output[i], gatherSamples(input, j, sourceIndexAdvance), volumes);
+				}
+			#endif
+				for (; i < numSamples; ++i)
 				{
 					output[i] += input[j >> 16] * volume;
 					j += sourceIndexAdvance;
@@ -28,15 +215,7 @@ namespace rmx
 			}
 			else
 			{
-				if (volume + volumeChange * numSamples < 0)
-				{
-					numSamples = -volume / volumeChange;
-				}
-				else if (volume + volumeChange * numSamples > 0x10000)
-				{
-					numSamples = (0x10000 - volume) / volumeChange;
-				}
-
+				numSamples = getNumRampSamples(numSamples, volume, volumeChange);
 				for (int i = 0; i < numSamples; ++i)
 				{
 					output[i] += (input[j >> 16] * volume) >> 8;
@@ -54,7 +233,22 @@ namespace rmx
 			if (volumeChange == 0)
 			{
 				volume >>= 8;
-				for (int i = 0; i < numSamples; ++i)
+				int i = 0;
+			#if defined(AUDIO_MIXER_SSE2) || defined(AUDIO_MIXER_NEON)
+				// Both inputs get multiplied with the same volume, so they can be accumulated one after the other
+			#if defined(AUDIO_MIXER_SSE2)
+				const __m128i volumes = _mm_set1_epi16((int16)volume);
+			#else
+				const int16x4_t volumes = vdup_n_s16((int16)volume);
+			#endif
+				for (; i + 8 <= numSamples; i += 8)
+				{
+					int j0 = j;
+					accumulateProducts(&output[i], gatherSamples(input0, j0, sourceIndexAdvance), volumes);
+					accumulateProducts(&output[i], gatherSamples(input1, j, sourceIndexAdvance), volumes);
+				}
+			#endif
+				for (; i < numSamples; ++i)
 				{
 					const int k = j >> 16;
 					output[i] += (input0[k] + input1[k]) * volume;
@@ -63,15 +257,7 @@ namespace rmx
 			}
 			else
 			{
-				if (volume + volumeChange * numSamples < 0)
-				{
-					numSamples = -volume / volumeChange;
-				}
-				else if (volume + volumeChange * numSamples > 0x10000)
-				{
-					numSamples = (0x10000 - volume) / volumeChange;
-				}
-
+				numSamples = getNumRampSamples(numSamples, volume, volumeChange);
 				for (int i = 0; i < numSamples; ++i)
 				{
 					const int k = j >> 16;
@@ -81,6 +267,114 @@ namespace rmx
 				}
 			}
 		}
+
+		// Resamples the input with the polyphase filter and mixes it into one or two output channels, all in a single pass
+		//  -> Input has to start (FILTER_TAPS - 1) samples before the actual start position
+		template<PolyphaseSignal SIGNAL>
+		void mixInPolyphase(int32* const* output, int numOutputs, const short* const* input, int numSamples, int sourceIndexStart, int sourceIndexAdvance, const PolyphaseFilter& filter, const int* volume, const int* volumeChange)
+		{
+			constexpr int NUM_INPUTS = (SIGNAL == PolyphaseSignal::MONO) ? 1 : 2;
+			constexpr int SHIFT = FILTER_PRECISION + ((SIGNAL == PolyphaseSignal::AVERAGE) ? 1 : 0);	// Averaging is done by summing up the filter results of both inputs
+			int j = sourceIndexStart;
+			int i = 0;
+		#if defined(AUDIO_MIXER_SSE2)
+			if (volumeChange[0] == 0 && volumeChange[numOutputs - 1] == 0)
+			{
+				// Four output samples at once, with the first output channel's samples in the lower and the second's in the upper half of a vector
+				const __m128i rounding = _mm_set1_epi32(1 << (SHIFT - 1));
+				const int16 volume0 = (int16)(volume[0] >> 8);
+				const int16 volume1 = (int16)(volume[numOutputs - 1] >> 8);
+				const __m128i volumes = _mm_set_epi16(volume1, volume1, volume1, volume1, volume0, volume0, volume0, volume0);
+				for (; i + 4 <= numSamples; i += 4)
+				{
+					__m128i products[NUM_INPUTS][4];
+					for (int k = 0; k < 4; ++k)
+					{
+						const __m128i coefficients = _mm_load_si128((const __m128i*)filter.getCoefficients(j));
+						for (int c = 0; c < NUM_INPUTS; ++c)
+							products[c][k] = _mm_madd_epi16(_mm_loadu_si128((const __m128i*)&input[c][j >> 16]), coefficients);
+						j += sourceIndexAdvance;
+					}
+
+					// Averaged inputs need only one horizontal sum
+					constexpr int NUM_SUMS = (SIGNAL == PolyphaseSignal::STEREO) ? 2 : 1;
+					if (SIGNAL == PolyphaseSignal::AVERAGE)
+					{
+						for (int k = 0; k < 4; ++k)
+							products[0][k] = _mm_add_epi32(products[0][k], products[NUM_INPUTS - 1][k]);
+					}
+
+					__m128i sums[NUM_SUMS];
+					for (int c = 0; c < NUM_SUMS; ++c)
+					{
+						const __m128i sums01 = _mm_add_epi32(_mm_unpacklo_epi32(products[c][0], products[c][1]), _mm_unpackhi_epi32(products[c][0], products[c][1]));
+						const __m128i sums23 = _mm_add_epi32(_mm_unpacklo_epi32(products[c][2], products[c][3]), _mm_unpackhi_epi32(products[c][2], products[c][3]));
+						sums[c] = _mm_add_epi32(_mm_unpacklo_epi64(sums01, sums23), _mm_unpackhi_epi64(sums01, sums23));
+					}
+
+					const __m128i samples0 = _mm_srai_epi32(_mm_add_epi32(sums[0], rounding), SHIFT);
+					const __m128i samples1 = (SIGNAL == PolyphaseSignal::STEREO) ? _mm_srai_epi32(_mm_add_epi32(sums[NUM_SUMS - 1], rounding), SHIFT) : samples0;
+					const __m128i samples = _mm_packs_epi32(samples0, samples1);
+					const __m128i productsLow = _mm_mullo_epi16(samples, volumes);
+					const __m128i productsHigh = _mm_mulhi_epi16(samples, volumes);
+
+					__m128i* out = (__m128i*)&output[0][i];
+					_mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), _mm_unpacklo_epi16(productsLow, productsHigh)));
+					if (numOutputs == 2)
+					{
+						out = (__m128i*)&output[1][i];
+						_mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), _mm_unpackhi_epi16(productsLow, productsHigh)));
+					}
+				}
+			}
+		#endif
+
+			// Remaining samples, and everything with a volume change
+			int currentVolume[2] = { volume[0], volume[numOutputs - 1] };
+			int numRampSamples[2] = { numSamples, numSamples };
+			for (int c = 0; c < numOutputs; ++c)
+			{
+				if (volumeChange[c] != 0)
+					numRampSamples[c] = getNumRampSamples(numSamples, volume[c], volumeChange[c]);
+			}
+
+			for (; i < numSamples; ++i)
+			{
+				const int16* coefficients = filter.getCoefficients(j);
+				int32 sums[NUM_INPUTS];
+				for (int c = 0; c < NUM_INPUTS; ++c)
+					sums[c] = filterSample(&input[c][j >> 16], coefficients);
+				if (SIGNAL == PolyphaseSignal::AVERAGE)
+					sums[0] += sums[NUM_INPUTS - 1];
+
+				int samples[2];
+				samples[0] = clamp((sums[0] + (1 << (SHIFT - 1))) >> SHIFT, -0x8000, 0x7fff);
+				samples[1] = (SIGNAL == PolyphaseSignal::STEREO) ? clamp((sums[NUM_INPUTS - 1] + (1 << (SHIFT - 1))) >> SHIFT, -0x8000, 0x7fff) : samples[0];
+				for (int c = 0; c < numOutputs; ++c)
+				{
+					if (volumeChange[c] == 0)
+					{
+						output[c][i] += samples[c] * (volume[c] >> 8);
+					}
+					else if (i < numRampSamples[c])
+					{
+						output[c][i] += (samples[c] * currentVolume[c]) >> 8;
+						currentVolume[c] += volumeChange[c];
+					}
+				}
+				j += sourceIndexAdvance;
+			}
+		}
+
+		void mixInPolyphase(PolyphaseSignal signal, int32* const* output, int numOutputs, const short* const* input, int numSamples, int sourceIndexStart, int sourceIndexAdvance, const PolyphaseFilter& filter, const int* volume, const int* volumeChange)
+		{
+			switch (signal)
+			{
+				case PolyphaseSignal::MONO:	   mixInPolyphase<PolyphaseSignal::MONO>(output, numOutputs, input, numSamples, sourceIndexStart, sourceIndexAdvance, filter, volume, volumeChange);  break;
+				case PolyphaseSignal::STEREO:  mixInPolyphase<PolyphaseSignal::STEREO>(output, numOutputs, input, numSamples, sourceIndexStart, sourceIndexAdvance, filter, volume, volumeChange);  break;
+				case PolyphaseSignal::AVERAGE: mixInPolyphase<PolyphaseSignal::AVERAGE>(output, numOutputs, input, numSamples, sourceIndexStart, sourceIndexAdvance, filter, volume, volumeChange);  break;
+			}
+		}
 	}
 
 
@@ -164,11 +458,11 @@ namespace rmx
 	{
 		for (const auto& [key, audioInstance] : mAudioInstances)
 		{
-			mixInAudioInstance(*audioInstance, parameters.mOutputBuffers, parameters.mOutputSamples, *parameters.mOutputFormat);
+			mixInAudioInstance(*audioInstance, parameters.mOutputBuffers, parameters.mOutputSamples, *parameters.mOutputFormat, parameters.mResamplingQuality);
 		}
 	}
 
-	void AudioMixer::mixInAudioInstance(AudioManager::AudioInstance& audioInstance, int32*const* outputBuffer, size_t numOutputSamplesNeeded, const SDL_AudioSpec& outputFormat)
+	void AudioMixer::mixInAudioInstance(AudioManager::AudioInstance& audioInstance, int32*const* outputBuffer, size_t numOutputSamplesNeeded, const SDL_AudioSpec& outputFormat, AudioManager::ResamplingQuality resamplingQuality)
 	{
 		// Mix in audio data into the output stream
 		if (audioInstance.mPaused)
@@ -202,9 +496,9 @@ namespace rmx
 		}
 
 		// Perform the actual audio mixing
-		audioBuffer.lock();
-		const bool result = mixAudioBufferInner(audioInstance, output, numOutputSamplesNeeded, outputFormat, sourceIndexAdvance);
-		audioBuffer.unlock();
+		audioBuffer.beginReading();
+		const bool result = mixAudioBufferInner(audioInstance, output, numOutputSamplesNeeded, outputFormat, sourceIndexAdvance, resamplingQuality);
+		audioBuffer.endReading();
 
 		if (!result)
 		{
@@ -212,7 +506,7 @@ namespace rmx
 		}
 	}
 
-	bool AudioMixer::mixAudioBufferInner(AudioManager::AudioInstance& audioInstance, int32** output, size_t numOutputSamplesNeeded, const SDL_AudioSpec& outputFormat, int sourceIndexAdvance)
+	bool AudioMixer::mixAudioBufferInner(AudioManager::AudioInstance& audioInstance, int32** output, size_t numOutputSamplesNeeded, const SDL_AudioSpec& outputFormat, int sourceIndexAdvance, AudioManager::ResamplingQuality resamplingQuality)
 	{
 		AudioBuffer& audioBuffer = *audioInstance.mAudioBuffer;
 
@@ -297,36 +591,79 @@ namespace rmx
 				}
 			}
 
-			// Mix in audio samples
-			if (outputFormat.channels == 1)
+			if (resamplingQuality == AudioManager::ResamplingQuality::POLYPHASE)
 			{
-				// Output as Mono
-				if (instanceChannels == 1)
+				// Stereo input gets mixed together for mono output, and when there's panning
+				const PolyphaseSignal signal = (instanceChannels == 1) ? PolyphaseSignal::MONO : (outputFormat.channels == 2 && audioInstance.mPanning == 0.0f) ? PolyphaseSignal::STEREO : PolyphaseSignal::AVERAGE;
+				const PolyphaseFilter& filter = getPolyphaseFilter(sourceIndexAdvance);
+
+				// The filter needs the input samples before the block as well, these are taken from the instance's history
+				//  -> Only the first output samples need these, so they read from a copy of the history followed by the first input samples
+				//  -> All others read directly from the input
+				short stagedInput[2][(FILTER_TAPS - 1) * 2];
+				const short* stagedInputPointers[2] = { stagedInput[0], stagedInput[1] };
+				const int numStagedInputSamples = std::min(numAvailableInputSamples, FILTER_TAPS - 1);
+				for (int c = 0; c < instanceChannels; ++c)
 				{
-					mixInSamples(output[0], instanceData[0], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
+					memcpy(stagedInput[c], audioInstance.mResamplerHistory[c], (FILTER_TAPS - 1) * sizeof(short));
+					memcpy(&stagedInput[c][FILTER_TAPS - 1], instanceData[c], numStagedInputSamples * sizeof(short));
 				}
-				else
+
+				const int numStagedSamples = std::min(numBlockSamples, (((FILTER_TAPS - 1) << 16) - sourceSamplePositionFraction + sourceIndexAdvance - 1) / sourceIndexAdvance);
+				mixInPolyphase(signal, output, outputFormat.channels, stagedInputPointers, numStagedSamples, sourceSamplePositionFraction, sourceIndexAdvance, filter, volume, volumeChange);
+				if (numStagedSamples < numBlockSamples)
+				{
+					int32* directOutput[2] = { output[0] + numStagedSamples, output[1] + numStagedSamples };
+					const int directVolume[2] = { volume[0] + volumeChange[0] * numStagedSamples, volume[1] + volumeChange[1] * numStagedSamples };
+					const int sourceIndexStart = sourceSamplePositionFraction + sourceIndexAdvance * numStagedSamples - ((FILTER_TAPS - 1) << 16);
+					mixInPolyphase(signal, directOutput, outputFormat.channels, instanceData, numBlockSamples - numStagedSamples, sourceIndexStart, sourceIndexAdvance, filter, directVolume, volumeChange);
+				}
+
+				// Update history with the samples before the next block's start position
+				//  -> If that position is beyond the available input, just repeat the last sample
+				const int consumedInputSamples = (sourceSamplePositionFraction + sourceIndexAdvance * numBlockSamples) >> 16;
+				for (int c = 0; c < instanceChannels; ++c)
 				{
-					mixInSampleAverages(output[0], instanceData[0], instanceData[1], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
+					for (int k = 0; k < FILTER_TAPS - 1; ++k)
+					{
+						const int index = std::min(consumedInputSamples + k, FILTER_TAPS - 1 + numAvailableInputSamples - 1);
+						audioInstance.mResamplerHistory[c][k] = (index < FILTER_TAPS - 1 + numStagedInputSamples) ? stagedInput[c][index] : instanceData[c][index - (FILTER_TAPS - 1)];
+					}
 				}
 			}
 			else
 			{
-				// Output as Stereo
-				if (instanceChannels == 1)
-				{
-					mixInSamples(output[0], instanceData[0], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
-					mixInSamples(output[1], instanceData[0], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[1], volumeChange[1]);
-				}
-				else if (audioInstance.mPanning != 0.0f)
+				// Mix in audio samples
+				if (outputFormat.channels == 1)
 				{
-					mixInSampleAverages(output[0], instanceData[0], instanceData[1], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
-					mixInSampleAverages(output[1], instanceData[0], instanceData[1], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[1], volumeChange[1]);
+					// Output as Mono
+					if (instanceChannels == 1)
+					{
+						mixInSamples(output[0], instanceData[0], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
+					}
+					else
+					{
+						mixInSampleAverages(output[0], instanceData[0], instanceData[1], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
+					}
 				}
 				else
 				{
-					mixInSamples(output[0], instanceData[0], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
-					mixInSamples(output[1], instanceData[1], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[1], volumeChange[1]);
+					// Output as Stereo
+					if (instanceChannels == 1)
+					{
+						mixInSamples(output[0], instanceData[0], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
+						mixInSamples(output[1], instanceData[0], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[1], volumeChange[1]);
+					}
+					else if (audioInstance.mPanning != 0.0f)
+					{
+						mixInSampleAverages(output[0], instanceData[0], instanceData[1], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
+						mixInSampleAverages(output[1], instanceData[0], instanceData[1], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[1], volumeChange[1]);
+					}
+					else
+					{
+						mixInSamples(output[0], instanceData[0], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[0], volumeChange[0]);
+						mixInSamples(output[1], instanceData[1], numBlockSamples, sourceSamplePositionFraction, sourceIndexAdvance, volume[1], volumeChange[1]);
+					}
 				}
 			}
 
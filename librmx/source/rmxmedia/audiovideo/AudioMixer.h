@@ -28,6 +28,7 @@ namespace rmx
 			size_t mOutputSamples = 0;
 			const SDL_AudioSpec* mOutputFormat = nullptr;
 			float mAccumulatedVolume = 1.0f;
+			AudioManager::ResamplingQuality mResamplingQuality = AudioManager::ResamplingQuality::NEAREST;
 		};
 
 	public:
@@ -50,7 +51,7 @@ namespace rmx
 		void updateOutputVolume(const MixerParameters& parameters);
 		void mixInAllChildren(const MixerParameters& parameters);
 		void mixInAllAudioInstances(const MixerParameters& parameters);
-		void mixInAudioInstance(AudioManager::AudioInstance& audioInstance, int32*const* outputBuffer, size_t numOutputSamplesNeeded, const SDL_AudioSpec& outputFormat);
+		void mixInAudioInstance(AudioManager::AudioInstance& audioInstance, int32*const* outputBuffer, size_t numOutputSamplesNeeded, const SDL_AudioSpec& outputFormat, AudioManager::ResamplingQuality resamplingQuality);
 
 	protected:
 		float mRelativeVolume = 1.0f;
@@ -58,7 +59,7 @@ namespace rmx
 		std::map<int, AudioManager::AudioInstance*> mAudioInstances;
 
 	private:
-		bool mixAudioBufferInner(AudioManager::AudioInstance& audioInstance, int32** output, size_t numOutputSamplesNeeded, const SDL_AudioSpec& outputFormat, int sourceIndexAdvance);
+		bool mixAudioBufferInner(AudioManager::AudioInstance& audioInstance, int32** output, size_t numOutputSamplesNeeded, const SDL_AudioSpec& outputFormat, int sourceIndexAdvance, AudioManager::ResamplingQuality resamplingQuality);
 		void removeChildInternal(AudioMixer& child);
 
 	private:
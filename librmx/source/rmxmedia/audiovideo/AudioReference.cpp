@@ -25,7 +25,7 @@ bool AudioReference::isValid()
 float AudioReference::getPosition()
 {
 	if (isValid())
-		return (float)mInstance->mPosition / (float)mInstance->mAudioBuffer->getFrequency();
+		return (float)((double)mInstance->mPosition / (double)mInstance->mAudioBuffer->getFrequency());
 	return 0.0f;
 }
 
@@ -80,7 +80,7 @@ void AudioReference::stop()
 void AudioReference::setPosition(float position)
 {
 	if (isValid())
-		mInstance->mPosition = (int)(position * mInstance->mAudioBuffer->getFrequency());
+		mInstance->mPosition = (int64)((double)position * mInstance->mAudioBuffer->getFrequency());
 }
 
 void AudioReference::setLoopStartInSamples(int loopStart)